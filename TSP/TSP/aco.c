@@ -0,0 +1,306 @@
+/**
+	@file aco.c
+	@author Cristina Fabris
+	@author Raffaele Di Nardo Di Maio
+	@brief MAX-MIN Ant System (ants built in parallel on the thread pool).
+*/
+
+#include "aco.h"
+
+void ant_colony(tsp_instance* tsp_in, int* visited_nodes, double* best_cost, double deadline, rng_state* rng)
+{
+	deadline_timer timer;
+	timer_start(&timer, deadline);
+
+	int n = tsp_in->num_nodes;
+
+	#ifndef MULTI_START
+	printf("%sStarting cost:%s %.2lf     %sAnts:%s %d\n", RED, WHITE, *best_cost, RED, WHITE, ACO_NUM_ANTS);
+	#endif
+
+	candidate_list cand;
+	build_candidate_list(tsp_in, &cand, ACO_CANDIDATES);
+
+	aco_colony colony;
+	colony.tsp_in = tsp_in;
+	colony.cand = &cand;
+	colony.pheromone = (float*)calloc((size_t)(n * cand.k), sizeof(float));
+	colony.heuristic = (float*)calloc((size_t)(n * cand.k), sizeof(float));
+	colony.weights = (float*)calloc((size_t)(n * cand.k), sizeof(float));
+	colony.num_ants = ACO_NUM_ANTS;
+	colony.tours = (int**)calloc((size_t)colony.num_ants, sizeof(int*));
+	colony.costs = (double*)calloc((size_t)colony.num_ants, sizeof(double));
+
+	int i;
+	for (i = 0; i < colony.num_ants; i++)
+		colony.tours[i] = (int*)calloc((size_t)n, sizeof(int));
+
+	for (i = 0; i < n * cand.k; i++)
+		colony.heuristic[i] = (float)pow(1.0 / ((cand.costs[i] > EPS) ? cand.costs[i] : EPS), ACO_BETA);
+
+	aco_set_bounds(&colony, *best_cost);
+	aco_reset(&colony);
+
+	//each worker builds a contiguous range of ants with its own stream of a seed drawn from the generator of the thread
+	thread_pool pool;
+	pool_init(&pool, tsp_in->num_threads);
+
+	int num_workers = (tsp_in->num_threads < colony.num_ants) ? tsp_in->num_threads : colony.num_ants;
+	aco_worker_args* args = (aco_worker_args*)calloc((size_t)num_workers, sizeof(aco_worker_args));
+	uint64_t seed = rng_next(rng);
+
+	for (i = 0; i < num_workers; i++)
+	{
+		args[i].colony = &colony;
+		args[i].first_ant = (colony.num_ants * i) / num_workers;
+		args[i].last_ant = (colony.num_ants * (i + 1)) / num_workers;
+		args[i].visited = (int*)calloc((size_t)n, sizeof(int));
+		rng_stream(&(args[i].rng), seed, (uint64_t)(i + 1));
+	}
+
+	//local search without penalties, applied only to the best tour of each iteration
+	gls_search search;
+	gls_search_init(&search, tsp_in, &cand);
+
+	progress_source source;
+	progress_source_init(&source);
+	long long num_iterations = 0;
+	int no_improvement = 0;
+	int num_restarts = 0;
+
+	while (time_left(&timer) > 0)
+	{
+		for (i = 0; i < num_workers; i++)
+			pool_submit(&pool, aco_worker, (void*)&args[i]);
+
+		pool_wait(&pool);
+
+		int best_ant = 0;
+		for (i = 1; i < colony.num_ants; i++)
+		{
+			if (colony.costs[i] < colony.costs[best_ant])
+				best_ant = i;
+		}
+
+		gls_search_load(&search, colony.tours[best_ant], colony.costs[best_ant]);
+		gls_local_search(&search, &timer);
+		double cost = tour_cost(tsp_in, search.tour);
+		num_iterations++;
+
+		if (cost < *best_cost - EPS)
+		{
+			*best_cost = cost;
+			memcpy(visited_nodes, search.tour, n * sizeof(int));
+			aco_set_bounds(&colony, cost);
+			no_improvement = 0;
+		}
+		else
+			no_improvement++;
+
+		if (no_improvement == ACO_RESTART)
+		{
+			aco_reset(&colony);
+			no_improvement = 0;
+			num_restarts++;
+		}
+		else if (num_iterations % ACO_BEST_PERIOD == 0)
+			aco_update(&colony, visited_nodes, *best_cost);
+		else
+			aco_update(&colony, search.tour, cost);
+
+		#ifndef MULTI_START
+		progress_post(&source, num_iterations, *best_cost, cost, time_left(&timer));
+		#endif
+	}
+
+	pool_destroy(&pool);
+
+	#ifndef MULTI_START
+	//the status line is closed before the statistics of the colony
+	progress_stop();
+	if (tsp_in->verbose > 50)
+		printf("%sIterations :%s %lld  %srestarts :%s %d  %stau :%s [%.3e, %.3e]\n", BLUE, WHITE, num_iterations,
+			BLUE, WHITE, num_restarts, BLUE, WHITE, colony.tau_min, colony.tau_max);
+	#endif
+
+	for (i = 0; i < num_workers; i++)
+		free(args[i].visited);
+
+	for (i = 0; i < colony.num_ants; i++)
+		free(colony.tours[i]);
+
+	gls_search_free(&search);
+	free(args);
+	free(colony.tours);
+	free(colony.costs);
+	free(colony.pheromone);
+	free(colony.heuristic);
+	free(colony.weights);
+	free_candidate_list(&cand);
+}
+
+void aco_worker(void* param)
+{
+	aco_worker_args* args = (aco_worker_args*)param;
+	aco_colony* colony = args->colony;
+
+	int i;
+	for (i = args->first_ant; i < args->last_ant; i++)
+		colony->costs[i] = aco_build_tour(colony, colony->tours[i], args->visited, &(args->rng));
+}
+
+double aco_build_tour(aco_colony* colony, int* tour, int* visited, rng_state* rng)
+{
+	tsp_instance* tsp_in = colony->tsp_in;
+	int n = tsp_in->num_nodes;
+	int k = colony->cand->k;
+	int* nodes = colony->cand->nodes;
+	float* weights = colony->weights;
+
+	int current = rng_int(rng, n);
+	tour[0] = current;
+	visited[current] = 1;
+	double cost = 0.0;
+
+	int i;
+	for (i = 1; i < n; i++)
+	{
+		double sum = 0.0;
+
+		int r;
+		for (r = 0; r < k; r++)
+		{
+			if (!visited[nodes[current * k + r]])
+				sum += weights[current * k + r];
+		}
+
+		int next = -1;
+
+		if (sum > 0.0)
+		{
+			//roulette wheel on the unvisited candidates (the last one if the rounding leaves a residual)
+			double x = rng_double(rng) * sum;
+
+			for (r = 0; r < k; r++)
+			{
+				int c = nodes[current * k + r];
+
+				if (visited[c])
+					continue;
+
+				next = c;
+				x -= weights[current * k + r];
+
+				if (x <= 0.0)
+					break;
+			}
+		}
+		else
+		{
+			double min_cost = DBL_MAX;
+
+			int j;
+			for (j = 0; j < n; j++)
+			{
+				if (visited[j])
+					continue;
+
+				double c = edge_cost(tsp_in, current, j);
+
+				if (c < min_cost)
+				{
+					min_cost = c;
+					next = j;
+				}
+			}
+		}
+
+		tour[i] = next;
+		visited[next] = 1;
+		cost += edge_cost(tsp_in, current, next);
+		current = next;
+	}
+
+	cost += edge_cost(tsp_in, current, tour[0]);
+
+	for (i = 0; i < n; i++)
+		visited[tour[i]] = 0;
+
+	return cost;
+}
+
+void aco_set_bounds(aco_colony* colony, double best_cost)
+{
+	int n = colony->tsp_in->num_nodes;
+	double p = pow(ACO_P_BEST, 1.0 / n);
+	double avg = colony->cand->k / 2.0;
+
+	colony->tau_max = (float)(1.0 / (ACO_RHO * best_cost));
+	colony->tau_min = (float)(colony->tau_max * (1.0 - p) / ((avg - 1.0) * p));
+
+	if (colony->tau_min > colony->tau_max)
+		colony->tau_min = colony->tau_max;
+}
+
+void aco_reset(aco_colony* colony)
+{
+	int size = colony->tsp_in->num_nodes * colony->cand->k;
+	float tau_max = colony->tau_max;
+	float* pheromone = colony->pheromone;
+	float* heuristic = colony->heuristic;
+	float* weights = colony->weights;
+
+	int i;
+	for (i = 0; i < size; i++)
+	{
+		pheromone[i] = tau_max;
+		weights[i] = tau_max * heuristic[i];
+	}
+}
+
+void aco_update(aco_colony* colony, int* tour, double cost)
+{
+	int n = colony->tsp_in->num_nodes;
+	int k = colony->cand->k;
+	int size = n * k;
+	int* nodes = colony->cand->nodes;
+	float* pheromone = colony->pheromone;
+	float* heuristic = colony->heuristic;
+	float* weights = colony->weights;
+	float tau_min = colony->tau_min;
+	float tau_max = colony->tau_max;
+	float evaporation = (float)(1.0 - ACO_RHO);
+	float deposit = (float)(1.0 / cost);
+
+	//contiguous loops without branches on float arrays, vectorized by the compiler
+	int i;
+	for (i = 0; i < size; i++)
+	{
+		float tau = pheromone[i] * evaporation;
+		pheromone[i] = (tau < tau_min) ? tau_min : tau;
+	}
+
+	//deposit on both the copies of each edge of the tour (in the candidates of the two endpoints)
+	for (i = 0; i < n; i++)
+	{
+		int u = tour[i];
+		int v = tour[(i + 1) % n];
+
+		int r;
+		for (r = 0; r < k; r++)
+		{
+			if (nodes[u * k + r] == v)
+				pheromone[u * k + r] += deposit;
+
+			if (nodes[v * k + r] == u)
+				pheromone[v * k + r] += deposit;
+		}
+	}
+
+	for (i = 0; i < size; i++)
+	{
+		float tau = (pheromone[i] > tau_max) ? tau_max : pheromone[i];
+		pheromone[i] = tau;
+		weights[i] = tau * heuristic[i];
+	}
+}
@@ -0,0 +1,95 @@
+/**
+	@file aco.h
+	@author Cristina Fabris
+	@author Raffaele Di Nardo Di Maio
+	@brief Header of the MAX-MIN Ant System (ants built in parallel on the thread pool).
+*/
+
+#ifndef ACO
+#define ACO
+
+#include "heuristic.h"
+#include "gls.h"
+
+#define ACO_NUM_ANTS 25 //Number of ants of each iteration
+#define ACO_CANDIDATES 20 //Number of candidates of each node (the only edges with pheromone)
+#define ACO_BETA 2.0 //Exponent of the heuristic information 1/cost (the exponent of the pheromone is 1)
+#define ACO_RHO 0.02 //Evaporation rate of the pheromone
+#define ACO_P_BEST 0.05 //Probability of building the best tour when the pheromone converges (gives the ratio tau_min / tau_max)
+#define ACO_BEST_PERIOD 10 //Every ACO_BEST_PERIOD iterations the best tour deposits the pheromone instead of the iteration best
+#define ACO_RESTART 250 //Iterations without improvement of the best tour before the pheromone is reset to tau_max
+
+typedef struct
+{
+	tsp_instance* tsp_in; //pointer to tsp instance
+	candidate_list* cand; //candidate lists of the nodes
+	float* pheromone; //pheromone of the edge between node i and its r-th candidate in position i*k + r (one copy for each endpoint)
+	float* heuristic; //(1/cost)^ACO_BETA of the same edges
+	float* weights; //pheromone * heuristic of the same edges, used by the ants to choose the next node
+	float tau_min; //lower bound of the pheromone
+	float tau_max; //upper bound of the pheromone
+	int num_ants; //number of ants of each iteration
+	int** tours; //tours built by the ants of the iteration
+	double* costs; //cost of the tours of the ants
+} aco_colony;
+
+typedef struct
+{
+	aco_colony* colony; //colony shared by the workers
+	int first_ant; //first ant built by the worker
+	int last_ant; //ant after the last one built by the worker
+	rng_state rng; //generator of the worker
+	int* visited; //1 if the node is visited by the ant being built
+} aco_worker_args;
+
+/**
+	@brief Compute the MAX-MIN Ant System: in each iteration the ants build their tours in parallel,
+	the best one is improved by a local search and deposits the pheromone.
+	@param tsp_in reference to tsp instance structure
+	@param visited_nodes array with sequence of the visited nodes, replaced by the best tour found
+	@param best_cost cost of the starting tour, replaced by the cost of the best tour found
+	@param deadline time limit of the algorithm (seconds)
+	@param rng generator of the thread
+*/
+void ant_colony(tsp_instance* tsp_in, int* visited_nodes, double* best_cost, double deadline, rng_state* rng);
+
+/**
+	@brief Build the tours of a range of ants (job of the thread pool).
+	@param param parameters of the worker (aco_worker_args)
+*/
+void aco_worker(void* param);
+
+/**
+	@brief Build the tour of an ant, choosing each next node among the unvisited candidates with probability
+	proportional to their weight (the nearest unvisited node if all the candidates are visited).
+	@param colony reference to the colony
+	@param tour on return, sequence of the visited nodes
+	@param visited array of num_nodes elements (all 0 at the start and at the end)
+	@param rng generator of the worker
+	@return cost of the tour
+*/
+double aco_build_tour(aco_colony* colony, int* tour, int* visited, rng_state* rng);
+
+/**
+	@brief Set the bounds of the pheromone from the cost of the best tour.
+	@param colony reference to the colony
+	@param best_cost cost of the best tour
+*/
+void aco_set_bounds(aco_colony* colony, double best_cost);
+
+/**
+	@brief Set the pheromone of all the candidate edges to tau_max.
+	@param colony reference to the colony
+*/
+void aco_reset(aco_colony* colony);
+
+/**
+	@brief Evaporate the pheromone of all the candidate edges and deposit it on the edges of a tour (bounded by tau_min and tau_max),
+	then update the weights of the edges.
+	@param colony reference to the colony
+	@param tour sequence of the visited nodes of the tour that deposits the pheromone
+	@param cost cost of the tour
+*/
+void aco_update(aco_colony* colony, int* tour, double cost);
+
+#endif
@@ -0,0 +1,473 @@
+/**
+	@file alns.c
+	@author Cristina Fabris
+	@author Raffaele Di Nardo Di Maio
+	@brief Adaptive Large Neighborhood Search (destroy and repair operators chosen by adaptive weights).
+*/
+
+#include "alns.h"
+
+void alns(tsp_instance* tsp_in, int* visited_nodes, double* best_cost, double deadline, rng_state* rng)
+{
+	deadline_timer timer;
+	timer_start(&timer, deadline);
+
+	int n = tsp_in->num_nodes;
+
+	#ifndef MULTI_START
+	printf("%sStarting cost:%s %.2lf\n", RED, WHITE, *best_cost);
+	#endif
+
+	candidate_list cand;
+	build_candidate_list(tsp_in, &cand, NUM_CANDIDATES);
+
+	alns_state state;
+	state.tsp_in = tsp_in;
+	state.cand = &cand;
+	state.succ = (int*)calloc((size_t)n, sizeof(int));
+	state.pred = (int*)calloc((size_t)n, sizeof(int));
+	state.is_removed = (int*)calloc((size_t)n, sizeof(int));
+	state.cost = *best_cost;
+	state.removed = (int*)calloc((size_t)ALNS_MAX_REMOVED, sizeof(int));
+	state.num_removed = 0;
+	state.best_node = (int*)calloc((size_t)ALNS_MAX_REMOVED, sizeof(int));
+	state.best_delta = (double*)calloc((size_t)ALNS_MAX_REMOVED, sizeof(double));
+	state.second_node = (int*)calloc((size_t)ALNS_MAX_REMOVED, sizeof(int));
+	state.second_delta = (double*)calloc((size_t)ALNS_MAX_REMOVED, sizeof(double));
+
+	//each removal changes two links and each insertion four links
+	state.log_node = (int*)calloc((size_t)(6 * ALNS_MAX_REMOVED), sizeof(int));
+	state.log_value = (int*)calloc((size_t)(6 * ALNS_MAX_REMOVED), sizeof(int));
+	state.log_is_succ = (int*)calloc((size_t)(6 * ALNS_MAX_REMOVED), sizeof(int));
+	state.log_size = 0;
+
+	state.destroy[0] = alns_destroy_random;
+	state.destroy[1] = alns_destroy_worst;
+	state.destroy[2] = alns_destroy_cluster;
+	state.repair[0] = alns_repair_cheapest;
+	state.repair[1] = alns_repair_regret;
+
+	int i;
+	for (i = 0; i < ALNS_NUM_DESTROY; i++)
+	{
+		state.destroy_weights[i] = 1.0;
+		state.destroy_scores[i] = 0.0;
+		state.destroy_uses[i] = 0;
+	}
+
+	for (i = 0; i < ALNS_NUM_REPAIR; i++)
+	{
+		state.repair_weights[i] = 1.0;
+		state.repair_scores[i] = 0.0;
+		state.repair_uses[i] = 0;
+	}
+
+	for (i = 0; i < n; i++)
+	{
+		state.succ[visited_nodes[i]] = visited_nodes[(i + 1) % n];
+		state.pred[visited_nodes[(i + 1) % n]] = visited_nodes[i];
+	}
+
+	//at most a quarter of the nodes is removed
+	int max_removed = (n / 4 < ALNS_MAX_REMOVED) ? n / 4 : ALNS_MAX_REMOVED;
+	int min_removed = (max_removed < ALNS_MIN_REMOVED) ? max_removed : ALNS_MIN_REMOVED;
+
+	progress_source source;
+	progress_source_init(&source);
+	long long num_iterations = 0;
+	long long num_accepted = 0;
+	double remaining_time = time_left(&timer);
+
+	while (remaining_time > 0 && max_removed > 0)
+	{
+		int d = alns_select(state.destroy_weights, ALNS_NUM_DESTROY, rng);
+		int r = alns_select(state.repair_weights, ALNS_NUM_REPAIR, rng);
+		int num_nodes = min_removed + rng_int(rng, max_removed - min_removed + 1);
+		double current_cost = state.cost;
+
+		state.log_size = 0;
+		state.destroy[d](&state, num_nodes, rng);
+		state.repair[r](&state);
+
+		num_iterations++;
+		state.destroy_uses[d]++;
+		state.repair_uses[r]++;
+
+		//record to record travel, with a deviation that goes to zero at the deadline
+		double score = 0.0;
+		double threshold = *best_cost * (1.0 + ALNS_DEVIATION * remaining_time / deadline);
+
+		if (state.cost < *best_cost - EPS)
+		{
+			//the cost is updated incrementally by the operators, so it is recomputed from the tour before being stored
+			int node = 0;
+			for (i = 0; i < n; i++, node = state.succ[node])
+				visited_nodes[i] = node;
+
+			state.cost = tour_cost(tsp_in, visited_nodes);
+			*best_cost = state.cost;
+			score = ALNS_SCORE_BEST;
+			num_accepted++;
+		}
+		else if (state.cost < current_cost - EPS)
+		{
+			score = ALNS_SCORE_BETTER;
+			num_accepted++;
+		}
+		else if (state.cost < threshold && state.cost > current_cost + EPS)
+		{
+			score = ALNS_SCORE_ACCEPTED;
+			num_accepted++;
+		}
+		else if (state.cost > current_cost + EPS)
+		{
+			alns_undo(&state);
+			state.cost = current_cost;
+		}
+
+		state.destroy_scores[d] += score;
+		state.repair_scores[r] += score;
+
+		if (num_iterations % ALNS_SEGMENT == 0)
+		{
+			alns_update_weights(state.destroy_weights, state.destroy_scores, state.destroy_uses, ALNS_NUM_DESTROY);
+			alns_update_weights(state.repair_weights, state.repair_scores, state.repair_uses, ALNS_NUM_REPAIR);
+		}
+
+		remaining_time = time_left(&timer);
+
+		#ifndef MULTI_START
+		progress_post(&source, num_iterations, *best_cost, state.cost, remaining_time);
+		#endif
+	}
+
+	#ifndef MULTI_START
+	//the status line is closed before the statistics of the search
+	progress_stop();
+	if (tsp_in->verbose > 50)
+	{
+		printf("%sIterations :%s %lld  %saccepted :%s %lld\n", BLUE, WHITE, num_iterations, BLUE, WHITE, num_accepted);
+		printf("%sDestroy weights :%s random %.2lf  worst %.2lf  cluster %.2lf  %sRepair weights :%s cheapest %.2lf  regret %.2lf\n",
+			BLUE, WHITE, state.destroy_weights[0], state.destroy_weights[1], state.destroy_weights[2],
+			BLUE, WHITE, state.repair_weights[0], state.repair_weights[1]);
+	}
+	#endif
+
+	free(state.succ);
+	free(state.pred);
+	free(state.is_removed);
+	free(state.removed);
+	free(state.best_node);
+	free(state.best_delta);
+	free(state.second_node);
+	free(state.second_delta);
+	free(state.log_node);
+	free(state.log_value);
+	free(state.log_is_succ);
+	free_candidate_list(&cand);
+}
+
+void alns_destroy_random(alns_state* state, int num_nodes, rng_state* rng)
+{
+	int n = state->tsp_in->num_nodes;
+
+	while (state->num_removed < num_nodes)
+	{
+		int node = rng_int(rng, n);
+
+		if (!state->is_removed[node])
+			alns_remove(state, node);
+	}
+}
+
+void alns_destroy_worst(alns_state* state, int num_nodes, rng_state* rng)
+{
+	tsp_instance* tsp_in = state->tsp_in;
+	int n = tsp_in->num_nodes;
+	int num_samples = ALNS_WORST_SAMPLES * num_nodes;
+
+	if (num_samples > n)
+		num_samples = n;
+
+	int* samples = (int*)calloc((size_t)num_samples, sizeof(int));
+	double* savings = (double*)calloc((size_t)num_samples, sizeof(double));
+
+	//saving of the removal of each sampled node, kept sorted by decreasing saving (insertion sort of a small sample)
+	int i;
+	for (i = 0; i < num_samples; i++)
+	{
+		int node = rng_int(rng, n);
+		double saving = edge_cost(tsp_in, state->pred[node], node) + edge_cost(tsp_in, node, state->succ[node])
+			- edge_cost(tsp_in, state->pred[node], state->succ[node]);
+
+		int j = i;
+		for (; j > 0 && savings[j - 1] < saving; j--)
+		{
+			samples[j] = samples[j - 1];
+			savings[j] = savings[j - 1];
+		}
+
+		samples[j] = node;
+		savings[j] = saving;
+	}
+
+	for (i = 0; i < num_samples && state->num_removed < num_nodes; i++)
+	{
+		if (!state->is_removed[samples[i]])
+			alns_remove(state, samples[i]);
+	}
+
+	free(samples);
+	free(savings);
+
+	//duplicated samples are replaced by random nodes
+	alns_destroy_random(state, num_nodes, rng);
+}
+
+void alns_destroy_cluster(alns_state* state, int num_nodes, rng_state* rng)
+{
+	candidate_list* cand = state->cand;
+	int n = state->tsp_in->num_nodes;
+
+	//the removed nodes are visited in order of removal, and the candidates of each one are removed in turn
+	int next = state->num_removed;
+
+	while (state->num_removed < num_nodes)
+	{
+		if (next == state->num_removed)
+		{
+			int seed = rng_int(rng, n);
+
+			if (!state->is_removed[seed])
+				alns_remove(state, seed);
+
+			continue;
+		}
+
+		int node = state->removed[next++];
+
+		int r;
+		for (r = 0; r < cand->k && state->num_removed < num_nodes; r++)
+		{
+			int c = cand->nodes[node * cand->k + r];
+
+			if (!state->is_removed[c])
+				alns_remove(state, c);
+		}
+	}
+}
+
+void alns_repair_cheapest(alns_state* state)
+{
+	alns_insert_all(state, 0);
+}
+
+void alns_repair_regret(alns_state* state)
+{
+	alns_insert_all(state, 1);
+}
+
+void alns_insert_all(alns_state* state, int regret)
+{
+	int i;
+	for (i = 0; i < state->num_removed; i++)
+		alns_evaluate(state, i);
+
+	while (state->num_removed > 0)
+	{
+		int chosen = 0;
+
+		for (i = 1; i < state->num_removed; i++)
+		{
+			if (regret)
+			{
+				double regret_i = state->second_delta[i] - state->best_delta[i];
+				double regret_chosen = state->second_delta[chosen] - state->best_delta[chosen];
+
+				if (regret_i > regret_chosen || (regret_i == regret_chosen && state->best_delta[i] < state->best_delta[chosen]))
+					chosen = i;
+			}
+			else if (state->best_delta[i] < state->best_delta[chosen])
+				chosen = i;
+		}
+
+		int node = state->removed[chosen];
+		int u = state->best_node[chosen];
+
+		alns_insert(state, chosen, u);
+
+		//only the insertions in the edge (u,v) are not valid anymore, the new edges (u,node) (node,v) are new positions
+		for (i = 0; i < state->num_removed; i++)
+		{
+			if (state->best_node[i] == u || state->second_node[i] == u)
+				alns_evaluate(state, i);
+			else
+			{
+				alns_evaluate_edge(state, i, u);
+				alns_evaluate_edge(state, i, node);
+			}
+		}
+	}
+}
+
+void alns_evaluate(alns_state* state, int index)
+{
+	candidate_list* cand = state->cand;
+	int h = state->removed[index];
+
+	state->best_node[index] = -1;
+	state->best_delta[index] = DBL_MAX;
+	state->second_node[index] = -1;
+	state->second_delta[index] = DBL_MAX;
+
+	//edges entering and leaving each candidate in the tour
+	int r;
+	for (r = 0; r < cand->k; r++)
+	{
+		int c = cand->nodes[h * cand->k + r];
+
+		if (state->is_removed[c])
+			continue;
+
+		alns_evaluate_edge(state, index, c);
+		alns_evaluate_edge(state, index, state->pred[c]);
+	}
+
+	if (state->best_node[index] != -1)
+		return;
+
+	//all the candidates are removed, so the whole tour is evaluated
+	int start = 0;
+	while (state->is_removed[start])
+		start++;
+
+	int node = start;
+	do
+	{
+		alns_evaluate_edge(state, index, node);
+		node = state->succ[node];
+	} while (node != start);
+}
+
+void alns_evaluate_edge(alns_state* state, int index, int node)
+{
+	int h = state->removed[index];
+	int next = state->succ[node];
+
+	//the same edge can be evaluated twice (from its two endpoints), and it is only one position
+	if (node == state->best_node[index] || node == state->second_node[index])
+		return;
+
+	double delta = extra_mileage(state->tsp_in, h, node, next, edge_cost(state->tsp_in, node, next));
+
+	if (delta < state->best_delta[index])
+	{
+		state->second_node[index] = state->best_node[index];
+		state->second_delta[index] = state->best_delta[index];
+		state->best_node[index] = node;
+		state->best_delta[index] = delta;
+	}
+	else if (delta < state->second_delta[index])
+	{
+		state->second_node[index] = node;
+		state->second_delta[index] = delta;
+	}
+}
+
+void alns_remove(alns_state* state, int node)
+{
+	tsp_instance* tsp_in = state->tsp_in;
+	int p = state->pred[node];
+	int s = state->succ[node];
+
+	state->cost -= extra_mileage(tsp_in, node, p, s, edge_cost(tsp_in, p, s));
+
+	alns_link(state, p, s, 1);
+	alns_link(state, s, p, 0);
+
+	state->is_removed[node] = 1;
+	state->removed[state->num_removed++] = node;
+}
+
+void alns_insert(alns_state* state, int index, int node)
+{
+	int h = state->removed[index];
+	int next = state->succ[node];
+
+	state->cost += state->best_delta[index];
+
+	alns_link(state, node, h, 1);
+	alns_link(state, h, node, 0);
+	alns_link(state, h, next, 1);
+	alns_link(state, next, h, 0);
+
+	state->is_removed[h] = 0;
+
+	//the last removed node takes the position of the inserted one
+	state->num_removed--;
+	state->removed[index] = state->removed[state->num_removed];
+	state->best_node[index] = state->best_node[state->num_removed];
+	state->best_delta[index] = state->best_delta[state->num_removed];
+	state->second_node[index] = state->second_node[state->num_removed];
+	state->second_delta[index] = state->second_delta[state->num_removed];
+}
+
+void alns_link(alns_state* state, int node, int value, int is_succ)
+{
+	int* links = (is_succ) ? state->succ : state->pred;
+
+	state->log_node[state->log_size] = node;
+	state->log_value[state->log_size] = links[node];
+	state->log_is_succ[state->log_size] = is_succ;
+	state->log_size++;
+
+	links[node] = value;
+}
+
+void alns_undo(alns_state* state)
+{
+	while (state->log_size > 0)
+	{
+		state->log_size--;
+
+		int* links = (state->log_is_succ[state->log_size]) ? state->succ : state->pred;
+		links[state->log_node[state->log_size]] = state->log_value[state->log_size];
+	}
+}
+
+int alns_select(double* weights, int num_operators, rng_state* rng)
+{
+	double sum = 0.0;
+
+	int i;
+	for (i = 0; i < num_operators; i++)
+		sum += weights[i];
+
+	double x = rng_double(rng) * sum;
+
+	for (i = 0; i < num_operators - 1; i++)
+	{
+		x -= weights[i];
+
+		if (x < 0.0)
+			return i;
+	}
+
+	return num_operators - 1;
+}
+
+void alns_update_weights(double* weights, double* scores, int* uses, int num_operators)
+{
+	int i;
+	for (i = 0; i < num_operators; i++)
+	{
+		if (uses[i] > 0)
+			weights[i] = (1.0 - ALNS_REACTION) * weights[i] + ALNS_REACTION * scores[i] / uses[i];
+
+		if (weights[i] < ALNS_MIN_WEIGHT)
+			weights[i] = ALNS_MIN_WEIGHT;
+
+		scores[i] = 0.0;
+		uses[i] = 0;
+	}
+}
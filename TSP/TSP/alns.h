@@ -0,0 +1,180 @@
+/**
+	@file alns.h
+	@author Cristina Fabris
+	@author Raffaele Di Nardo Di Maio
+	@brief Header of the Adaptive Large Neighborhood Search (destroy and repair operators chosen by adaptive weights).
+*/
+
+#ifndef ALNS
+#define ALNS
+
+#include "heuristic.h"
+
+#define ALNS_NUM_DESTROY 3 //Number of destroy operators (random, worst edge, spatial cluster)
+#define ALNS_NUM_REPAIR 2 //Number of repair operators (cheapest, regret insertion)
+#define ALNS_MIN_REMOVED 5 //Minimum number of nodes removed by a destroy operator
+#define ALNS_MAX_REMOVED 40 //Maximum number of nodes removed by a destroy operator (at most a quarter of the nodes)
+#define ALNS_WORST_SAMPLES 3 //The worst edge removal samples ALNS_WORST_SAMPLES * removed nodes and removes the most expensive ones
+#define ALNS_DEVIATION 0.03 //Accepted tours cost at most (1 + ALNS_DEVIATION * fraction of the deadline left) times the best one
+#define ALNS_SEGMENT 100 //Iterations between two updates of the weights of the operators
+#define ALNS_REACTION 0.1 //Weight of the scores of the last segment in the update of the weights
+#define ALNS_MIN_WEIGHT 0.1 //Minimum weight of an operator
+#define ALNS_SCORE_BEST 33.0 //Score of an operator that finds a new best tour
+#define ALNS_SCORE_BETTER 9.0 //Score of an operator that improves the current tour
+#define ALNS_SCORE_ACCEPTED 13.0 //Score of an operator that finds a worse tour that is accepted
+
+typedef struct alns_state alns_state;
+
+typedef void (*alns_destroy)(alns_state* state, int num_nodes, rng_state* rng); //remove num_nodes nodes from the tour
+typedef void (*alns_repair)(alns_state* state); //insert again all the removed nodes in the tour
+
+struct alns_state
+{
+	tsp_instance* tsp_in; //pointer to tsp instance
+	candidate_list* cand; //candidate lists of the nodes (the insertion positions next to the candidates are evaluated)
+	int* succ; //successor of each node in the current tour
+	int* pred; //predecessor of each node in the current tour
+	int* is_removed; //1 if the node is not in the tour
+	double cost; //cost of the current tour (of the partial tour during destroy and repair)
+	int* removed; //nodes removed by the destroy operator and not inserted yet
+	int num_removed; //number of nodes in removed
+	int* best_node; //for each removed node, the edge (best_node, succ[best_node]) of its cheapest insertion
+	double* best_delta; //for each removed node, the cost of its cheapest insertion
+	int* second_node; //for each removed node, the edge (second_node, succ[second_node]) of its second cheapest insertion
+	double* second_delta; //for each removed node, the cost of its second cheapest insertion (regret)
+	int* log_node; //undo log of the changes of succ and pred: changed node
+	int* log_value; //undo log: previous value
+	int* log_is_succ; //undo log: 1 if the change is in succ, 0 if it is in pred
+	int log_size; //number of changes in the undo log
+	alns_destroy destroy[ALNS_NUM_DESTROY]; //destroy operators
+	alns_repair repair[ALNS_NUM_REPAIR]; //repair operators
+	double destroy_weights[ALNS_NUM_DESTROY]; //weights of the destroy operators in the roulette wheel
+	double repair_weights[ALNS_NUM_REPAIR]; //weights of the repair operators in the roulette wheel
+	double destroy_scores[ALNS_NUM_DESTROY]; //scores of the destroy operators in the current segment
+	double repair_scores[ALNS_NUM_REPAIR]; //scores of the repair operators in the current segment
+	int destroy_uses[ALNS_NUM_DESTROY]; //uses of the destroy operators in the current segment
+	int repair_uses[ALNS_NUM_REPAIR]; //uses of the repair operators in the current segment
+};
+
+/**
+	@brief Compute the Adaptive Large Neighborhood Search: at each iteration a destroy and a repair operator, chosen with
+	probability proportional to their adaptive weights, rebuild part of the current tour, which is accepted with
+	a record to record criterion whose deviation goes to zero at the deadline.
+	@param tsp_in reference to tsp instance structure
+	@param visited_nodes array with sequence of the visited nodes, replaced by the best tour found
+	@param best_cost cost of the starting tour, replaced by the cost of the best tour found
+	@param deadline time limit of the algorithm (seconds)
+	@param rng generator of the thread
+*/
+void alns(tsp_instance* tsp_in, int* visited_nodes, double* best_cost, double deadline, rng_state* rng);
+
+/**
+	@brief Destroy operator: remove random nodes.
+	@param state reference to the state of the search
+	@param num_nodes number of nodes to remove
+	@param rng generator of the thread
+*/
+void alns_destroy_random(alns_state* state, int num_nodes, rng_state* rng);
+
+/**
+	@brief Destroy operator: remove the nodes with the most expensive edges (among a random sample of nodes).
+	@param state reference to the state of the search
+	@param num_nodes number of nodes to remove
+	@param rng generator of the thread
+*/
+void alns_destroy_worst(alns_state* state, int num_nodes, rng_state* rng);
+
+/**
+	@brief Destroy operator: remove a random node and the nodes close to it (visit of the candidate lists).
+	@param state reference to the state of the search
+	@param num_nodes number of nodes to remove
+	@param rng generator of the thread
+*/
+void alns_destroy_cluster(alns_state* state, int num_nodes, rng_state* rng);
+
+/**
+	@brief Repair operator: insert the removed node with the cheapest insertion until all the nodes are in the tour.
+	@param state reference to the state of the search
+*/
+void alns_repair_cheapest(alns_state* state);
+
+/**
+	@brief Repair operator: insert the removed node with the largest regret (difference between its second cheapest
+	and its cheapest insertion) until all the nodes are in the tour.
+	@param state reference to the state of the search
+*/
+void alns_repair_regret(alns_state* state);
+
+/**
+	@brief Insert the removed nodes, choosing each time the node with the minimum cheapest insertion or with the maximum regret.
+	The insertion costs are cached, so after an insertion only the nodes whose cheapest or second cheapest insertion edge is removed are evaluated again.
+	@param state reference to the state of the search
+	@param regret 1 for the regret insertion, 0 for the cheapest insertion
+*/
+void alns_insert_all(alns_state* state, int regret);
+
+/**
+	@brief Compute the cheapest and the second cheapest insertion of a removed node, in the edges of the tour next to its candidates
+	(in all the edges of the tour if none of its candidates is in the tour).
+	@param state reference to the state of the search
+	@param index position of the node in removed
+*/
+void alns_evaluate(alns_state* state, int index);
+
+/**
+	@brief Update the cheapest and the second cheapest insertion of a removed node with the insertion in the edge (node, succ[node]).
+	@param state reference to the state of the search
+	@param index position of the node in removed
+	@param node first node of the edge
+*/
+void alns_evaluate_edge(alns_state* state, int index, int node);
+
+/**
+	@brief Remove a node from the tour and append it to the removed nodes.
+	@param state reference to the state of the search
+	@param node node to remove
+*/
+void alns_remove(alns_state* state, int node);
+
+/**
+	@brief Insert a removed node in the edge (node, succ[node]) of the tour.
+	@param state reference to the state of the search
+	@param index position of the node in removed
+	@param node first node of the edge
+*/
+void alns_insert(alns_state* state, int index, int node);
+
+/**
+	@brief Change the successor or the predecessor of a node, recording the previous value in the undo log.
+	@param state reference to the state of the search
+	@param node node to change
+	@param value new successor or predecessor
+	@param is_succ 1 to change the successor, 0 to change the predecessor
+*/
+void alns_link(alns_state* state, int node, int value, int is_succ);
+
+/**
+	@brief Restore the tour before the last destroy and repair, undoing the changes in the log.
+	@param state reference to the state of the search
+*/
+void alns_undo(alns_state* state);
+
+/**
+	@brief Choose an operator with probability proportional to its weight.
+	@param weights weights of the operators
+	@param num_operators number of operators
+	@param rng generator of the thread
+	@return index of the chosen operator
+*/
+int alns_select(double* weights, int num_operators, rng_state* rng);
+
+/**
+	@brief Update the weights of the operators with their average score in the last segment and reset the scores.
+	@param weights weights of the operators
+	@param scores scores of the operators in the last segment
+	@param uses uses of the operators in the last segment
+	@param num_operators number of operators
+*/
+void alns_update_weights(double* weights, double* scores, int* uses, int num_operators);
+
+#endif
@@ -0,0 +1,191 @@
+/**
+	@file archive.c
+	@author Cristina Fabris
+	@author Raffaele Di Nardo Di Maio
+	@brief Archive of the tours: hashes of the seen tours and bounded set of diverse elite tours (thread safe).
+*/
+
+#include "archive.h"
+
+void archive_init(tour_archive* archive, int num_nodes, int capacity)
+{
+	archive->num_nodes = num_nodes;
+	archive->seen = (uint64_t*)calloc((size_t)ARCHIVE_SEEN_CAPACITY, sizeof(uint64_t));
+	archive->size = 0;
+	archive->capacity = capacity;
+	archive->tours = (int**)calloc((size_t)capacity + 1, sizeof(int*));
+	archive->costs = (double*)calloc((size_t)capacity + 1, sizeof(double));
+	archive->hashes = (uint64_t*)calloc((size_t)capacity + 1, sizeof(uint64_t));
+	archive->adj = (int*)calloc((size_t)(2 * num_nodes), sizeof(int));
+	pthread_mutex_init(&(archive->mutex), NULL);
+
+	int i;
+	for (i = 0; i < capacity; i++)
+		archive->tours[i] = (int*)calloc((size_t)num_nodes, sizeof(int));
+}
+
+void archive_free(tour_archive* archive)
+{
+	int i;
+	for (i = 0; i < archive->capacity; i++)
+		free(archive->tours[i]);
+
+	pthread_mutex_destroy(&(archive->mutex));
+	free(archive->seen);
+	free(archive->tours);
+	free(archive->costs);
+	free(archive->hashes);
+	free(archive->adj);
+}
+
+uint64_t tour_hash(int* visited_nodes, int num_nodes)
+{
+	uint64_t hash = 0;
+
+	int i;
+	for (i = 0; i < num_nodes; i++)
+		hash ^= edge_key(visited_nodes[i], visited_nodes[(i + 1) % num_nodes]);
+
+	//0 marks the empty slots of the table
+	return (hash != 0) ? hash : 1;
+}
+
+uint64_t edge_key(int i, int j)
+{
+	uint64_t z = (i < j) ? (((uint64_t)i << 32) | (uint64_t)j) : (((uint64_t)j << 32) | (uint64_t)i);
+
+	z = (z + 1) * 0x9E3779B97F4A7C15ULL;
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+
+	return z ^ (z >> 31);
+}
+
+int archive_seen(tour_archive* archive, uint64_t hash)
+{
+	int mask = ARCHIVE_SEEN_CAPACITY - 1;
+	int slot = (int)(hash & (uint64_t)mask);
+
+	pthread_mutex_lock(&(archive->mutex));
+
+	int i;
+	for (i = 0; i < ARCHIVE_MAX_PROBES; i++)
+	{
+		uint64_t current = archive->seen[(slot + i) & mask];
+
+		if (current == hash)
+		{
+			pthread_mutex_unlock(&(archive->mutex));
+			return 1;
+		}
+
+		if (current == 0)
+			break;
+	}
+
+	//the table is bounded: when all the probed slots are used, the oldest hash of the first slot is forgotten
+	archive->seen[(i < ARCHIVE_MAX_PROBES) ? (slot + i) & mask : slot] = hash;
+
+	pthread_mutex_unlock(&(archive->mutex));
+	return 0;
+}
+
+int archive_insert(tour_archive* archive, int* visited_nodes, double cost, uint64_t hash)
+{
+	int n = archive->num_nodes;
+
+	if (archive->capacity == 0)
+		return 0;
+
+	pthread_mutex_lock(&(archive->mutex));
+
+	int i;
+	for (i = 0; i < n; i++)
+	{
+		archive->adj[2 * visited_nodes[i]] = visited_nodes[(i + n - 1) % n];
+		archive->adj[2 * visited_nodes[i] + 1] = visited_nodes[(i + 1) % n];
+	}
+
+	int closest_index = -1;
+	int closest_distance = n + 1;
+	int worst_index = -1;
+
+	for (i = 0; i < archive->size; i++)
+	{
+		if (archive->hashes[i] == hash)
+		{
+			pthread_mutex_unlock(&(archive->mutex));
+			return 0;
+		}
+
+		int distance = archive_distance(archive, i);
+
+		if (distance < closest_distance)
+		{
+			closest_distance = distance;
+			closest_index = i;
+		}
+
+		if (worst_index == -1 || archive->costs[i] > archive->costs[worst_index])
+			worst_index = i;
+	}
+
+	//a tour too close to an elite tour can only replace it, so the elite tours stay spread
+	int index = -1;
+	if (closest_index >= 0 && closest_distance < ARCHIVE_MIN_DISTANCE * n)
+	{
+		if (cost < archive->costs[closest_index])
+			index = closest_index;
+	}
+	else if (archive->size < archive->capacity)
+		index = (archive->size)++;
+	else if (cost < archive->costs[worst_index])
+		index = worst_index;
+
+	if (index >= 0)
+	{
+		memcpy(archive->tours[index], visited_nodes, n * sizeof(int));
+		archive->costs[index] = cost;
+		archive->hashes[index] = hash;
+	}
+
+	pthread_mutex_unlock(&(archive->mutex));
+	return index >= 0;
+}
+
+int archive_pull(tour_archive* archive, int* visited_nodes, double* cost, rng_state* rng)
+{
+	pthread_mutex_lock(&(archive->mutex));
+
+	if (archive->size == 0)
+	{
+		pthread_mutex_unlock(&(archive->mutex));
+		return 0;
+	}
+
+	int index = rng_int(rng, archive->size);
+	memcpy(visited_nodes, archive->tours[index], archive->num_nodes * sizeof(int));
+	*cost = archive->costs[index];
+
+	pthread_mutex_unlock(&(archive->mutex));
+	return 1;
+}
+
+int archive_distance(tour_archive* archive, int index)
+{
+	int n = archive->num_nodes;
+	int* tour = archive->tours[index];
+	int distance = 0;
+
+	int i;
+	for (i = 0; i < n; i++)
+	{
+		int u = tour[i];
+		int v = tour[(i + 1) % n];
+
+		if (archive->adj[2 * u] != v && archive->adj[2 * u + 1] != v)
+			distance++;
+	}
+
+	return distance;
+}
@@ -0,0 +1,106 @@
+/**
+	@file archive.h
+	@author Cristina Fabris
+	@author Raffaele Di Nardo Di Maio
+	@brief Header of the archive of the tours: hashes of the seen tours and bounded set of diverse elite tours (thread safe).
+*/
+
+#ifndef ARCHIVE
+#define ARCHIVE
+
+#include <float.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "rng.h"
+
+#define HAVE_STRUCT_TIMESPEC
+#include <pthread.h>
+
+#define ARCHIVE_SEEN_CAPACITY 65536 //Slots of the table of the hashes of the seen tours (power of two)
+#define ARCHIVE_MAX_PROBES 8 //Slots probed for a hash; if all are used, the hash replaces the one in the first slot
+#define ARCHIVE_MIN_DISTANCE 0.02 //Two elite tours differ in at least ARCHIVE_MIN_DISTANCE * num_nodes edges
+
+typedef struct
+{
+	int num_nodes; //number of nodes of each tour
+	uint64_t* seen; //open addressing table of the hashes of the seen tours (0 if the slot is empty)
+	int** tours; //visited nodes sequence of each elite tour
+	double* costs; //cost of each elite tour
+	uint64_t* hashes; //hash of each elite tour
+	int size; //number of elite tours stored
+	int capacity; //max number of elite tours
+	int* adj; //neighbors of each node in the tour being inserted (2 x num_nodes)
+	pthread_mutex_t mutex;
+} tour_archive;
+
+/**
+	@brief Allocate an empty archive.
+	@param archive reference to the archive
+	@param num_nodes number of nodes of the tours
+	@param capacity max number of elite tours (0 if the archive only detects the seen tours)
+*/
+void archive_init(tour_archive* archive, int num_nodes, int capacity);
+
+/**
+	@brief Free the archive.
+	@param archive reference to the archive
+*/
+void archive_free(tour_archive* archive);
+
+/**
+	@brief Zobrist hash of a tour: xor of the random keys of its edges, so it does not depend on the first node
+	and on the direction of the tour. The key of an edge is computed from its endpoints, so no table of keys is stored.
+	@param visited_nodes sequence of the visited nodes
+	@param num_nodes number of nodes
+	@return hash of the tour (never 0)
+*/
+uint64_t tour_hash(int* visited_nodes, int num_nodes);
+
+/**
+	@brief Random key of an edge (splitmix64 of its endpoints in increasing order).
+	@param i first endpoint
+	@param j second endpoint
+	@return key of the edge
+*/
+uint64_t edge_key(int i, int j);
+
+/**
+	@brief Check if a tour was already seen, and mark it as seen (O(1)).
+	The table is bounded, so a tour seen long before can be forgotten.
+	@param archive reference to the archive
+	@param hash hash of the tour
+	@return 1 if the tour was already seen, 0 otherwise
+*/
+int archive_seen(tour_archive* archive, uint64_t hash);
+
+/**
+	@brief Insert a tour in the elite tours. A tour closer than ARCHIVE_MIN_DISTANCE to an elite tour replaces it only if it is better,
+	otherwise it replaces the worst elite tour if it is better (or fills a free slot).
+	@param archive reference to the archive
+	@param visited_nodes sequence of the visited nodes
+	@param cost cost of the tour
+	@param hash hash of the tour
+	@return 1 if the tour is inserted, 0 otherwise
+*/
+int archive_insert(tour_archive* archive, int* visited_nodes, double cost, uint64_t hash);
+
+/**
+	@brief Copy a random elite tour.
+	@param archive reference to the archive
+	@param visited_nodes on return, sequence of the visited nodes of the elite tour
+	@param cost on return, cost of the elite tour
+	@param rng generator of the thread
+	@return 1 if a tour is copied, 0 if there are no elite tours
+*/
+int archive_pull(tour_archive* archive, int* visited_nodes, double* cost, rng_state* rng);
+
+/**
+	@brief Number of edges of an elite tour that are not in the tour being inserted.
+	@param archive reference to the archive, with the neighbors of the tour being inserted in adj
+	@param index index of the elite tour
+	@return number of different edges
+*/
+int archive_distance(tour_archive* archive, int index);
+
+#endif
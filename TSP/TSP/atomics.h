@@ -0,0 +1,39 @@
+/**
+	@file atomics.h
+	@author Cristina Fabris
+	@author Raffaele Di Nardo Di Maio
+	@brief Minimal atomic operations on int shared between threads (MSVC intrinsics or GCC builtins).
+*/
+
+#ifndef ATOMICS
+#define ATOMICS
+
+#ifdef _MSC_VER
+
+//declared here since the project is compiled without language extensions (/Za) and so without <windows.h>
+long _InterlockedExchange(long volatile* target, long value);
+long _InterlockedExchangeAdd(long volatile* addend, long value);
+long _InterlockedCompareExchange(long volatile* destination, long exchange, long comparand);
+#pragma intrinsic(_InterlockedExchange)
+#pragma intrinsic(_InterlockedExchangeAdd)
+#pragma intrinsic(_InterlockedCompareExchange)
+
+//value of *p (acquire)
+#define ATOMIC_LOAD(p) ((int)_InterlockedCompareExchange((long volatile*)(p), 0, 0))
+//*p = v (release)
+#define ATOMIC_STORE(p, v) ((void)_InterlockedExchange((long volatile*)(p), (long)(v)))
+//*p += v, returning the previous value of *p
+#define ATOMIC_ADD(p, v) ((int)_InterlockedExchangeAdd((long volatile*)(p), (long)(v)))
+//if *p == expected then *p = desired; 1 if the exchange is done, 0 otherwise
+#define ATOMIC_CAS(p, expected, desired) (_InterlockedCompareExchange((long volatile*)(p), (long)(desired), (long)(expected)) == (long)(expected))
+
+#else
+
+#define ATOMIC_LOAD(p) __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define ATOMIC_STORE(p, v) __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+#define ATOMIC_ADD(p, v) __atomic_fetch_add((p), (v), __ATOMIC_ACQ_REL)
+#define ATOMIC_CAS(p, expected, desired) __sync_bool_compare_and_swap((p), (expected), (desired))
+
+#endif
+
+#endif
@@ -89,8 +89,8 @@ void bc_solver(CPXENVptr env, CPXLPptr lp, tsp_instance* tsp_in, int* succ, int*
 	case 1:
 	{
 		printf("%sHard fixing%s\n", BLUE, WHITE);
-		time_t start = 0;
-		time_t end = 0;
+		deadline_timer timer;
+		timer_start(&timer, tsp_in->deadline);
 
 		double remaining_time = tsp_in->deadline;
 
@@ -98,10 +98,12 @@ void bc_solver(CPXENVptr env, CPXLPptr lp, tsp_instance* tsp_in, int* succ, int*
 
 		int count = 0;
 
+		//the same seed fixes the same edges
+		rng_state rng;
+		rng_seed(&rng, (uint64_t)tsp_in->seed);
+
 		for (; remaining_time >0 ; i++)
 		{
-			start = clock();
-
 			if (i == 0)
 			{
 				CPXsetintparam(env, CPX_PARAM_INTSOLLIM, 1);
@@ -118,13 +120,12 @@ void bc_solver(CPXENVptr env, CPXLPptr lp, tsp_instance* tsp_in, int* succ, int*
 			}
 
 			CPXmipopt(env, lp);
-			end = clock();
 
 			if (i == 0)
-				step = (tsp_in->deadline - ((double)(end - start) / (double)CLOCKS_PER_SEC)) / 5;
+				step = time_left(&timer) / 5;
 
 
-			remaining_time = remaining_time - ((double)(end - start) / (double)CLOCKS_PER_SEC);
+			remaining_time = time_left(&timer);
 
 			assert(CPXgetobjval(env, lp, &cost) == 0);
 
@@ -146,7 +147,7 @@ void bc_solver(CPXENVptr env, CPXLPptr lp, tsp_instance* tsp_in, int* succ, int*
 					break;
 			}*/
 
-			cplex_change_coeff(tsp_in, env, lp, tsp_in->sol, percentage[i % 5]);
+			cplex_change_coeff(tsp_in, env, lp, tsp_in->sol, percentage[i % 5], &rng);
 		}
 	}
 	break;
@@ -156,8 +157,8 @@ void bc_solver(CPXENVptr env, CPXLPptr lp, tsp_instance* tsp_in, int* succ, int*
 		printf("%sSoft fixing%s\n", CYAN, WHITE);
 		tsp_in->bestCostD = CPX_INFBOUND;
 
-		time_t start = 0;
-		time_t end = 0;
+		deadline_timer timer;
+		timer_start(&timer, tsp_in->deadline);
 
 		double remaining_time = tsp_in->deadline;
 
@@ -167,8 +168,6 @@ void bc_solver(CPXENVptr env, CPXLPptr lp, tsp_instance* tsp_in, int* succ, int*
 		i = 0;
 		for (; remaining_time > 0; i++)
 		{
-			start = clock();
-
 			if (i == 0)
 			{
 				
@@ -187,11 +186,10 @@ void bc_solver(CPXENVptr env, CPXLPptr lp, tsp_instance* tsp_in, int* succ, int*
 
 			CPXmipopt(env, lp);
 
-			end = clock();
 			if(i==0)
-				step =( tsp_in->deadline - ((double)(end - start) / (double)CLOCKS_PER_SEC)) / 9;
+				step = time_left(&timer) / 9;
 
-			remaining_time = remaining_time - ((double)(end - start) / (double)CLOCKS_PER_SEC);
+			remaining_time = time_left(&timer);
 				
 			assert(CPXgetobjval(env, lp, &cost) == 0);
 		
@@ -593,11 +591,10 @@ void local_branching(tsp_instance* tsp_in, CPXENVptr env, CPXLPptr lp, double* x
 }
 
 
-void cplex_change_coeff(tsp_instance* tsp_in, CPXENVptr env, CPXLPptr lp, double* x_best, int percentage)
+void cplex_change_coeff(tsp_instance* tsp_in, CPXENVptr env, CPXLPptr lp, double* x_best, int percentage, rng_state* rng)
 {
 	int i = 0;
 	char which_bound = 'L';
-	srand(time(NULL));
 	double lb;
 
 	for (; i < (tsp_in->num_nodes - 1); i++)
@@ -610,7 +607,7 @@ void cplex_change_coeff(tsp_instance* tsp_in, CPXENVptr env, CPXLPptr lp, double
 
 			if (x_best[pos] > 0.5)
 			{
-				int choice = rand() % 100;
+				int choice = rng_int(rng, 100);
 				lb = (choice < percentage) ? 1.0 : 0.0;
 			}
 			//printf("x (%d,%d) lb=%lf\n", i + 1, j + 1, lb);
@@ -9,6 +9,7 @@
 #define BC_SOLVER
 
 #include "cplex_solver.h"
+#include "rng.h"
 
 /**
 	@brief Branch&Cut solver with lazy callbacks.
@@ -64,9 +65,9 @@ int sec_bc_constraint_general(CPXCALLBACKCONTEXTptr context, tsp_instance* tsp_i
 	@param lp pointer to the LP structure, used by CPLEX solver
 	@param x_best solution in this node of the tree
 	@param percentage how many edge to fix
-
+	@param rng generator of the fixed edges
 */
-void cplex_change_coeff(tsp_instance* tsp_in, CPXENVptr env, CPXLPptr lp, double* x_best, int percentage);
+void cplex_change_coeff(tsp_instance* tsp_in, CPXENVptr env, CPXLPptr lp, double* x_best, int percentage, rng_state* rng);
 
 /**
 	@brief Function that adds constraints for the soft fixing method.
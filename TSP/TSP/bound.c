@@ -0,0 +1,616 @@
+/**
+	@file bound.c
+	@author Cristina Fabris
+	@author Raffaele Di Nardo Di Maio
+	@brief Held-Karp lower bound (1-trees with subgradient ascent) and alpha-nearness candidates.
+*/
+
+#include "bound.h"
+
+void lower_bound_init(lower_bound* lb, tsp_instance* tsp_in)
+{
+	int n = tsp_in->num_nodes;
+	lb->tsp_in = tsp_in;
+
+	//sparse graph: union of the nearest candidates of the nodes, in both directions
+	candidate_list cand;
+	build_nearest_candidate_list(tsp_in, &cand, BOUND_CANDIDATES);
+
+	lb->adj_start = (int*)calloc((size_t)n + 1, sizeof(int));
+	int* fill = (int*)calloc((size_t)n, sizeof(int));
+
+	int i, h;
+	for (i = 0; i < n; i++)
+	{
+		for (h = 0; h < cand.k; h++)
+		{
+			lb->adj_start[i + 1]++;
+			lb->adj_start[cand.nodes[i * cand.k + h] + 1]++;
+		}
+	}
+
+	for (i = 0; i < n; i++)
+		lb->adj_start[i + 1] += lb->adj_start[i];
+
+	//the edges in both lists are stored twice, which changes nothing for Prim
+	lb->adj_nodes = (int*)calloc((size_t)lb->adj_start[n], sizeof(int));
+	for (i = 0; i < n; i++)
+	{
+		for (h = 0; h < cand.k; h++)
+		{
+			int j = cand.nodes[i * cand.k + h];
+			lb->adj_nodes[lb->adj_start[i] + fill[i]++] = j;
+			lb->adj_nodes[lb->adj_start[j] + fill[j]++] = i;
+		}
+	}
+
+	free(fill);
+	free_candidate_list(&cand);
+
+	lb->sparse = 1;
+	lb->pi = (double*)calloc((size_t)n, sizeof(double));
+	lb->best_pi = (double*)calloc((size_t)n, sizeof(double));
+	lb->degree = (int*)calloc((size_t)n, sizeof(int));
+	lb->parent = (int*)calloc((size_t)n, sizeof(int));
+	lb->order = (int*)calloc((size_t)n, sizeof(int));
+	lb->key = (double*)calloc((size_t)n, sizeof(double));
+	lb->in_tree = (int*)calloc((size_t)n, sizeof(int));
+	lb->heap = (int*)calloc((size_t)n, sizeof(int));
+	lb->heap_pos = (int*)calloc((size_t)n, sizeof(int));
+	lb->heap_size = 0;
+	lb->special[0] = lb->special[1] = -1;
+
+	lb->lambda = BOUND_LAMBDA;
+	lb->no_improvement = 0;
+	lb->iterations = 0;
+	lb->best_value = -DBL_MAX;
+	lb->bound = -DBL_MAX;
+	lb->uncertified = 0;
+}
+
+void lower_bound_free(lower_bound* lb)
+{
+	free(lb->adj_start);
+	free(lb->adj_nodes);
+	free(lb->pi);
+	free(lb->best_pi);
+	free(lb->degree);
+	free(lb->parent);
+	free(lb->order);
+	free(lb->key);
+	free(lb->in_tree);
+	free(lb->heap);
+	free(lb->heap_pos);
+}
+
+int lower_bound_step(lower_bound* lb, double upper_bound)
+{
+	int n = lb->tsp_in->num_nodes;
+
+	double value = DBL_MAX;
+	if (lb->sparse)
+	{
+		value = one_tree(lb, lb->pi, 1);
+
+		//the candidate edges do not connect the nodes, so the ascent goes on with the complete graph
+		if (value == DBL_MAX)
+			lb->sparse = 0;
+	}
+
+	if (!lb->sparse)
+		value = one_tree(lb, lb->pi, 0);
+
+	lb->iterations++;
+
+	if (value > lb->best_value + EPS)
+	{
+		lb->best_value = value;
+		memcpy(lb->best_pi, lb->pi, (size_t)n * sizeof(double));
+		lb->no_improvement = 0;
+		lb->uncertified = lb->sparse;
+
+		//the 1-trees of the complete graph are valid bounds
+		if (!lb->sparse && value > lb->bound)
+			lb->bound = value;
+	}
+	else if (++(lb->no_improvement) >= BOUND_HALVING)
+	{
+		lb->lambda /= 2.0;
+		lb->no_improvement = 0;
+	}
+
+	double norm = 0.0;
+	int i;
+	for (i = 0; i < n; i++)
+		norm += (double)((lb->degree[i] - 2) * (lb->degree[i] - 2));
+
+	//a 1-tree whose nodes have all degree 2 is an optimal tour (of the sparse graph), or the step is too small to improve the bound
+	if (norm == 0.0 || lb->lambda < BOUND_MIN_LAMBDA)
+	{
+		lower_bound_certify(lb);
+		return 0;
+	}
+
+	//Polyak step towards the upper bound (a fraction of the bound while there is no tour)
+	double gap = upper_bound - value;
+	if (upper_bound == DBL_MAX)
+		gap = (BOUND_UPPER_FACTOR - 1.0) * fabs(value);
+	else if (gap < EPS * fabs(value))
+		gap = EPS * fabs(value);
+
+	double step = lb->lambda * gap / norm;
+
+	for (i = 0; i < n; i++)
+		lb->pi[i] += step * (double)(lb->degree[i] - 2);
+
+	if (lb->uncertified && lb->iterations % BOUND_CERTIFY_PERIOD == 0)
+		lower_bound_certify(lb);
+
+	return 1;
+}
+
+double one_tree(lower_bound* lb, double* pi, int sparse)
+{
+	int n = lb->tsp_in->num_nodes;
+	double value = 0.0;
+
+	int i;
+	for (i = 0; i < n; i++)
+	{
+		lb->degree[i] = 0;
+		lb->key[i] = DBL_MAX;
+		lb->in_tree[i] = 0;
+		lb->parent[i] = -1;
+		lb->heap_pos[i] = -1;
+	}
+
+	//spanning tree of the nodes 1...n-1 (Prim, rooted in node 1)
+	int num_in_tree = 0;
+	lb->key[1] = 0.0;
+
+	if (sparse)
+	{
+		lb->heap_size = 0;
+		lb->heap[lb->heap_size] = 1;
+		lb->heap_pos[1] = lb->heap_size++;
+
+		while (lb->heap_size > 0)
+		{
+			int u = bound_heap_pop(lb);
+			lb->in_tree[u] = 1;
+			lb->order[num_in_tree++] = u;
+
+			int h;
+			for (h = lb->adj_start[u]; h < lb->adj_start[u + 1]; h++)
+			{
+				int v = lb->adj_nodes[h];
+				if (v == 0 || lb->in_tree[v])
+					continue;
+
+				double w = penalized_cost(lb, pi, u, v);
+				if (w < lb->key[v])
+				{
+					lb->key[v] = w;
+					lb->parent[v] = u;
+
+					if (lb->heap_pos[v] < 0)
+					{
+						lb->heap[lb->heap_size] = v;
+						lb->heap_pos[v] = lb->heap_size++;
+					}
+
+					bound_heap_up(lb, lb->heap_pos[v]);
+				}
+			}
+		}
+
+		if (num_in_tree < n - 1)
+			return DBL_MAX;
+	}
+	else
+	{
+		int u = 1;
+		while (u >= 0)
+		{
+			lb->in_tree[u] = 1;
+			lb->order[num_in_tree++] = u;
+
+			int next = -1;
+			int v;
+			for (v = 1; v < n; v++)
+			{
+				if (lb->in_tree[v])
+					continue;
+
+				double w = penalized_cost(lb, pi, u, v);
+				if (w < lb->key[v])
+				{
+					lb->key[v] = w;
+					lb->parent[v] = u;
+				}
+
+				if (next < 0 || lb->key[v] < lb->key[next])
+					next = v;
+			}
+
+			u = next;
+		}
+	}
+
+	for (i = 1; i < num_in_tree; i++)
+	{
+		int v = lb->order[i];
+		value += lb->key[v];
+		lb->degree[v]++;
+		lb->degree[lb->parent[v]]++;
+	}
+
+	//the two cheapest edges of node 0
+	double first = DBL_MAX, second = DBL_MAX;
+	lb->special[0] = lb->special[1] = -1;
+
+	int begin = sparse ? lb->adj_start[0] : 1;
+	int end = sparse ? lb->adj_start[1] : n;
+
+	int h;
+	for (h = begin; h < end; h++)
+	{
+		int v = sparse ? lb->adj_nodes[h] : h;
+		if (v == lb->special[0])
+			continue;
+
+		double w = penalized_cost(lb, pi, 0, v);
+		if (w < first)
+		{
+			second = first;
+			lb->special[1] = lb->special[0];
+			first = w;
+			lb->special[0] = v;
+		}
+		else if (w < second)
+		{
+			second = w;
+			lb->special[1] = v;
+		}
+	}
+
+	value += first + second;
+	lb->degree[0] = 2;
+	lb->degree[lb->special[0]]++;
+	lb->degree[lb->special[1]]++;
+
+	for (i = 0; i < n; i++)
+		value -= 2.0 * pi[i];
+
+	return value;
+}
+
+void lower_bound_certify(lower_bound* lb)
+{
+	if (!lb->uncertified && lb->bound > -DBL_MAX)
+		return;
+
+	double value = one_tree(lb, lb->best_pi, 0);
+	if (value > lb->bound)
+		lb->bound = value;
+
+	lb->uncertified = 0;
+}
+
+double penalized_cost(lower_bound* lb, double* pi, int i, int j)
+{
+	return edge_cost(lb->tsp_in, i, j) + pi[i] + pi[j];
+}
+
+void bound_heap_up(lower_bound* lb, int index)
+{
+	int node = lb->heap[index];
+
+	while (index > 0)
+	{
+		int parent = (index - 1) / 2;
+		if (lb->key[lb->heap[parent]] <= lb->key[node])
+			break;
+
+		lb->heap[index] = lb->heap[parent];
+		lb->heap_pos[lb->heap[index]] = index;
+		index = parent;
+	}
+
+	lb->heap[index] = node;
+	lb->heap_pos[node] = index;
+}
+
+int bound_heap_pop(lower_bound* lb)
+{
+	int top = lb->heap[0];
+	lb->heap_pos[top] = -1;
+
+	int node = lb->heap[--(lb->heap_size)];
+	if (lb->heap_size == 0)
+		return top;
+
+	//the last node goes down from the root
+	int index = 0;
+	while (1)
+	{
+		int child = 2 * index + 1;
+		if (child >= lb->heap_size)
+			break;
+
+		if (child + 1 < lb->heap_size && lb->key[lb->heap[child + 1]] < lb->key[lb->heap[child]])
+			child++;
+
+		if (lb->key[node] <= lb->key[lb->heap[child]])
+			break;
+
+		lb->heap[index] = lb->heap[child];
+		lb->heap_pos[lb->heap[index]] = index;
+		index = child;
+	}
+
+	lb->heap[index] = node;
+	lb->heap_pos[node] = index;
+
+	return top;
+}
+
+int bound_gap_closed(tsp_instance* tsp_in, double upper_bound, double bound)
+{
+	if (upper_bound == DBL_MAX || bound == -DBL_MAX)
+		return 0;
+
+	//with integer costs the optimal tour costs at least the bound rounded up
+	if (tsp_in->integerDist)
+		return upper_bound <= ceil(bound - EPS);
+
+	return upper_bound - bound <= EPS * fabs(upper_bound);
+}
+
+void bound_start(bound_thread_args* args)
+{
+	args->bound = -DBL_MAX;
+	args->stop = 0;
+	args->closed = 0;
+	pthread_mutex_init(&(args->mutex), NULL);
+	pthread_cond_init(&(args->cond), NULL);
+
+	pthread_create(&(args->thread), NULL, bound_thread, (void*)args);
+}
+
+void bound_stop(bound_thread_args* args)
+{
+	pthread_mutex_lock(&(args->mutex));
+	ATOMIC_STORE(&(args->stop), 1);
+	pthread_cond_signal(&(args->cond));
+	pthread_mutex_unlock(&(args->mutex));
+
+	pthread_join(args->thread, NULL);
+	pthread_mutex_destroy(&(args->mutex));
+	pthread_cond_destroy(&(args->cond));
+}
+
+void* bound_thread(void* param)
+{
+	bound_thread_args* args = (bound_thread_args*)param;
+	tsp_instance* tsp_in = args->tsp_in;
+
+	//a 1-tree needs node 0 and two other nodes
+	if (tsp_in->num_nodes < 3)
+		return NULL;
+
+	lower_bound lb;
+	lower_bound_init(&lb, tsp_in);
+
+	double published = -DBL_MAX;
+	int running = 1;
+
+	while (!ATOMIC_LOAD(&(args->stop)) && time_left(args->timer) > 0.0)
+	{
+		//the single solvers publish only at the end, but they post their best cost to the progress reports
+		double upper_bound = incumbent_cost(args->best);
+		if (progress_cost() < upper_bound)
+			upper_bound = progress_cost();
+
+		if (running)
+			running = lower_bound_step(&lb, upper_bound);
+		else if (bound_wait(args))
+			break;
+
+		if (lb.bound > published)
+		{
+			published = lb.bound;
+			progress_bound(published);
+		}
+
+		//the incumbent is optimal: the solvers stop at their next check of the deadline
+		if (!args->closed && bound_gap_closed(tsp_in, upper_bound, lb.bound))
+		{
+			args->closed = 1;
+			timers_expire(1);
+		}
+	}
+
+	lower_bound_certify(&lb);
+	args->bound = lb.bound;
+	lower_bound_free(&lb);
+
+	return NULL;
+}
+
+int bound_wait(bound_thread_args* args)
+{
+	pthread_mutex_lock(&(args->mutex));
+
+	if (!args->stop)
+	{
+		struct timespec wake;
+		timespec_get(&wake, TIME_UTC);
+		wake.tv_nsec += BOUND_POLL_MS * 1000000L;
+		if (wake.tv_nsec >= 1000000000L)
+		{
+			wake.tv_sec++;
+			wake.tv_nsec -= 1000000000L;
+		}
+
+		pthread_cond_timedwait(&(args->cond), &(args->mutex), &wake);
+	}
+
+	int stop = args->stop;
+	pthread_mutex_unlock(&(args->mutex));
+
+	return stop;
+}
+
+void build_alpha_candidate_list(tsp_instance* tsp_in, candidate_list* list, int k)
+{
+	int n = tsp_in->num_nodes;
+	if (k > n - 1)
+		k = n - 1;
+
+	if (n < 3)
+	{
+		build_nearest_candidate_list(tsp_in, list, k);
+		return;
+	}
+
+	//penalties of a short ascent, without the cost of a tour
+	lower_bound lb;
+	lower_bound_init(&lb, tsp_in);
+
+	int it;
+	for (it = 0; it < BOUND_ALPHA_ITERATIONS && lower_bound_step(&lb, DBL_MAX); it++);
+
+	//alpha-nearness from the 1-tree of the complete graph with the best penalties
+	lb.uncertified = 1;
+	lower_bound_certify(&lb);
+
+	list->num_nodes = n;
+	list->k = k;
+	list->nodes = (int*)calloc((size_t)n * k, sizeof(int));
+	list->costs = (double*)calloc((size_t)n * k, sizeof(double));
+
+	double* beta = (double*)calloc((size_t)n, sizeof(double));
+	double* alpha = (double*)calloc((size_t)n, sizeof(double));
+	double* best_alpha = (double*)calloc((size_t)k, sizeof(double));
+	int* mark = (int*)calloc((size_t)n, sizeof(int));
+
+	int i;
+	for (i = 0; i < n; i++)
+	{
+		int* nodes = list->nodes + (size_t)i * k;
+		double* costs = list->costs + (size_t)i * k;
+		int size = 0;
+
+		alpha_nearness(&lb, i, beta, mark, alpha);
+
+		//the k nodes with minimum alpha (ties broken by cost)
+		int j;
+		for (j = 0; j < n; j++)
+		{
+			if (j == i)
+				continue;
+
+			double a = alpha[j];
+			double c = edge_cost(tsp_in, i, j);
+
+			if (size == k && (a > best_alpha[k - 1] || (a == best_alpha[k - 1] && c >= costs[k - 1])))
+				continue;
+
+			int h = (size < k) ? size++ : k - 1;
+			for (; h > 0 && (best_alpha[h - 1] > a || (best_alpha[h - 1] == a && costs[h - 1] > c)); h--)
+			{
+				best_alpha[h] = best_alpha[h - 1];
+				costs[h] = costs[h - 1];
+				nodes[h] = nodes[h - 1];
+			}
+
+			best_alpha[h] = a;
+			costs[h] = c;
+			nodes[h] = j;
+		}
+
+		//the local searches expect the candidates sorted by increasing cost
+		int h;
+		for (h = 1; h < k; h++)
+		{
+			double c = costs[h];
+			int node = nodes[h];
+			int g = h;
+
+			for (; g > 0 && costs[g - 1] > c; g--)
+			{
+				costs[g] = costs[g - 1];
+				nodes[g] = nodes[g - 1];
+			}
+
+			costs[g] = c;
+			nodes[g] = node;
+		}
+	}
+
+	free(beta);
+	free(alpha);
+	free(best_alpha);
+	free(mark);
+	lower_bound_free(&lb);
+}
+
+void alpha_nearness(lower_bound* lb, int node, double* beta, int* mark, double* alpha)
+{
+	int n = lb->tsp_in->num_nodes;
+	double* pi = lb->best_pi;
+
+	//the edges of node 0 replace the most expensive of its two edges in the 1-tree
+	double special_max = penalized_cost(lb, pi, 0, lb->special[0]);
+	double w = penalized_cost(lb, pi, 0, lb->special[1]);
+	if (w > special_max)
+		special_max = w;
+
+	int j;
+	if (node == 0)
+	{
+		for (j = 1; j < n; j++)
+		{
+			if (j == lb->special[0] || j == lb->special[1])
+				alpha[j] = 0.0;
+			else
+				alpha[j] = penalized_cost(lb, pi, 0, j) - special_max;
+		}
+
+		alpha[0] = DBL_MAX;
+		return;
+	}
+
+	//maximum weight of the path from node to the nodes of its path to the root
+	beta[node] = -DBL_MAX;
+	mark[node] = node + 1;
+
+	int u;
+	for (u = node; lb->parent[u] >= 0; u = lb->parent[u])
+	{
+		int p = lb->parent[u];
+		beta[p] = (beta[u] > lb->key[u]) ? beta[u] : lb->key[u];
+		mark[p] = node + 1;
+	}
+
+	//the other nodes in topological order, from their parent
+	int i;
+	for (i = 0; i < n - 1; i++)
+	{
+		int v = lb->order[i];
+		if (mark[v] == node + 1)
+			continue;
+
+		int p = lb->parent[v];
+		beta[v] = (beta[p] > lb->key[v]) ? beta[p] : lb->key[v];
+	}
+
+	for (j = 1; j < n; j++)
+		alpha[j] = (j == node) ? DBL_MAX : penalized_cost(lb, pi, node, j) - beta[j];
+
+	if (node == lb->special[0] || node == lb->special[1])
+		alpha[0] = 0.0;
+	else
+		alpha[0] = penalized_cost(lb, pi, 0, node) - special_max;
+}
@@ -0,0 +1,186 @@
+/**
+	@file bound.h
+	@author Cristina Fabris
+	@author Raffaele Di Nardo Di Maio
+	@brief Header of the Held-Karp lower bound (1-trees with subgradient ascent) and of the alpha-nearness candidates.
+*/
+
+#ifndef BOUND
+#define BOUND
+
+#include <float.h>
+#include <math.h>
+#include "candidate.h"
+#include "incumbent.h"
+#include "timer.h"
+#include "progress.h"
+
+#define HAVE_STRUCT_TIMESPEC
+#include <pthread.h>
+
+#define BOUND_CANDIDATES 10 //Nearest nodes of each node in the sparse graph of the 1-trees of the ascent
+#define BOUND_LAMBDA 2.0 //Starting factor of the step lambda * (upper - lower) / |subgradient|^2 of the ascent
+#define BOUND_HALVING 30 //Iterations without improvement of the bound after which the factor of the step is halved
+#define BOUND_MIN_LAMBDA 1e-4 //The ascent ends when the factor of the step is smaller
+#define BOUND_CERTIFY_PERIOD 20 //Iterations between two 1-trees on the complete graph, the only ones that give a valid bound
+#define BOUND_UPPER_FACTOR 1.05 //Upper bound of the step (times the lower bound) while there is no incumbent
+#define BOUND_POLL_MS 50 //Period (milliseconds) of the check of the gap after the end of the ascent
+#define BOUND_ALPHA_ITERATIONS 500 //Max iterations of the ascent of the penalties of the alpha-nearness candidates
+
+typedef struct
+{
+	tsp_instance* tsp_in; //pointer to tsp instance
+	int* adj_start; //sparse graph (candidate edges in both directions): neighbors of node i in adj_nodes[adj_start[i]...adj_start[i+1]-1]
+	int* adj_nodes;
+	int sparse; //1 while the sparse graph is connected, so its 1-trees drive the ascent
+	double* pi; //penalties of the nodes (the weight of the edge (i,j) is cost(i,j) + pi[i] + pi[j])
+	double* best_pi; //penalties of the best sparse 1-tree
+	int* degree; //degree of each node in the last 1-tree
+	int* parent; //parent of each node in the spanning tree of the nodes apart from node 0 (-1 for the root)
+	int* order; //nodes of the spanning tree in order of insertion (a parent is before its children)
+	int special[2]; //endpoints of the two edges of node 0 in the last 1-tree
+	double* key; //weight of the cheapest edge from each node to the tree built by Prim
+	int* in_tree; //1 if the node is already in the tree built by Prim
+	int* heap; //binary heap of the nodes ordered by key (sparse Prim)
+	int* heap_pos; //position of each node in the heap (-1 if not in the heap)
+	int heap_size; //number of nodes in the heap
+	double lambda; //factor of the step of the ascent
+	int no_improvement; //iterations without improvement of the best sparse 1-tree
+	int iterations; //iterations of the ascent
+	double best_value; //value of the best sparse 1-tree
+	double bound; //best valid lower bound (1-tree on the complete graph)
+	int uncertified; //1 if best_pi changed after the last 1-tree on the complete graph
+} lower_bound;
+
+typedef struct
+{
+	tsp_instance* tsp_in; //pointer to tsp instance
+	incumbent* best; //incumbent of the solver, whose cost is the upper bound
+	deadline_timer* timer; //deadline of the solver
+	double bound; //on return, best lower bound found
+	int stop; //1 if the thread has to terminate (protected by mutex)
+	int closed; //1 if the gap is closed and the deadlines of the solvers are expired
+	pthread_t thread;
+	pthread_mutex_t mutex;
+	pthread_cond_t cond;
+} bound_thread_args;
+
+/**
+	@brief Allocate the lower bound, with the sparse graph of the candidate edges and penalties all zero.
+	@param lb reference to the lower bound
+	@param tsp_in reference to tsp instance structure
+*/
+void lower_bound_init(lower_bound* lb, tsp_instance* tsp_in);
+
+/**
+	@brief Free the lower bound.
+	@param lb reference to the lower bound
+*/
+void lower_bound_free(lower_bound* lb);
+
+/**
+	@brief Do an iteration of the subgradient ascent of the penalties: the 1-tree of the sparse graph with the current penalties
+	and a step along the subgradient (degree - 2 of each node). Every BOUND_CERTIFY_PERIOD iterations, and at the end of the
+	ascent, the best penalties give a 1-tree on the complete graph, whose value is a valid lower bound.
+	@param lb reference to the lower bound
+	@param upper_bound cost of a tour (DBL_MAX if not known)
+	@return 1 if the ascent goes on, 0 if it is ended (step too small or 1-tree that is a tour)
+*/
+int lower_bound_step(lower_bound* lb, double upper_bound);
+
+/**
+	@brief Compute the value of the 1-tree with the given penalties: spanning tree of the nodes apart from node 0 (Prim)
+	plus the two cheapest edges of node 0, minus twice the sum of the penalties. The degrees of the nodes are stored in lb.
+	@param lb reference to the lower bound
+	@param pi penalties of the nodes
+	@param sparse 1 to use the sparse graph (Prim with binary heap), 0 to use the complete graph (Prim with arrays, O(n^2))
+	@return value of the 1-tree (DBL_MAX if the sparse graph is not connected)
+*/
+double one_tree(lower_bound* lb, double* pi, int sparse);
+
+/**
+	@brief Compute the 1-tree on the complete graph with the best penalties, and update the valid bound.
+	@param lb reference to the lower bound
+*/
+void lower_bound_certify(lower_bound* lb);
+
+/**
+	@brief Weight of an edge with the penalties.
+	@param lb reference to the lower bound
+	@param pi penalties of the nodes
+	@param i first endpoint
+	@param j second endpoint
+	@return cost(i,j) + pi[i] + pi[j]
+*/
+double penalized_cost(lower_bound* lb, double* pi, int i, int j);
+
+/**
+	@brief Move a node of the heap of the sparse Prim towards the root while its key is smaller than the one of its parent.
+	@param lb reference to the lower bound
+	@param index position of the node in the heap
+*/
+void bound_heap_up(lower_bound* lb, int index);
+
+/**
+	@brief Remove the node with the minimum key from the heap of the sparse Prim.
+	@param lb reference to the lower bound
+	@return node with the minimum key
+*/
+int bound_heap_pop(lower_bound* lb);
+
+/**
+	@brief Check if the gap between a tour and the lower bound is closed (the tour is optimal).
+	@param tsp_in reference to tsp instance structure
+	@param upper_bound cost of the tour
+	@param bound lower bound
+	@return 1 if the tour is optimal, 0 otherwise
+*/
+int bound_gap_closed(tsp_instance* tsp_in, double upper_bound, double bound);
+
+/**
+	@brief Start the thread of the lower bound, that runs the ascent during the solver, publishes the bound to the progress reports
+	and expires the deadlines of the solvers when the cost of the incumbent reaches the bound.
+	@param args reference to the parameters of the thread (tsp_in, best and timer already set)
+*/
+void bound_start(bound_thread_args* args);
+
+/**
+	@brief Stop the thread of the lower bound and wait for it.
+	@param args reference to the parameters of the thread, with the best lower bound on return
+*/
+void bound_stop(bound_thread_args* args);
+
+/**
+	@brief Thread of the lower bound.
+	@param param parameters of the thread (bound_thread_args)
+*/
+void* bound_thread(void* param);
+
+/**
+	@brief Wait for BOUND_POLL_MS milliseconds or until the thread is stopped.
+	@param args reference to the parameters of the thread
+	@return 1 if the thread has to terminate, 0 otherwise
+*/
+int bound_wait(bound_thread_args* args);
+
+/**
+	@brief Build the candidate lists with the k nodes of minimum alpha-nearness (increase of the value of the 1-tree that contains
+	the edge), with the penalties of a short subgradient ascent. Each list is sorted by increasing cost, as the nearest candidates.
+	@param tsp_in reference to tsp instance structure
+	@param list reference to the candidate list to fill
+	@param k number of candidates of each node (reduced to num_nodes-1 if bigger)
+*/
+void build_alpha_candidate_list(tsp_instance* tsp_in, candidate_list* list, int k);
+
+/**
+	@brief Compute the alpha-nearness of the edges from a node to all the other nodes, in O(n) from the last 1-tree:
+	the weight of the edge minus the maximum weight of the edges of the path between its endpoints in the tree.
+	@param lb reference to the lower bound, with the last 1-tree (on the complete graph)
+	@param node node
+	@param beta scratch of num_nodes elements (maximum weight of the path from node to each node)
+	@param mark scratch of num_nodes elements (the nodes of the path from node to the root are marked with node + 1)
+	@param alpha on return, alpha-nearness of the edge (node, j) in position j
+*/
+void alpha_nearness(lower_bound* lb, int node, double* beta, int* mark, double* alpha);
+
+#endif
@@ -0,0 +1,72 @@
+/**
+	@file candidate.c
+	@author Cristina Fabris
+	@author Raffaele Di Nardo Di Maio
+	@brief Candidate lists (nearest neighbors of each node) used by the local search moves.
+*/
+
+#include "candidate.h"
+#include <float.h>
+
+#ifdef ALPHA_CANDIDATES
+#include "bound.h"
+#endif
+
+void build_candidate_list(tsp_instance* tsp_in, candidate_list* list, int k)
+{
+	#ifdef ALPHA_CANDIDATES
+		build_alpha_candidate_list(tsp_in, list, k);
+	#else
+		build_nearest_candidate_list(tsp_in, list, k);
+	#endif
+}
+
+void build_nearest_candidate_list(tsp_instance* tsp_in, candidate_list* list, int k)
+{
+	if (k > tsp_in->num_nodes - 1)
+		k = tsp_in->num_nodes - 1;
+
+	list->num_nodes = tsp_in->num_nodes;
+	list->k = k;
+	list->nodes = (int*)calloc((size_t)tsp_in->num_nodes * k, sizeof(int));
+	list->costs = (double*)calloc((size_t)tsp_in->num_nodes * k, sizeof(double));
+
+	int i;
+	for (i = 0; i < tsp_in->num_nodes; i++)
+	{
+		int* nodes = list->nodes + (size_t)i * k;
+		double* costs = list->costs + (size_t)i * k;
+		int size = 0;
+
+		int j;
+		for (j = 0; j < tsp_in->num_nodes; j++)
+		{
+			if (j == i)
+				continue;
+
+			double c = edge_cost(tsp_in, i, j);
+
+			if (size == k && c >= costs[k - 1])
+				continue;
+
+			//insertion in the sorted list of the current candidates
+			int h = (size < k) ? size++ : k - 1;
+			for (; h > 0 && costs[h - 1] > c; h--)
+			{
+				costs[h] = costs[h - 1];
+				nodes[h] = nodes[h - 1];
+			}
+
+			costs[h] = c;
+			nodes[h] = j;
+		}
+	}
+}
+
+void free_candidate_list(candidate_list* list)
+{
+	free(list->nodes);
+	free(list->costs);
+	list->nodes = NULL;
+	list->costs = NULL;
+}
@@ -0,0 +1,50 @@
+/**
+	@file candidate.h
+	@author Cristina Fabris
+	@author Raffaele Di Nardo Di Maio
+	@brief Header of candidate lists (nearest neighbors of each node) used by the local search moves.
+*/
+
+#ifndef CANDIDATE
+#define CANDIDATE
+
+#include "tsp.h"
+#include "utility.h"
+
+#define NUM_CANDIDATES 10 //Default number of candidates of each node
+
+//if defined, the candidates are the nodes of minimum alpha-nearness (1-trees of the Held-Karp bound) instead of the nearest ones
+//#define ALPHA_CANDIDATES
+
+typedef struct
+{
+	int num_nodes; //number of nodes in the instance
+	int k; //number of candidates of each node
+	int* nodes; //candidates of node i in positions [i*k, (i+1)*k), sorted by increasing cost
+	double* costs; //cost of the edge between node i and each of its candidates
+} candidate_list;
+
+/**
+	@brief Build the candidate lists of the local search moves: the alpha-nearness candidates if ALPHA_CANDIDATES is defined,
+	the nearest ones otherwise.
+	@param tsp_in reference to tsp instance structure
+	@param list reference to the candidate list to fill
+	@param k number of candidates of each node (reduced to num_nodes-1 if bigger)
+*/
+void build_candidate_list(tsp_instance* tsp_in, candidate_list* list, int k);
+
+/**
+	@brief Build the list of the k nearest nodes of each node.
+	@param tsp_in reference to tsp instance structure
+	@param list reference to the candidate list to fill
+	@param k number of candidates of each node (reduced to num_nodes-1 if bigger)
+*/
+void build_nearest_candidate_list(tsp_instance* tsp_in, candidate_list* list, int k);
+
+/**
+	@brief Deallocation of a candidate list.
+	@param list reference to the candidate list
+*/
+void free_candidate_list(candidate_list* list);
+
+#endif
@@ -35,83 +35,67 @@ void cplex_solver(tsp_instance* tsp_in)
 	printf("%sCplex solver%s\n", RED, WHITE);
 	printf("%s[Cplex]%s", BLUE, WHITE);
 
+	deadline_timer timer;
+	timer_start(&timer, tsp_in->deadline);
+
 	switch (tsp_in->alg)
 	{
 		case 1:
 		{
-			time_t start = clock();
 			printf("Loop solver\n\n");
-			tsp_in->seed = SEED;
 			loop_solver(env, lp, tsp_in, succ, comp, &n_comps);
-			time_t end = clock();
-			tsp_in->execution_time = ((double)(end - start) / (double)CLOCKS_PER_SEC);
 			break;
 		}
 
 		case 2:
 		{
-			time_t start = clock();
 			printf("Branch&Cut solver with general callbacks\n\n");
 			bc_solver(env, lp, tsp_in, succ, comp, 0);
-			time_t end = clock();
-			tsp_in->execution_time = ((double)(end - start) / (double)CLOCKS_PER_SEC);
 			break;
 		}
 
 		case 3:
 		{
-			time_t start = clock();
 			printf("Branch&Cut solver\n\n");
 			bc_solver(env, lp, tsp_in, succ, comp, 1);
-			time_t end = clock();
-			tsp_in->execution_time = ((double)(end - start) / (double)CLOCKS_PER_SEC);
 			break;
 		}
 
 		case 4:
 		{
 			printf("Branch&Cut solver with patching\n\n");
-			time_t start_time = clock();
 			bc_solver(env, lp, tsp_in, succ, comp, 0);
-			time_t end_time = clock();
-			tsp_in->execution_time = ((double)(end_time - start_time) / (double)CLOCKS_PER_SEC);
 			break;
 		}
 
 		case 5:
 		{
 			printf("Branch&Cut solver with general callback and patching\n\n");
-			time_t start_time = clock();
 			bc_solver(env, lp, tsp_in, succ, comp, 0);
-			time_t end_time = clock();
-			tsp_in->execution_time = ((double)(end_time - start_time) / (double)CLOCKS_PER_SEC);
 			break;
 		}
 
 		case 6:
 		{
 			printf("MTZ solver\n\n");
-			time_t start_time = clock();
 			mtz_solver(env, lp, tsp_in);
-			time_t end_time = clock();
-			tsp_in->execution_time = ((double)(end_time - start_time) / (double)CLOCKS_PER_SEC);
 			break;
 		}
 
 		case 7:
 		{
 			printf("GG solver\n\n");
-			time_t start_time = clock();
 			gg_solver(env, lp, tsp_in);
-			time_t end_time = clock();
-			tsp_in->execution_time = ((double)(end_time - start_time) / (double)CLOCKS_PER_SEC);
 			break;
 
 		}
 	}
 
+	tsp_in->execution_time = timer_elapsed(&timer);
+	tsp_in->cpu_execution_time = timer_cpu(&timer);
+
 	print_cost(tsp_in);
-	printf("%sExecution time:%s %.3lf seconds\n",GREEN, WHITE ,tsp_in->execution_time);
+	printf("%sExecution time:%s %.3lf seconds (CPU %.3lf seconds)\n",GREEN, WHITE ,tsp_in->execution_time, tsp_in->cpu_execution_time);
 	printf("%s%s%s", RED, LINE, WHITE);
 
 	if (tsp_in->plot)
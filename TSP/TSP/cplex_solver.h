@@ -12,6 +12,7 @@
 #include <cplex.h>
 #include <time.h>
 #include "utility.h"
+#include "timer.h"
 
 //Number of ms that compose a sec (to convert second to ms)
 #define TIME_SCALE 1000
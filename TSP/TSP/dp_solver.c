@@ -0,0 +1,304 @@
+/**
+	@file dp_solver.c
+	@author Cristina Fabris
+	@author Raffaele Di Nardo Di Maio
+	@brief Exact Held-Karp dynamic programming solver, for the small instances.
+*/
+
+#include "dp_solver.h"
+#include "popmusic.h"
+
+void dp_solver(tsp_instance* tsp_in)
+{
+	deadline_timer timer;
+	timer_start(&timer, tsp_in->deadline);
+
+	printf("%sDynamic programming solver%s\n", RED, WHITE);
+	printf("%s[Exact]%s Held-Karp (%d nodes, instead of algorithm %d)\n", BLUE, WHITE, tsp_in->num_nodes, tsp_in->alg);
+	printf("%s%s%s", RED, LINE, WHITE);
+
+	//the tour starts from node 0, the subsets are made of the other nodes
+	dp_table table;
+	int m = tsp_in->num_nodes - 1;
+	int num_subsets = 1 << m;
+	table.num_nodes = m;
+	table.costs = (double*)malloc((size_t)num_subsets * m * sizeof(double));
+	table.dist = (double*)calloc((size_t)(m * m), sizeof(double));
+
+	int j;
+	for (j = 0; j < m; j++)
+	{
+		int k;
+		for (k = 0; k < m; k++)
+			table.dist[j * m + k] = edge_cost(tsp_in, k + 1, j + 1);
+	}
+
+	//layer 1: the paths from node 0 to each node
+	double* start = (double*)calloc((size_t)m, sizeof(double));
+	for (j = 0; j < m; j++)
+		start[j] = edge_cost(tsp_in, 0, j + 1);
+
+	dp_singletons(&table, start);
+	free(start);
+
+	//the subsets of each layer depend only on the previous layer, so the layer is split in blocks of subsets
+	thread_pool pool;
+	pool_init(&pool, tsp_in->num_threads);
+
+	int num_workers = tsp_in->num_threads;
+	dp_worker_args* args = (dp_worker_args*)calloc((size_t)num_workers, sizeof(dp_worker_args));
+
+	int i;
+	for (i = 0; i < num_workers; i++)
+	{
+		args[i].table = &table;
+		args[i].id = i;
+		args[i].num_workers = num_workers;
+	}
+
+	int size;
+	for (size = 2; size <= m; size++)
+	{
+		for (i = 0; i < num_workers; i++)
+		{
+			args[i].size = size;
+			pool_submit(&pool, dp_worker, (void*)&args[i]);
+		}
+
+		pool_wait(&pool);
+	}
+
+	pool_destroy(&pool);
+
+	int last = 0;
+	double best_cost = DP_INFINITY;
+	for (j = 0; j < m; j++)
+	{
+		double cost = table.costs[(size_t)(num_subsets - 1) * m + j] + edge_cost(tsp_in, j + 1, 0);
+
+		if (cost < best_cost)
+		{
+			best_cost = cost;
+			last = j;
+		}
+	}
+
+	int* visited_nodes = (int*)calloc((size_t)tsp_in->num_nodes, sizeof(int));
+	dp_tour(&table, last, visited_nodes);
+
+	int num_edges = (tsp_in->num_nodes) * (tsp_in->num_nodes - 1) / 2;
+	int* succ = (int*)calloc((size_t)tsp_in->num_nodes, sizeof(int));
+	tsp_in->sol = (double*)calloc((size_t)num_edges, sizeof(double));
+	tsp_in->bestCostD = tour_cost(tsp_in, visited_nodes);
+	tsp_in->bestCostI = (int)tsp_in->bestCostD;
+	update_solution(visited_nodes, tsp_in->sol, tsp_in->num_nodes);
+	succ_construction(visited_nodes, succ, tsp_in->num_nodes);
+
+	tsp_in->execution_time = timer_elapsed(&timer);
+	tsp_in->cpu_execution_time = timer_cpu(&timer);
+	print_cost(tsp_in);
+	printf("%sExecution time:%s %.3lf seconds (CPU %.3lf seconds)\n", GREEN, WHITE, tsp_in->execution_time, tsp_in->cpu_execution_time);
+	printf("%s%s%s", RED, LINE, WHITE);
+
+	if (tsp_in->plot)
+	{
+		int* comp = (int*)calloc((size_t)tsp_in->num_nodes, sizeof(int));
+		int n_comps = 1;
+
+		for (i = 0; i < tsp_in->num_nodes; i++)
+			comp[i] = 1;
+
+		plot(tsp_in, succ, comp, &n_comps);
+		free(comp);
+	}
+
+	free(args);
+	free(visited_nodes);
+	free(succ);
+	free(tsp_in->sol);
+	free(table.costs);
+	free(table.dist);
+}
+
+void dp_worker(void* param)
+{
+	dp_worker_args* args = (dp_worker_args*)param;
+
+	int num_subsets = 1 << args->table->num_nodes;
+
+	int block;
+	for (block = args->id * DP_BLOCK; block < num_subsets; block += args->num_workers * DP_BLOCK)
+	{
+		int subset;
+		for (subset = block; subset < block + DP_BLOCK && subset < num_subsets; subset++)
+		{
+			//number of nodes of the subset (each bit is cleared in turn)
+			int size = 0;
+			int bits = subset;
+
+			for (; bits != 0; bits &= bits - 1)
+				size++;
+
+			if (size == args->size)
+				dp_subset(args->table, subset);
+		}
+	}
+}
+
+void dp_singletons(dp_table* table, double* start)
+{
+	int m = table->num_nodes;
+
+	int j;
+	for (j = 0; j < m; j++)
+	{
+		int k;
+		for (k = 0; k < m; k++)
+			table->costs[(size_t)(1 << j) * m + k] = (k == j) ? start[j] : DP_INFINITY;
+	}
+}
+
+void dp_path(dp_table* table, double* start)
+{
+	dp_singletons(table, start);
+
+	int subset;
+	for (subset = 1; subset < (1 << table->num_nodes); subset++)
+	{
+		if (subset & (subset - 1))
+			dp_subset(table, subset);
+	}
+}
+
+void window_refinement(tsp_instance* tsp_in, int* visited_nodes, double* best_cost, deadline_timer* timer, thread_pool* pool)
+{
+	//the windows are the subpaths of the POPMUSIC sweeps, optimized exactly
+	popmusic(tsp_in, visited_nodes, best_cost, WINDOW_SIZE + 2, popmusic_exact, timer, pool, NULL);
+}
+
+double dp_window(window_worker_args* args, int first)
+{
+	tsp_instance* tsp_in = args->tsp_in;
+	int* visited_nodes = args->visited_nodes;
+	int n = tsp_in->num_nodes;
+	int k = args->table.num_nodes;
+	double* dist = args->table.dist;
+
+	int head = visited_nodes[first % n];
+	int tail = visited_nodes[(first + k + 1) % n];
+	double current_cost = 0.0;
+
+	int j;
+	for (j = 0; j < k; j++)
+	{
+		args->nodes[j] = visited_nodes[(first + 1 + j) % n];
+		args->start[j] = edge_cost(tsp_in, head, args->nodes[j]);
+		current_cost += edge_cost(tsp_in, (j == 0) ? head : args->nodes[j - 1], args->nodes[j]);
+	}
+
+	current_cost += edge_cost(tsp_in, args->nodes[k - 1], tail);
+
+	for (j = 0; j < k; j++)
+	{
+		int i;
+		for (i = 0; i < k; i++)
+			dist[j * k + i] = edge_cost(tsp_in, args->nodes[i], args->nodes[j]);
+	}
+
+	dp_path(&(args->table), args->start);
+
+	int last = 0;
+	double best_cost = DP_INFINITY;
+	for (j = 0; j < k; j++)
+	{
+		double cost = args->table.costs[(size_t)((1 << k) - 1) * k + j] + edge_cost(tsp_in, args->nodes[j], tail);
+
+		if (cost < best_cost)
+		{
+			best_cost = cost;
+			last = j;
+		}
+	}
+
+	if (best_cost > current_cost - EPS)
+		return 0.0;
+
+	//order[1...k] are the nodes of the optimal path (indices in nodes plus 1)
+	dp_tour(&(args->table), last, args->order);
+
+	for (j = 0; j < k; j++)
+		visited_nodes[(first + 1 + j) % n] = args->nodes[args->order[j + 1] - 1];
+
+	return current_cost - best_cost;
+}
+
+void dp_subset(dp_table* table, int subset)
+{
+	int m = table->num_nodes;
+	double* row = table->costs + (size_t)subset * m;
+
+	int j;
+	for (j = 0; j < m; j++)
+	{
+		if (!(subset & (1 << j)))
+		{
+			row[j] = DP_INFINITY;
+			continue;
+		}
+
+		//contiguous row of the previous subset and of the predecessors of j, min reduction vectorized by the compiler
+		double* previous = table->costs + (size_t)(subset & ~(1 << j)) * m;
+		double* dist = table->dist + j * m;
+		double min_cost = DP_INFINITY;
+
+		int k;
+		for (k = 0; k < m; k++)
+		{
+			double cost = previous[k] + dist[k];
+			min_cost = (cost < min_cost) ? cost : min_cost;
+		}
+
+		row[j] = min_cost;
+	}
+}
+
+void dp_tour(dp_table* table, int last, int* visited_nodes)
+{
+	int m = table->num_nodes;
+	int subset = (1 << m) - 1;
+	int j = last;
+
+	//the tour is built backwards from its last node, the predecessor of each state is the one that gives its cost
+	int i;
+	for (i = m; i >= 1; i--)
+	{
+		visited_nodes[i] = j + 1;
+
+		double cost = table->costs[(size_t)subset * m + j];
+		subset &= ~(1 << j);
+
+		if (subset == 0)
+			break;
+
+		double* previous = table->costs + (size_t)subset * m;
+		double* dist = table->dist + j * m;
+		int best = -1;
+		double best_error = DP_INFINITY;
+
+		int k;
+		for (k = 0; k < m; k++)
+		{
+			double error = fabs(previous[k] + dist[k] - cost);
+
+			if ((subset & (1 << k)) && error < best_error)
+			{
+				best_error = error;
+				best = k;
+			}
+		}
+
+		j = best;
+	}
+
+	visited_nodes[0] = 0;
+}
@@ -0,0 +1,109 @@
+/**
+	@file dp_solver.h
+	@author Cristina Fabris
+	@author Raffaele Di Nardo Di Maio
+	@brief Header of the exact Held-Karp dynamic programming solver, for the small instances.
+*/
+
+#ifndef DP_SOLVER
+#define DP_SOLVER
+
+#include "heuristic.h"
+
+#define DP_INFINITY HUGE_VAL //Cost of the states whose last node is not in the subset
+#define DP_BLOCK 256 //Consecutive subsets computed by a worker (the blocks of a layer are assigned to the workers in turn)
+#define WINDOW_SIZE 10 //Nodes between the two fixed endpoints of a window of the window refinement
+
+typedef struct
+{
+	int num_nodes; //number of nodes of the subsets (all the nodes apart from node 0, which is the start of the tour)
+	double* costs; //cost of the shortest path from node 0 through the subset S to its node j + 1 in position S * num_nodes + j
+	double* dist; //cost of the edge from node k + 1 to node j + 1 in position j * num_nodes + k (row of the predecessors of j + 1)
+} dp_table;
+
+typedef struct
+{
+	tsp_instance* tsp_in; //pointer to tsp instance
+	int* visited_nodes; //tour refined by the windows (shared by the workers, the windows of a sweep are disjoint)
+	dp_table table; //table of the paths through the nodes of a window (WINDOW_SIZE nodes)
+	double* start; //cost of the edges from the first endpoint to the nodes of the window
+	int* nodes; //nodes of the window, in the order of the tour
+	int* order; //optimal order of the nodes of the window (indices in nodes, plus 1)
+} window_worker_args;
+
+typedef struct
+{
+	dp_table* table; //table shared by the workers
+	int id; //index of the worker, that computes the blocks id, id + num_workers, ...
+	int num_workers; //number of workers
+	int size; //number of nodes of the subsets of the current layer
+} dp_worker_args;
+
+/**
+	@brief Solve the instance to optimality with the Held-Karp dynamic programming, in O(n^2 2^n) time and O(n 2^n) memory.
+	The subsets of the same size depend only on the smaller ones, so each layer is split among the threads of the pool.
+	@param tsp_in reference to tsp instance structure
+*/
+void dp_solver(tsp_instance* tsp_in);
+
+/**
+	@brief Compute the states of the subsets of the current layer in the blocks of the worker (job of the thread pool).
+	The subsets of a layer are spread over all the subsets, so the blocks in turn balance the work of the workers.
+	@param param parameters of the worker (dp_worker_args)
+*/
+void dp_worker(void* param);
+
+/**
+	@brief Set the states of the subsets with one node.
+	@param table reference to the table
+	@param start cost of the edges from the start of the paths to the nodes of the subsets
+*/
+void dp_singletons(dp_table* table, double* start);
+
+/**
+	@brief Compute the states of all the subsets, in increasing order (each subset depends only on smaller ones).
+	@param table reference to the table
+	@param start cost of the edges from the start of the paths to the nodes of the subsets
+*/
+void dp_path(dp_table* table, double* start);
+
+/**
+	@brief Refine a tour by solving exactly the path between the two endpoints of windows of WINDOW_SIZE consecutive nodes,
+	in O(n 2^k k^2) for each sweep of windows (k = WINDOW_SIZE). The windows are the subpaths of a POPMUSIC decomposition
+	(popmusic with popmusic_exact): disjoint in a sweep and refined in parallel on the pool, shifted by half a window
+	by each sweep, until two sweeps give no improvement or the deadline is expired.
+	It finds the improvements of the reorderings of k nodes, that a 2-opt local optimum can still have.
+	@param tsp_in reference to tsp instance structure
+	@param visited_nodes sequence of the visited nodes, replaced by the refined one
+	@param best_cost cost of the tour, replaced by the cost of the refined one
+	@param timer deadline of the solver
+	@param pool thread pool of the workers (NULL to refine the windows in the calling thread)
+*/
+void window_refinement(tsp_instance* tsp_in, int* visited_nodes, double* best_cost, deadline_timer* timer, thread_pool* pool);
+
+/**
+	@brief Solve exactly the path through the nodes of a window and replace them in the tour if the path is shorter.
+	@param args table and buffers of the worker
+	@param first position of the first endpoint of the window
+	@return decrease of the cost of the tour (0 if the order of the window is already optimal)
+*/
+double dp_window(window_worker_args* args, int first);
+
+/**
+	@brief Compute the states of a subset: for each node j + 1 of the subset, the minimum over the predecessors k + 1
+	of the path through the subset without j + 1 that ends in k + 1, plus the edge (k + 1, j + 1).
+	The minimum is a loop without branches over all the nodes (the states of the nodes not in the subset are DP_INFINITY).
+	@param table reference to the table
+	@param subset subset of the nodes (bit j for node j + 1)
+*/
+void dp_subset(dp_table* table, int subset);
+
+/**
+	@brief Build the optimal tour from the table, following back the predecessor of each state.
+	@param table reference to the table
+	@param last node (index in the subsets) of the last state of the optimal tour
+	@param visited_nodes on return, sequence of the visited nodes of the optimal tour
+*/
+void dp_tour(dp_table* table, int last, int* visited_nodes);
+
+#endif
@@ -0,0 +1,418 @@
+/**
+	@file gls.c
+	@author Cristina Fabris
+	@author Raffaele Di Nardo Di Maio
+	@brief Guided Local Search (penalties on the edges of the local optima).
+*/
+
+#include "gls.h"
+
+void guided_local_search(tsp_instance* tsp_in, int* visited_nodes, double* best_cost, double deadline)
+{
+	deadline_timer timer;
+	timer_start(&timer, deadline);
+
+	int n = tsp_in->num_nodes;
+
+	#ifndef MULTI_START
+	if (tsp_in->verbose > PROGRESS_VERBOSE)
+		printf("%sStarting cost:%s %.2lf\n", RED, WHITE, *best_cost);
+	#endif
+
+	candidate_list cand;
+	build_candidate_list(tsp_in, &cand, NUM_CANDIDATES);
+
+	gls_search search;
+	gls_search_init(&search, tsp_in, &cand);
+	gls_search_load(&search, visited_nodes, *best_cost);
+
+	progress_source source;
+	progress_source_init(&source);
+	long long num_local_optima = 0;
+	long long num_penalties = 0;
+
+	while (gls_local_search(&search, &timer))
+	{
+		num_local_optima++;
+
+		if (search.cost < *best_cost - EPS)
+		{
+			//the cost is updated incrementally by the moves, so it is recomputed before being stored
+			search.cost = tour_cost(tsp_in, search.tour);
+
+			if (search.cost < *best_cost)
+			{
+				*best_cost = search.cost;
+				memcpy(visited_nodes, search.tour, n * sizeof(int));
+			}
+		}
+
+		//the weight of the penalties is fixed by the first local optimum (without penalties)
+		if (search.lambda == 0.0)
+			search.lambda = GLS_ALPHA * search.cost / n;
+
+		num_penalties += gls_penalize(&search);
+
+		#ifndef MULTI_START
+		progress_post(&source, num_local_optima, *best_cost, search.cost, time_left(&timer));
+		#endif
+	}
+
+	//the last tour is not a local optimum of the augmented cost, but it can improve the real one
+	search.cost = tour_cost(tsp_in, search.tour);
+	if (search.cost < *best_cost)
+	{
+		*best_cost = search.cost;
+		memcpy(visited_nodes, search.tour, n * sizeof(int));
+	}
+
+	#ifndef MULTI_START
+	//the status line is closed before the statistics of the search
+	progress_stop();
+	if (tsp_in->verbose > 50)
+		printf("%sLocal optima :%s %lld  %spenalties :%s %lld  %smoves :%s %lld\n", BLUE, WHITE, num_local_optima,
+			BLUE, WHITE, num_penalties, BLUE, WHITE, search.num_moves);
+	#endif
+
+	gls_search_free(&search);
+	free_candidate_list(&cand);
+}
+
+void gls_search_init(gls_search* search, tsp_instance* tsp_in, candidate_list* cand)
+{
+	int n = tsp_in->num_nodes;
+
+	search->tsp_in = tsp_in;
+	search->cand = cand;
+	search->penalties = (int*)calloc((size_t)(n * cand->k), sizeof(int));
+	search->table_capacity = GLS_TABLE_CAPACITY;
+	search->table_size = 0;
+	search->table_edges = (long long*)malloc((size_t)search->table_capacity * sizeof(long long));
+	search->table_penalties = (int*)calloc((size_t)search->table_capacity, sizeof(int));
+	search->lambda = 0.0;
+	search->tour = (int*)calloc((size_t)n, sizeof(int));
+	search->pos = (int*)calloc((size_t)n, sizeof(int));
+	search->cost = 0.0;
+	search->queue = (int*)calloc((size_t)n, sizeof(int));
+	search->queued = (int*)calloc((size_t)n, sizeof(int));
+	search->head = 0;
+	search->num_queued = 0;
+	search->num_moves = 0;
+
+	int i;
+	for (i = 0; i < search->table_capacity; i++)
+		search->table_edges[i] = -1;
+}
+
+void gls_search_load(gls_search* search, int* visited_nodes, double cost)
+{
+	int n = search->tsp_in->num_nodes;
+
+	search->cost = cost;
+
+	int i;
+	for (i = 0; i < n; i++)
+	{
+		search->tour[i] = visited_nodes[i];
+		search->pos[visited_nodes[i]] = i;
+		gls_activate(search, visited_nodes[i]);
+	}
+}
+
+void gls_search_free(gls_search* search)
+{
+	free(search->penalties);
+	free(search->table_edges);
+	free(search->table_penalties);
+	free(search->tour);
+	free(search->pos);
+	free(search->queue);
+	free(search->queued);
+}
+
+int gls_edge_slot(candidate_list* cand, int i, int j)
+{
+	int u = (i < j) ? i : j;
+	int v = (i < j) ? j : i;
+
+	int r;
+	for (r = 0; r < cand->k; r++)
+	{
+		if (cand->nodes[u * cand->k + r] == v)
+			return u * cand->k + r;
+	}
+
+	for (r = 0; r < cand->k; r++)
+	{
+		if (cand->nodes[v * cand->k + r] == u)
+			return v * cand->k + r;
+	}
+
+	return -1;
+}
+
+int* gls_penalty(gls_search* search, int i, int j, int insert)
+{
+	int slot = gls_edge_slot(search->cand, i, j);
+
+	if (slot >= 0)
+		return &(search->penalties[slot]);
+
+	long long n = search->tsp_in->num_nodes;
+	long long edge = (i < j) ? i * n + j : j * n + i;
+	int mask = search->table_capacity - 1;
+
+	//linear probing from the multiplicative hash of the edge
+	int entry = (int)(((unsigned long long)edge * 0x9E3779B97F4A7C15ULL) >> 32) & mask;
+
+	while (search->table_edges[entry] != -1)
+	{
+		if (search->table_edges[entry] == edge)
+			return &(search->table_penalties[entry]);
+
+		entry = (entry + 1) & mask;
+	}
+
+	if (!insert)
+		return NULL;
+
+	//the table is kept at most half full
+	if (2 * (search->table_size + 1) > search->table_capacity)
+	{
+		gls_table_grow(search);
+		return gls_penalty(search, i, j, insert);
+	}
+
+	search->table_edges[entry] = edge;
+	search->table_penalties[entry] = 0;
+	search->table_size++;
+
+	return &(search->table_penalties[entry]);
+}
+
+void gls_table_grow(gls_search* search)
+{
+	long long* edges = search->table_edges;
+	int* penalties = search->table_penalties;
+	int capacity = search->table_capacity;
+	long long n = search->tsp_in->num_nodes;
+
+	search->table_capacity = 2 * capacity;
+	search->table_size = 0;
+	search->table_edges = (long long*)malloc((size_t)search->table_capacity * sizeof(long long));
+	search->table_penalties = (int*)calloc((size_t)search->table_capacity, sizeof(int));
+
+	int i;
+	for (i = 0; i < search->table_capacity; i++)
+		search->table_edges[i] = -1;
+
+	for (i = 0; i < capacity; i++)
+	{
+		if (edges[i] != -1)
+			*gls_penalty(search, (int)(edges[i] / n), (int)(edges[i] % n), 1) = penalties[i];
+	}
+
+	free(edges);
+	free(penalties);
+}
+
+double gls_augmented_cost(gls_search* search, int i, int j)
+{
+	double cost = edge_cost(search->tsp_in, i, j);
+
+	if (search->lambda == 0.0)
+		return cost;
+
+	int* penalty = gls_penalty(search, i, j, 0);
+
+	return (penalty == NULL) ? cost : cost + search->lambda * (*penalty);
+}
+
+void gls_activate(gls_search* search, int node)
+{
+	if (search->queued[node])
+		return;
+
+	int n = search->tsp_in->num_nodes;
+	search->queue[(search->head + search->num_queued) % n] = node;
+	search->queued[node] = 1;
+	search->num_queued++;
+}
+
+int gls_local_search(gls_search* search, deadline_timer* timer)
+{
+	int n = search->tsp_in->num_nodes;
+	int num_steps = 0;
+
+	while (search->num_queued > 0)
+	{
+		if (++num_steps % GLS_TIME_CHECK == 0 && time_left(timer) <= 0)
+			return 0;
+
+		int a = search->queue[search->head];
+		search->head = (search->head + 1) % n;
+		search->num_queued--;
+		search->queued[a] = 0;
+
+		//a stays active until none of its moves improves the augmented cost
+		if (gls_improve_node(search, a))
+			gls_activate(search, a);
+	}
+
+	return time_left(timer) > 0;
+}
+
+int gls_improve_node(gls_search* search, int a)
+{
+	tsp_instance* tsp_in = search->tsp_in;
+	candidate_list* cand = search->cand;
+	int* tour = search->tour;
+	int* pos = search->pos;
+	int n = tsp_in->num_nodes;
+	int k = cand->k;
+
+	if (n < 8)
+		return 0;
+
+	//2-opt moves that add the edge (a,c), removing the edges from a and c to their successors or to their predecessors
+	int direction;
+	for (direction = 0; direction < 2; direction++)
+	{
+		int b = (direction == 0) ? tour[(pos[a] + 1) % n] : tour[(pos[a] - 1 + n) % n];
+		double cost_a_b = gls_augmented_cost(search, a, b);
+
+		int r;
+		for (r = 0; r < k; r++)
+		{
+			int c = cand->nodes[a * k + r];
+
+			//the augmented cost of (a,c) is not smaller than its cost, so the next candidates cannot give a gain
+			if (cand->costs[a * k + r] >= cost_a_b)
+				break;
+
+			int d = (direction == 0) ? tour[(pos[c] + 1) % n] : tour[(pos[c] - 1 + n) % n];
+
+			if (c == b || d == a)
+				continue;
+
+			double delta = gls_augmented_cost(search, a, c) + gls_augmented_cost(search, b, d) - cost_a_b - gls_augmented_cost(search, c, d);
+
+			if (delta < -EPS)
+			{
+				search->cost += edge_cost(tsp_in, a, c) + edge_cost(tsp_in, b, d) - edge_cost(tsp_in, a, b) - edge_cost(tsp_in, c, d);
+				two_opt_move(tour, pos, n, a, b, c);
+				search->num_moves++;
+
+				gls_activate(search, b);
+				gls_activate(search, c);
+				gls_activate(search, d);
+
+				return 1;
+			}
+		}
+	}
+
+	//Or-opt moves of the segment that starts in a, inserted next to one of the candidates of a (as in sa_random_move)
+	int length;
+	for (length = 1; length <= MAX_OR_OPT && length <= n - 4; length++)
+	{
+		int s1 = a;
+		int s2 = tour[(pos[a] + length - 1) % n];
+		int p = tour[(pos[a] - 1 + n) % n];
+		int nx = tour[(pos[s2] + 1) % n];
+		double removed = gls_augmented_cost(search, p, s1) + gls_augmented_cost(search, s2, nx) - gls_augmented_cost(search, p, nx);
+
+		int r;
+		for (r = 0; r < k; r++)
+		{
+			int c = cand->nodes[a * k + r];
+			int offset = (pos[c] - pos[s1] + n) % n;
+			if (offset < length || c == p)
+				continue;
+
+			int d = tour[(pos[c] + 1) % n];
+			if (d == p)
+				continue;
+
+			double cost_c_d = gls_augmented_cost(search, c, d);
+			double delta_forward = gls_augmented_cost(search, c, s1) + gls_augmented_cost(search, s2, d) - cost_c_d - removed;
+			double delta_reversed = gls_augmented_cost(search, c, s2) + gls_augmented_cost(search, s1, d) - cost_c_d - removed;
+
+			sa_move move;
+			move.type = 1;
+			move.p = p;
+			move.s1 = s1;
+			move.s2 = s2;
+			move.nx = nx;
+			move.c = c;
+			move.d = d;
+			move.reversed = (length == 1 || delta_reversed < delta_forward);
+
+			double delta = (move.reversed) ? delta_reversed : delta_forward;
+
+			if (delta < -EPS)
+			{
+				double common = edge_cost(tsp_in, p, nx) - edge_cost(tsp_in, p, s1) - edge_cost(tsp_in, s2, nx) - edge_cost(tsp_in, c, d);
+
+				if (move.reversed)
+					search->cost += common + edge_cost(tsp_in, c, s2) + edge_cost(tsp_in, s1, d);
+				else
+					search->cost += common + edge_cost(tsp_in, c, s1) + edge_cost(tsp_in, s2, d);
+
+				sa_apply_move(tour, pos, n, &move);
+				search->num_moves++;
+
+				gls_activate(search, p);
+				gls_activate(search, nx);
+				gls_activate(search, s2);
+				gls_activate(search, c);
+				gls_activate(search, d);
+
+				return 1;
+			}
+		}
+	}
+
+	return 0;
+}
+
+int gls_penalize(gls_search* search)
+{
+	tsp_instance* tsp_in = search->tsp_in;
+	int n = tsp_in->num_nodes;
+	double max_utility = -1.0;
+
+	int i;
+	for (i = 0; i < n; i++)
+	{
+		int u = search->tour[i];
+		int v = search->tour[(i + 1) % n];
+		int* penalty = gls_penalty(search, u, v, 0);
+
+		double utility = edge_cost(tsp_in, u, v) / (1.0 + ((penalty == NULL) ? 0 : *penalty));
+
+		if (utility > max_utility)
+			max_utility = utility;
+	}
+
+	int num_penalized = 0;
+
+	for (i = 0; i < n; i++)
+	{
+		int u = search->tour[i];
+		int v = search->tour[(i + 1) % n];
+		int* penalty = gls_penalty(search, u, v, 0);
+
+		if (edge_cost(tsp_in, u, v) / (1.0 + ((penalty == NULL) ? 0 : *penalty)) < max_utility - EPS)
+			continue;
+
+		(*gls_penalty(search, u, v, 1))++;
+		num_penalized++;
+
+		//only the endpoints of the penalized edges are searched again
+		gls_activate(search, u);
+		gls_activate(search, v);
+	}
+
+	return num_penalized;
+}
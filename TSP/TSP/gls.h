@@ -0,0 +1,135 @@
+/**
+	@file gls.h
+	@author Cristina Fabris
+	@author Raffaele Di Nardo Di Maio
+	@brief Header of the Guided Local Search (penalties on the edges of the local optima).
+*/
+
+#ifndef GLS
+#define GLS
+
+#include "heuristic.h"
+
+#define GLS_ALPHA 0.3 //Weight of the penalties, as a fraction of the average edge of the first local optimum
+#define GLS_TIME_CHECK 256 //Nodes processed by the local search between two checks of the remaining time
+#define GLS_TABLE_CAPACITY 1024 //Initial capacity of the table with the penalties of the edges that are not candidate edges (power of two)
+
+typedef struct
+{
+	tsp_instance* tsp_in; //pointer to tsp instance
+	candidate_list* cand; //candidate lists of the nodes, the first edge added by each move is a candidate edge
+	int* penalties; //penalty of the edge between node i and its r-th candidate in position i*k + r
+	long long* table_edges; //other penalized edges (i * num_nodes + j with i < j, -1 if the entry is empty), open addressing
+	int* table_penalties; //penalty of the edge in the same entry of table_edges
+	int table_capacity; //number of entries of the table (power of two)
+	int table_size; //number of edges in the table
+	double lambda; //cost of a unit of penalty in the augmented cost
+	int* tour; //current sequence of visited nodes
+	int* pos; //position of each node in tour
+	double cost; //cost of tour (without penalties)
+	int* queue; //nodes with the don't look bit off, processed in FIFO order
+	int* queued; //1 if the node is in the queue (don't look bit off), 0 otherwise
+	int head; //position of the first node of the queue
+	int num_queued; //number of nodes in the queue
+	long long num_moves; //moves applied by the local search
+} gls_search;
+
+/**
+	@brief Compute the Guided Local Search algorithm: a local search with don't look bits on the augmented cost,
+	which penalizes the edges of maximum utility of each local optimum.
+	@param tsp_in reference to tsp instance structure
+	@param visited_nodes array with sequence of the visited nodes, replaced by the best tour found
+	@param best_cost cost of the starting tour, replaced by the cost of the best tour found
+	@param deadline time limit of the algorithm (seconds)
+*/
+void guided_local_search(tsp_instance* tsp_in, int* visited_nodes, double* best_cost, double deadline);
+
+/**
+	@brief Allocate the state of a search without penalties (lambda = 0, so the local search uses the cost of the edges).
+	@param search reference to the state of the search
+	@param tsp_in reference to tsp instance structure
+	@param cand candidate lists of the nodes
+*/
+void gls_search_init(gls_search* search, tsp_instance* tsp_in, candidate_list* cand);
+
+/**
+	@brief Set the current tour of the search, with the don't look bits of all the nodes off.
+	@param search reference to the state of the search
+	@param visited_nodes array with sequence of the visited nodes
+	@param cost cost of the tour
+*/
+void gls_search_load(gls_search* search, int* visited_nodes, double cost);
+
+/**
+	@brief Deallocation of the state of a search.
+	@param search reference to the state of the search
+*/
+void gls_search_free(gls_search* search);
+
+/**
+	@brief Position of the penalty of an edge in the penalty store.
+	The edge is looked for in the candidates of the node with smaller index first, so each edge has a single position.
+	@param cand candidate lists of the nodes
+	@param i first node of the edge
+	@param j second node of the edge
+	@return index in the penalty store (-1 if the edge is not a candidate edge of i or j)
+*/
+int gls_edge_slot(candidate_list* cand, int i, int j);
+
+/**
+	@brief Penalty counter of an edge: its position among the candidate edges, otherwise its entry in the table of the other edges.
+	@param search reference to the state of the search
+	@param i first node of the edge
+	@param j second node of the edge
+	@param insert 1 if the edge has to be inserted in the table when it is not present, 0 otherwise
+	@return pointer to the penalty of the edge (NULL if the edge has no penalty and insert is 0)
+*/
+int* gls_penalty(gls_search* search, int i, int j, int insert);
+
+/**
+	@brief Double the capacity of the table of the penalties of the edges that are not candidate edges.
+	@param search reference to the state of the search
+*/
+void gls_table_grow(gls_search* search);
+
+/**
+	@brief Augmented cost of an edge (cost + lambda * penalty).
+	@param search reference to the state of the search
+	@param i first node of the edge
+	@param j second node of the edge
+	@return augmented cost of the edge
+*/
+double gls_augmented_cost(gls_search* search, int i, int j);
+
+/**
+	@brief Turn off the don't look bit of a node, inserting it in the queue.
+	@param search reference to the state of the search
+	@param node node to activate
+*/
+void gls_activate(gls_search* search, int node);
+
+/**
+	@brief Local search on the augmented cost with don't look bits, until the queue is empty or the deadline.
+	@param search reference to the state of the search
+	@param timer deadline of the algorithm
+	@return 1 if a local optimum is reached, 0 if the deadline is expired
+*/
+int gls_local_search(gls_search* search, deadline_timer* timer);
+
+/**
+	@brief Apply the first move improving the augmented cost among the 2-opt and Or-opt moves that add an edge from a node to one of its candidates.
+	The endpoints of the changed edges are activated.
+	@param search reference to the state of the search
+	@param a node with the don't look bit off
+	@return 1 if a move is applied, 0 otherwise
+*/
+int gls_improve_node(gls_search* search, int a);
+
+/**
+	@brief Penalize the edges of the local optimum with maximum utility cost / (1 + penalty) and activate their endpoints.
+	@param search reference to the state of the search
+	@return number of penalized edges
+*/
+int gls_penalize(gls_search* search);
+
+#endif
@@ -0,0 +1,184 @@
+/**
+	@file gpx.c
+	@author Cristina Fabris
+	@author Raffaele Di Nardo Di Maio
+	@brief Generalized partition crossover (GPX), used to merge the tours of the multi-start.
+*/
+
+#include "gpx.h"
+
+void gpx_workspace_init(gpx_workspace* gpx, int num_nodes)
+{
+	gpx->adj_a = (int*)calloc((size_t)(2 * num_nodes), sizeof(int));
+	gpx->adj_b = (int*)calloc((size_t)(2 * num_nodes), sizeof(int));
+	gpx->component = (int*)calloc((size_t)num_nodes, sizeof(int));
+	gpx->stack = (int*)calloc((size_t)num_nodes, sizeof(int));
+	gpx->num_cuts = (int*)calloc((size_t)num_nodes, sizeof(int));
+	gpx->cost_a = (double*)calloc((size_t)num_nodes, sizeof(double));
+	gpx->cost_b = (double*)calloc((size_t)num_nodes, sizeof(double));
+	gpx->choice = (int*)calloc((size_t)num_nodes, sizeof(int));
+}
+
+void gpx_workspace_free(gpx_workspace* gpx)
+{
+	free(gpx->adj_a);
+	free(gpx->adj_b);
+	free(gpx->component);
+	free(gpx->stack);
+	free(gpx->num_cuts);
+	free(gpx->cost_a);
+	free(gpx->cost_b);
+	free(gpx->choice);
+}
+
+int gpx_crossover(tsp_instance* tsp_in, gpx_workspace* gpx, int* parent_a, int* parent_b, int* offspring, double* cost)
+{
+	int n = tsp_in->num_nodes;
+
+	int i;
+	for (i = 0; i < n; i++)
+	{
+		gpx->adj_a[2 * parent_a[i]] = parent_a[(i + n - 1) % n];
+		gpx->adj_a[2 * parent_a[i] + 1] = parent_a[(i + 1) % n];
+		gpx->adj_b[2 * parent_b[i]] = parent_b[(i + n - 1) % n];
+		gpx->adj_b[2 * parent_b[i] + 1] = parent_b[(i + 1) % n];
+	}
+
+	int num_components = gpx_components(gpx, n);
+
+	gpx_count_cuts(tsp_in, gpx, num_components, parent_a, parent_b);
+
+	//a component cut by two common edges is a single path in both the parents between the same endpoints;
+	//the other components are fused and take the same parent
+	double rest_a = 0.0;
+	double rest_b = 0.0;
+	int num_partitions = 0;
+
+	for (i = 0; i < num_components; i++)
+	{
+		if (gpx->num_cuts[i] == 2)
+		{
+			gpx->choice[i] = (gpx->cost_b[i] < gpx->cost_a[i] - EPS) ? GPX_PARENT_B : GPX_PARENT_A;
+
+			if (gpx->cost_a[i] > 0.0 || gpx->cost_b[i] > 0.0)
+				num_partitions++;
+		}
+		else
+		{
+			rest_a += gpx->cost_a[i];
+			rest_b += gpx->cost_b[i];
+		}
+	}
+
+	int rest = (rest_b < rest_a - EPS) ? GPX_PARENT_B : GPX_PARENT_A;
+
+	for (i = 0; i < num_components; i++)
+	{
+		if (gpx->num_cuts[i] != 2)
+			gpx->choice[i] = rest;
+	}
+
+	//the neighbors of each node are the ones of the parent of its component (the cuts are in both the parents)
+	int previous = parent_a[0];
+	int node = parent_a[0];
+
+	for (i = 0; i < n; i++)
+	{
+		offspring[i] = node;
+
+		int* adj = (gpx->choice[gpx->component[node]] == GPX_PARENT_A) ? gpx->adj_a : gpx->adj_b;
+		int next = (adj[2 * node] != previous) ? adj[2 * node] : adj[2 * node + 1];
+
+		previous = node;
+		node = next;
+	}
+
+	*cost = tour_cost(tsp_in, offspring);
+
+	return num_partitions;
+}
+
+void gpx_count_cuts(tsp_instance* tsp_in, gpx_workspace* gpx, int num_components, int* parent_a, int* parent_b)
+{
+	int n = tsp_in->num_nodes;
+
+	int i;
+	for (i = 0; i < num_components; i++)
+	{
+		gpx->num_cuts[i] = 0;
+		gpx->cost_a[i] = 0.0;
+		gpx->cost_b[i] = 0.0;
+	}
+
+	//the common edges between two components are cuts, the other edges are always inside a component
+	for (i = 0; i < n; i++)
+	{
+		int u = parent_a[i];
+		int v = parent_a[(i + 1) % n];
+		int cu = gpx->component[u];
+		int cv = gpx->component[v];
+
+		if (!gpx_is_common(gpx, u, v))
+			gpx->cost_a[cu] += edge_cost(tsp_in, u, v);
+		else if (cu != cv)
+		{
+			gpx->num_cuts[cu]++;
+			gpx->num_cuts[cv]++;
+		}
+
+		u = parent_b[i];
+		v = parent_b[(i + 1) % n];
+
+		if (!gpx_is_common(gpx, u, v))
+			gpx->cost_b[gpx->component[u]] += edge_cost(tsp_in, u, v);
+	}
+}
+
+int gpx_components(gpx_workspace* gpx, int num_nodes)
+{
+	int i;
+	for (i = 0; i < num_nodes; i++)
+		gpx->component[i] = -1;
+
+	int num_components = 0;
+
+	for (i = 0; i < num_nodes; i++)
+	{
+		if (gpx->component[i] != -1)
+			continue;
+
+		int top = 0;
+		gpx->stack[top++] = i;
+		gpx->component[i] = num_components;
+
+		while (top > 0)
+		{
+			int node = gpx->stack[--top];
+
+			//the edges of the union graph that are not common (at most four for each node)
+			int j;
+			for (j = 0; j < 4; j++)
+			{
+				int other = (j < 2) ? gpx->adj_a[2 * node + j] : gpx->adj_b[2 * node + j - 2];
+
+				if (gpx->component[other] == -1 && !gpx_is_common(gpx, node, other))
+				{
+					gpx->component[other] = num_components;
+					gpx->stack[top++] = other;
+				}
+			}
+		}
+
+		num_components++;
+	}
+
+	return num_components;
+}
+
+int gpx_is_common(gpx_workspace* gpx, int node, int other)
+{
+	int in_a = (gpx->adj_a[2 * node] == other || gpx->adj_a[2 * node + 1] == other);
+	int in_b = (gpx->adj_b[2 * node] == other || gpx->adj_b[2 * node + 1] == other);
+
+	return in_a && in_b;
+}
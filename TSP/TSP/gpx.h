@@ -0,0 +1,83 @@
+/**
+	@file gpx.h
+	@author Cristina Fabris
+	@author Raffaele Di Nardo Di Maio
+	@brief Header of the generalized partition crossover (GPX), used to merge the tours of the multi-start.
+*/
+
+#ifndef GPX
+#define GPX
+
+#include "heuristic.h"
+
+#define GPX_PARENT_A 0 //The component takes the edges of the first parent
+#define GPX_PARENT_B 1 //The component takes the edges of the second parent
+
+typedef struct
+{
+	int* adj_a; //neighbors of each node in the first parent (2 x num_nodes)
+	int* adj_b; //neighbors of each node in the second parent (2 x num_nodes)
+	int* component; //component of each node in the union graph without the common edges
+	int* stack; //nodes to visit in the labelling of the components
+	int* num_cuts; //common edges between each component and the rest of the graph
+	double* cost_a; //cost of the edges of the first parent inside each component (common edges excluded)
+	double* cost_b; //cost of the edges of the second parent inside each component (common edges excluded)
+	int* choice; //parent chosen for each component (GPX_PARENT_A or GPX_PARENT_B)
+} gpx_workspace;
+
+/**
+	@brief Allocate the scratch of the partition crossover.
+	@param gpx reference to the scratch
+	@param num_nodes number of nodes
+*/
+void gpx_workspace_init(gpx_workspace* gpx, int num_nodes);
+
+/**
+	@brief Free the scratch of the partition crossover.
+	@param gpx reference to the scratch
+*/
+void gpx_workspace_free(gpx_workspace* gpx);
+
+/**
+	@brief Generalized partition crossover, in O(num_nodes). The components of the union graph of the parents without
+	their common edges that are cut by exactly two common edges are visited by both the parents in a single path
+	with the same endpoints, so each one independently takes the cheaper path. The remaining components together
+	take the cheaper parent. The offspring is never worse than the best parent.
+	@param tsp_in reference to tsp instance structure
+	@param gpx scratch of the thread
+	@param parent_a visited nodes of the first parent
+	@param parent_b visited nodes of the second parent
+	@param offspring on return, visited nodes of the offspring (already allocated)
+	@param cost on return, cost of the offspring
+	@return number of components cut by two common edges with different paths in the parents (0 if the parents have no partition)
+*/
+int gpx_crossover(tsp_instance* tsp_in, gpx_workspace* gpx, int* parent_a, int* parent_b, int* offspring, double* cost);
+
+/**
+	@brief Label the components of the union graph of the parents without their common edges (depth first visit).
+	@param gpx scratch of the thread, with the neighbors of the parents
+	@param num_nodes number of nodes
+	@return number of components
+*/
+int gpx_components(gpx_workspace* gpx, int num_nodes);
+
+/**
+	@brief Count the common edges between each component and the rest of the graph and the cost of each parent inside each component.
+	@param tsp_in reference to tsp instance structure
+	@param gpx scratch of the thread, with the components
+	@param num_components number of components
+	@param parent_a visited nodes of the first parent
+	@param parent_b visited nodes of the second parent
+*/
+void gpx_count_cuts(tsp_instance* tsp_in, gpx_workspace* gpx, int num_components, int* parent_a, int* parent_b);
+
+/**
+	@brief Check if the edge (node, other) is in both the parents.
+	@param gpx scratch of the thread, with the neighbors of the parents
+	@param node first endpoint
+	@param other second endpoint
+	@return 1 if the edge is common, 0 otherwise
+*/
+int gpx_is_common(gpx_workspace* gpx, int node, int other);
+
+#endif
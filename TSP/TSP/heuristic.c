@@ -7,13 +7,21 @@
 
 #include "heuristic.h"
 #include "utility.h"
+#include "gls.h"
+#include "aco.h"
+#include "alns.h"
+#include "gpx.h"
+#include "dp_solver.h"
+#include "bound.h"
 
 pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
 
 
 void heuristic_solver(tsp_instance* tsp_in)
 {
-	time_t start = clock();
+	deadline_timer timer;
+	timer_start(&timer, tsp_in->deadline);
+	timers_expire(0);
 
 	tsp_in->bestCostD = DBL_MAX;
 	tsp_in->bestCostI = INT_MAX;
@@ -22,6 +30,10 @@ void heuristic_solver(tsp_instance* tsp_in)
 	tsp_in->sol = (double*)calloc((size_t)num_edges, sizeof(double));
 	int* succ = (int*)calloc((size_t)tsp_in->num_nodes, sizeof(int));
 
+	//the threads publish only their tour, sol and succ are built once at the end
+	incumbent best;
+	incumbent_init(&best, tsp_in->num_nodes);
+
 	printf("%sHeuristic solver%s\n", RED, WHITE);
 	printf("%s[Construction]%s ", BLUE, WHITE);
 
@@ -37,21 +49,37 @@ void heuristic_solver(tsp_instance* tsp_in)
 
 	printf("%s[Meta-heuristic]%s ", BLUE, WHITE);
 
+	//name of the solver and of the value in the progress reports
+	const char* solver = "multistart";
+	const char* value_name = NULL;
+
 	switch (tsp_in->alg)
 	{
 	case 8:
 	{
 		printf("VNS\n");
+		#ifndef MULTI_START
+		solver = "vns";
+		value_name = "k";
+		#endif
 		break;
 	}
 	case 9:
 	{
 		printf("Tabu search\n");
+		#ifndef MULTI_START
+		solver = "tabu";
+		value_name = "Actual cost";
+		#endif
 		break;
 	}
 	case 10:
 	{
 		printf("Simulated anealling\n");
+		#ifndef MULTI_START
+		solver = "sa";
+		value_name = "T";
+		#endif
 		break;
 	}
 	case 11:
@@ -59,82 +87,99 @@ void heuristic_solver(tsp_instance* tsp_in)
 		printf("Genetic\n");
 		break;
 	}
+	case 12:
+	{
+		printf("Parallel tabu search\n");
+		#ifndef MULTI_START
+		solver = "parallel tabu";
+		value_name = "Actual cost";
+		#endif
+		break;
+	}
+	case 13:
+	{
+		printf("Parallel tempering\n");
+		#ifndef MULTI_START
+		solver = "pt";
+		value_name = "Coldest cost";
+		#endif
+		break;
+	}
+	case 14:
+	{
+		printf("Guided local search\n");
+		#ifndef MULTI_START
+		solver = "gls";
+		value_name = "Local optimum";
+		#endif
+		break;
+	}
+	case 15:
+	{
+		printf("MAX-MIN ant system\n");
+		#ifndef MULTI_START
+		solver = "aco";
+		value_name = "Iteration best";
+		#endif
+		break;
+	}
+	case 16:
+	{
+		printf("Adaptive large neighborhood search\n");
+		#ifndef MULTI_START
+		solver = "alns";
+		value_name = "Current cost";
+		#endif
+		break;
+	}
 	}
 	printf("%s%s%s", RED, LINE, WHITE);
 
-	time_t end_iter = clock();
-	double remaining_time = tsp_in->deadline - ((double)(end_iter - start) / (double)CLOCKS_PER_SEC);
 	printf("\n");
 
-	#ifdef MULTI_START
-		#ifdef FIXED_TIME_MS
-			
-			int count=0;
-			while (remaining_time > 0)
-			{	
-				count++;
-				time_t start_iter = clock();
-				pthread_t threads[NUM_MULTI_START];
-				thread_args param[NUM_MULTI_START];
-
-				int i = 0;
-				for (; i < NUM_MULTI_START; i++)
-				{
-					param[i].tsp_in = tsp_in;
-					param[i].succ = succ;
-					param[i].seed = STEP_SEED * (i + 1+count);
-					param[i].start = start;
-
-					pthread_create(&threads[i], NULL, computeSolution, (void*)&param[i]);
-				}
-
-				for (i = 0; i < NUM_MULTI_START; i++)
-				{
-					int rc = pthread_join(threads[i], NULL);
-
-					if (rc)
-						exit(-1);
-				}
-				time_t end_iter = clock();
-				remaining_time -= ((double)(end_iter - start_iter) / (double)CLOCKS_PER_SEC);
-
-				if(tsp_in->integerDist)
-					printf("\r%sRemaining time : %s%.2lf  %d ", CYAN, WHITE, remaining_time, tsp_in->bestCostI);
-				else
-					printf("\r%sRemaining time : %s%.2lf  %.2lf ", CYAN, WHITE, remaining_time, tsp_in->bestCostD);
-			}
-		#else
-			pthread_t threads[NUM_MULTI_START];
-			thread_args param[NUM_MULTI_START];
+	//the solvers only post their samples, the status line is printed by the reporter thread
+	progress_start(tsp_in, solver, value_name);
 
-			int i = 0;
-			for (; i < NUM_MULTI_START; i++)
-			{
-				param[i].tsp_in = tsp_in;
-				param[i].succ = succ;
-				param[i].seed = STEP_SEED * (i + 1);
-				param[i].start = start;
+	#ifdef LOWER_BOUND
+		//the bound is computed by its own thread, that stops the solver if the incumbent reaches it
+		bound_thread_args bound;
+		bound.tsp_in = tsp_in;
+		bound.best = &best;
+		bound.timer = &timer;
+		bound_start(&bound);
+	#endif
 
-				pthread_create(&threads[i], NULL, computeSolution, (void*)&param[i]);
-			}
+	#ifdef MULTI_START
+		//persistent pool: each start submits the next one until the deadline (FIXED_TIME_MS), so no thread waits for the others
+		thread_pool pool;
+		pool_init(&pool, tsp_in->num_threads);
+
+		multi_start_params params;
+		params.tsp_in = tsp_in;
+		params.best = &best;
+		params.timer = &timer;
+		params.pool = &pool;
+		params.next_seed = 0;
+		progress_source_init(&(params.source));
+		archive_init(&(params.archive), tsp_in->num_nodes, ELITE_POOL_SIZE);
 
-			for (i = 0; i < NUM_MULTI_START; i++)
-			{
-				int rc = pthread_join(threads[i], NULL);
+		int i = 0;
+		for (; i < tsp_in->num_threads; i++)
+			pool_submit(&pool, multi_start_job, (void*)&params);
 
-				if (rc)
-					exit(-1);
-			}
-		#endif
+		pool_wait(&pool);
+		pool_destroy(&pool);
+		archive_free(&(params.archive));
 	
 	#else
 		pthread_t thread;
 		thread_args param;
 
 		param.tsp_in = tsp_in;
-		param.succ = succ;
+		param.best = &best;
 		param.seed = 0;
-		param.start = start;
+		param.timer = &timer;
+		param.archive = NULL;
 
 		pthread_create(&thread, NULL, computeSolution, (void*)&param);
 
@@ -144,10 +189,36 @@ void heuristic_solver(tsp_instance* tsp_in)
 			exit(-1);
 	#endif
 
-	time_t end = clock();
-	tsp_in->execution_time = ((double)(end - start) / (double)CLOCKS_PER_SEC);
+	#ifdef LOWER_BOUND
+		bound_stop(&bound);
+		timers_expire(0);
+	#endif
+
+	progress_stop();
+
+	int* visited_nodes = (int*)calloc((size_t)tsp_in->num_nodes, sizeof(int));
+	tsp_in->bestCostD = incumbent_load(&best, visited_nodes);
+	tsp_in->bestCostI = (int)tsp_in->bestCostD;
+	update_solution(visited_nodes, tsp_in->sol, tsp_in->num_nodes);
+	succ_construction(visited_nodes, succ, tsp_in->num_nodes);
+	free(visited_nodes);
+	incumbent_free(&best);
+
+	tsp_in->execution_time = timer_elapsed(&timer);
+	tsp_in->cpu_execution_time = timer_cpu(&timer);
 	print_cost(tsp_in);
-	printf("%sExecution time:%s %.3lf seconds\n", GREEN, WHITE, tsp_in->execution_time);
+
+	#ifdef LOWER_BOUND
+		if (bound.bound > -DBL_MAX)
+		{
+			//the bound can exceed the cost of an optimal tour only by rounding errors
+			double gap = (tsp_in->bestCostD > bound.bound) ? 100.0 * (tsp_in->bestCostD - bound.bound) / tsp_in->bestCostD : 0.0;
+			printf("%sLower bound :%s %.2lf  %sGap :%s %.2lf%%", GREEN, WHITE, bound.bound, GREEN, WHITE, gap);
+			printf(bound.closed ? "  (optimal)\n" : "\n");
+		}
+	#endif
+
+	printf("%sExecution time:%s %.3lf seconds (CPU %.3lf seconds)\n", GREEN, WHITE, tsp_in->execution_time, tsp_in->cpu_execution_time);
 	printf("%s%s%s", RED, LINE, WHITE);
 
 	int* comp = (int*)calloc(tsp_in->num_nodes, sizeof(int));
@@ -156,7 +227,7 @@ void heuristic_solver(tsp_instance* tsp_in)
 	{
 		switch (tsp_in->alg)
 		{
-		case 8: case 9: case 10:
+		case 8: case 9: case 10: case 12: case 13: case 14: case 15: case 16:
 		{
 			int k;
 			for (k = 0; k < tsp_in->num_nodes; k++)
@@ -180,26 +251,31 @@ void* computeSolution(void* param)
 	double best_cost = 0.0;
 	int* visited_nodes = (int*)calloc((size_t) args->tsp_in->num_nodes, sizeof(int));
 
-	time_t start = clock();
-	double remaining_time = args->tsp_in->deadline -( (double)(start - args->start) / (double) CLOCKS_PER_SEC );
+	//generator of the thread, derived from the seed of the run
+	rng_state rng;
+	rng_stream(&rng, (uint64_t)args->tsp_in->seed, (uint64_t)args->seed);
 
-	srand(args->seed);
 	if (!CONSTRUCTION_TYPE)
-		nearest_neighborhood(args->tsp_in, visited_nodes, &best_cost, args->seed, rand() % args->tsp_in->num_nodes);
+		nearest_neighborhood(args->tsp_in, visited_nodes, &best_cost, &rng, rng_int(&rng, args->tsp_in->num_nodes));
 	else
-		insertion(args->tsp_in, visited_nodes, &best_cost, args->seed, rand() % args->tsp_in->num_nodes);
+		insertion(args->tsp_in, visited_nodes, &best_cost, &rng, rng_int(&rng, args->tsp_in->num_nodes));
 
-	greedy_refinement(args->tsp_in, visited_nodes, &best_cost);
+	#ifdef MULTI_START
+		//a start that builds a tour already seen would find again the same local optimum, so it restarts from an elite tour
+		if (archive_seen(args->archive, tour_hash(visited_nodes, args->tsp_in->num_nodes)))
+			archive_restart(args->tsp_in, args->archive, visited_nodes, &best_cost, &rng);
+	#endif
 
-	time_t end_first_generation = clock();
-	remaining_time = remaining_time - ((double)(end_first_generation-start)/(double)CLOCKS_PER_SEC);
+	greedy_refinement(args->tsp_in, visited_nodes, &best_cost);
 
 	#ifndef MULTI_START
+	double remaining_time = time_left(args->timer);
+
 	switch (args->tsp_in->alg)
 	{
 		case 8:
 		{
-			hybrid_vns(args->tsp_in, visited_nodes, &best_cost, remaining_time);
+			hybrid_vns(args->tsp_in, visited_nodes, &best_cost, remaining_time, &rng);
 			break;
 		}
 		case 9:
@@ -209,44 +285,117 @@ void* computeSolution(void* param)
 		}
 		case 10:
 		{
-			simulated_annealing(args->tsp_in, visited_nodes, &best_cost, remaining_time);
+			simulated_annealing(args->tsp_in, visited_nodes, &best_cost, remaining_time, &rng);
+			break;
+		}
+		case 12:
+		{
+			parallel_tabu_search(args->tsp_in, visited_nodes, &best_cost, remaining_time, &rng);
+			break;
+		}
+		case 13:
+		{
+			parallel_tempering(args->tsp_in, visited_nodes, &best_cost, remaining_time, &rng);
+			break;
+		}
+		case 14:
+		{
+			guided_local_search(args->tsp_in, visited_nodes, &best_cost, remaining_time);
+			break;
+		}
+		case 15:
+		{
+			ant_colony(args->tsp_in, visited_nodes, &best_cost, remaining_time, &rng);
+			break;
+		}
+		case 16:
+		{
+			alns(args->tsp_in, visited_nodes, &best_cost, remaining_time, &rng);
 			break;
 		}
 	}
 	#endif
 	
-	pthread_mutex_lock(&mutex);
-	
 	#ifndef FIXED_TIME_MS
+		pthread_mutex_lock(&mutex);
 		printf("%sCost:%s %.2lf\n",GREEN, WHITE, best_cost);
+		pthread_mutex_unlock(&mutex);
 	#endif
-	
-	if (args->tsp_in->integerDist)
-	{
-		if (((int)best_cost) < args->tsp_in->bestCostI)
+
+	#ifdef MULTI_START
+		//a local optimum already seen is already merged with the incumbent and in the elite tours
+		if (!archive_seen(args->archive, tour_hash(visited_nodes, args->tsp_in->num_nodes)))
 		{
-			args->tsp_in->bestCostI = (int)best_cost;
-			update_solution(visited_nodes, args->tsp_in->sol, args->tsp_in->num_nodes);
-			succ_construction(visited_nodes, args->succ, args->tsp_in->num_nodes);
+			#ifdef GPX_MERGE
+				//the tour is merged with the incumbent, so also a worse start can improve some of its partitions
+				gpx_merge(args->tsp_in, args->best, visited_nodes, &best_cost);
+			#endif
+
+			archive_insert(args->archive, visited_nodes, best_cost, tour_hash(visited_nodes, args->tsp_in->num_nodes));
 		}
-	}
-	else
+	#endif
+
+	//the tour is copied only if it strictly improves the incumbent
+	incumbent_publish(args->best, visited_nodes, best_cost);
+
+	free(visited_nodes);
+	return NULL;
+}
+
+void multi_start_job(void* param)
+{
+	multi_start_params* params = (multi_start_params*)param;
+	thread_args args;
+
+	args.tsp_in = params->tsp_in;
+	args.best = params->best;
+	args.seed = STEP_SEED * (ATOMIC_ADD(&(params->next_seed), 1) + 1);
+	args.timer = params->timer;
+	args.archive = &(params->archive);
+
+	computeSolution((void*)&args);
+
+	#ifdef FIXED_TIME_MS
+		double remaining_time = time_left(params->timer);
+
+		if (remaining_time > 0)
+		{
+			pthread_mutex_lock(&mutex);
+			progress_post(&(params->source), ATOMIC_LOAD(&(params->next_seed)), incumbent_cost(params->best), 0.0, remaining_time);
+			pthread_mutex_unlock(&mutex);
+
+			pool_submit(params->pool, multi_start_job, param);
+		}
+	#endif
+}
+
+void gpx_merge(tsp_instance* tsp_in, incumbent* best, int* visited_nodes, double* best_cost)
+{
+	int n = tsp_in->num_nodes;
+	int* incumbent_nodes = (int*)calloc((size_t)n, sizeof(int));
+	int* offspring = (int*)calloc((size_t)n, sizeof(int));
+
+	//the first start has no incumbent to merge with
+	if (incumbent_load(best, incumbent_nodes) < DBL_MAX)
 	{
-		if (best_cost < args->tsp_in->bestCostD)
+		gpx_workspace gpx;
+		gpx_workspace_init(&gpx, n);
+
+		double cost;
+		if (gpx_crossover(tsp_in, &gpx, visited_nodes, incumbent_nodes, offspring, &cost) > 0 && cost < *best_cost - EPS)
 		{
-			args->tsp_in->bestCostD = best_cost;
-			update_solution(visited_nodes, args->tsp_in->sol, args->tsp_in->num_nodes);
-			succ_construction(visited_nodes, args->succ, args->tsp_in->num_nodes);
+			memcpy(visited_nodes, offspring, n * sizeof(int));
+			*best_cost = cost;
 		}
-	}
 
-	pthread_mutex_unlock(&mutex);
+		gpx_workspace_free(&gpx);
+	}
 
-	free(visited_nodes);
-	pthread_exit(NULL);
+	free(incumbent_nodes);
+	free(offspring);
 }
 
-void nearest_neighborhood(tsp_instance* tsp_in, int* visited_nodes, double* best_cost, int seed, int first_node) 
+void nearest_neighborhood(tsp_instance* tsp_in, int* visited_nodes, double* best_cost, rng_state* rng, int first_node) 
 {
 	int* nodes = (int*)calloc((size_t)tsp_in->num_nodes, sizeof(int));
 	//vettore di dim num nodes -> nodes needed to chek in min_cost
@@ -272,7 +421,7 @@ void nearest_neighborhood(tsp_instance* tsp_in, int* visited_nodes, double* best
 		int best = tsp_in->num_nodes;
 
 		
-		min_cost(tsp_in, nodes, i, &min_dist, &best, seed);
+		min_cost(tsp_in, nodes, i, &min_dist, &best, rng);
 
 		if (best == tsp_in->num_nodes)
 		{
@@ -300,7 +449,7 @@ void nearest_neighborhood(tsp_instance* tsp_in, int* visited_nodes, double* best
 	}
 }
 
-void insertion(tsp_instance* tsp_in, int* visited_nodes, double* best_cost, int seed, int first_node)
+void insertion(tsp_instance* tsp_in, int* visited_nodes, double* best_cost, rng_state* rng, int first_node)
 {
 	double max_dist = 0.0;
 	int indices[2];
@@ -382,7 +531,7 @@ void insertion(tsp_instance* tsp_in, int* visited_nodes, double* best_cost, int
 		double best_cost_h = DBL_MAX;
 		int k_best;
 
-		min_extra_mileage(tsp_in, count, visited_nodes, node1, node2, costs, &i_best, &k_best ,&best_cost_h, best_cost, seed);
+		min_extra_mileage(tsp_in, count, visited_nodes, node1, node2, costs, &i_best, &k_best ,&best_cost_h, best_cost, rng);
 
 		if (tsp_in->integerDist)
 		{
@@ -400,15 +549,10 @@ void insertion(tsp_instance* tsp_in, int* visited_nodes, double* best_cost, int
 	}
 }
 
-void min_cost(tsp_instance* tsp_in, int* nodes, int i, double* min_dist, int* best, int seed)
+void min_cost(tsp_instance* tsp_in, int* nodes, int i, double* min_dist, int* best, rng_state* rng)
 {
 #ifdef GRASP
 
-	if(!seed)
-		srand(time(NULL));
-	else
-		srand(seed);
-
 	double min[] = { DBL_MAX , DBL_MAX, DBL_MAX };
 	int min_pos[3];
 	min_pos[0] = tsp_in->num_nodes;
@@ -470,7 +614,7 @@ void min_cost(tsp_instance* tsp_in, int* nodes, int i, double* min_dist, int* be
 	else
 		max = 9;
 
-	int n = rand() % max;
+	int n = rng_int(rng, max);
 
 	if (n < 3 )
 	{
@@ -523,15 +667,10 @@ void min_cost(tsp_instance* tsp_in, int* nodes, int i, double* min_dist, int* be
 
 }
 
-void min_extra_mileage(tsp_instance* tsp_in, int count, int* visited_nodes, int* node1, int* node2, double* costs, int* i_best, int* k_best, double* best_cost_h, double* best_cost, int seed)
+void min_extra_mileage(tsp_instance* tsp_in, int count, int* visited_nodes, int* node1, int* node2, double* costs, int* i_best, int* k_best, double* best_cost_h, double* best_cost, rng_state* rng)
 {
 #ifdef GRASP
 
-	if (!seed)
-		srand(time(NULL));
-	else
-		srand(seed);
-
 	double min[] = { DBL_MAX , DBL_MAX, DBL_MAX };
 	int min_nodes[3];
 	int min_edges[3];
@@ -555,22 +694,7 @@ void min_extra_mileage(tsp_instance* tsp_in, int count, int* visited_nodes, int*
 
 		for (k = 0; k < count && !jump; k++)
 		{
-			double c;
-
-			if (tsp_in->integerDist)
-			{
-				int x1, x2;
-				dist(h, node1[k], tsp_in, &x1);
-				dist(h, node2[k], tsp_in, &x2);
-				c = (double)(x1 + x2) - costs[k];
-			}
-			else
-			{
-				double x1, x2;
-				dist(h, node1[k], tsp_in, &x1);
-				dist(h, node2[k], tsp_in, &x2);
-				c = x1 + x2 - costs[k];
-			}
+			double c = extra_mileage(tsp_in, h, node1[k], node2[k], costs[k]);
 
 			if (c < min_h)
 			{
@@ -617,7 +741,7 @@ void min_extra_mileage(tsp_instance* tsp_in, int count, int* visited_nodes, int*
 
 	if (count < tsp_in->num_nodes - 2)
 	{
-		int n = rand() % 9;
+		int n = rng_int(rng, 9);
 		if (n < 3)
 		{
 			(*best_cost_h) = min[0];
@@ -665,22 +789,7 @@ void min_extra_mileage(tsp_instance* tsp_in, int count, int* visited_nodes, int*
 
 		for (k = 0; k < count && !jump; k++)
 		{
-			double c;
-
-			if (tsp_in->integerDist)
-			{
-				int x1, x2;
-				dist(h, node1[k], tsp_in, &x1);
-				dist(h, node2[k], tsp_in, &x2);
-				c = (double)(x1 + x2) - costs[k];
-			}
-			else
-			{
-				double x1, x2;
-				dist(h, node1[k], tsp_in, &x1);
-				dist(h, node2[k], tsp_in, &x2);
-				c = x1 + x2 - costs[k];
-			}
+			double c = extra_mileage(tsp_in, h, node1[k], node2[k], costs[k]);
 
 			if (c < min_h)
 			{
@@ -735,6 +844,11 @@ void min_extra_mileage(tsp_instance* tsp_in, int count, int* visited_nodes, int*
 	s = 2;*/
 }
 
+double extra_mileage(tsp_instance* tsp_in, int node, int node1, int node2, double cost)
+{
+	return edge_cost(tsp_in, node, node1) + edge_cost(tsp_in, node, node2) - cost;
+}
+
 void greedy_refinement(tsp_instance* tsp_in, int* visited_nodes, double* best_cost)
 {
 	int* succ = calloc((size_t)tsp_in->num_nodes, sizeof(int));
@@ -837,14 +951,19 @@ void greedy_refinement(tsp_instance* tsp_in, int* visited_nodes, double* best_co
 	free(succ);
 }
 
-void hybrid_vns(tsp_instance* tsp_in, int* visited_nodes, double* best_cost, double deadline)
+void hybrid_vns(tsp_instance* tsp_in, int* visited_nodes, double* best_cost, double deadline, rng_state* rng)
 {
 	//static int count=0;
-	srand(time(NULL));
 
 	printf("COST: %.2lf\n\n", *best_cost);
+	deadline_timer timer;
+	timer_start(&timer, deadline);
 	double remaining_time = deadline;
 
+	progress_source source;
+	progress_source_init(&source);
+	long long num_iterations = 0;
+
 	int* local_min_visited_nodes = (int*)calloc((size_t)tsp_in->num_nodes, sizeof(int));
 
 	int i = 0;
@@ -854,6 +973,20 @@ void hybrid_vns(tsp_instance* tsp_in, int* visited_nodes, double* best_cost, dou
 	double local_min_cost = (*best_cost);
 	int max_k = ceil(tsp_in->num_nodes / 2);
 
+	//the k-opt moves of the same local minimum can give the same tour, which is refined only once
+	tour_archive archive;
+	archive_init(&archive, tsp_in->num_nodes, 0);
+
+	#ifdef WINDOW_REFINEMENT
+		//with MULTI_START the search is already a job of the pool of the starts, so the windows are refined in its thread
+		thread_pool* window_pool = NULL;
+		#ifndef MULTI_START
+			thread_pool pool;
+			pool_init(&pool, tsp_in->num_threads);
+			window_pool = &pool;
+		#endif
+	#endif
+
 	while (remaining_time > 0)
 	{
 		//printf("%d %.2lf\n", count, local_min_cost);
@@ -873,9 +1006,8 @@ void hybrid_vns(tsp_instance* tsp_in, int* visited_nodes, double* best_cost, dou
 		#endif 
 		
 		int k = 1;
-		for (; k <= max_k && remaining_time > 0; k++)
+		for (; k <= max_k && remaining_time > 0; k++, num_iterations++)
 		{
-			time_t start = clock();
 			int* kopt_visited_nodes = (int*) calloc((size_t)tsp_in->num_nodes, sizeof(int));
 			double kopt_cost = local_min_cost;
 
@@ -884,12 +1016,17 @@ void hybrid_vns(tsp_instance* tsp_in, int* visited_nodes, double* best_cost, dou
 				kopt_visited_nodes[i] = local_min_visited_nodes[i];
 			}
 
-			if (min_kopt_sequence(tsp_in, kopt_visited_nodes, &kopt_cost, k, inverse_costs, &inverse_costs_sum))
+			if (min_kopt_sequence(tsp_in, kopt_visited_nodes, &kopt_cost, k, inverse_costs, &inverse_costs_sum)
+				&& !archive_seen(&archive, tour_hash(kopt_visited_nodes, tsp_in->num_nodes)))
 			{
 				greedy_refinement(tsp_in, kopt_visited_nodes, &kopt_cost);
 				
 				if (kopt_cost < (*best_cost))
 				{
+					#ifdef WINDOW_REFINEMENT
+						window_refinement(tsp_in, kopt_visited_nodes, &kopt_cost, &timer, window_pool);
+					#endif
+
 					(*best_cost) = kopt_cost;
 					local_min_cost = kopt_cost;
 
@@ -899,11 +1036,10 @@ void hybrid_vns(tsp_instance* tsp_in, int* visited_nodes, double* best_cost, dou
 						local_min_visited_nodes[i] = kopt_visited_nodes[i];
 					}
 
-					time_t end = clock();
-					remaining_time = remaining_time - ((double)(end - start) / (double) CLOCKS_PER_SEC);
+					remaining_time = time_left(&timer);
 
 					#ifndef MULTI_START
-						printf("\r%sRemaining time : %s%.2lf  %.2lf ", CYAN, WHITE, remaining_time, *best_cost);	
+						progress_post(&source, num_iterations, *best_cost, (double)k, remaining_time);
 					#endif
 
 					free(kopt_visited_nodes);
@@ -911,18 +1047,16 @@ void hybrid_vns(tsp_instance* tsp_in, int* visited_nodes, double* best_cost, dou
 				}
 			}
 
-			time_t end = clock();
-			remaining_time = remaining_time - ((double)(end - start) / (double) CLOCKS_PER_SEC);
+			remaining_time = time_left(&timer);
 
 			#ifndef MULTI_START
-				printf("\r%sRemaining time : %s%.2lf  %.2lf ", CYAN, WHITE, remaining_time, *best_cost);
+				progress_post(&source, num_iterations, *best_cost, (double)k, remaining_time);
 			#endif
 			free(kopt_visited_nodes);
 		}
 
-		time_t start = clock();
 		if(remaining_time>0 && k > max_k)
-			new_random_sol(tsp_in, local_min_visited_nodes, &local_min_cost, inverse_costs, &inverse_costs_sum);
+			new_random_sol(tsp_in, local_min_visited_nodes, &local_min_cost, inverse_costs, &inverse_costs_sum, rng);
 
 		#ifndef UNIFORM_PROB
 			for (i = 0; i < max_k; i++)
@@ -931,14 +1065,20 @@ void hybrid_vns(tsp_instance* tsp_in, int* visited_nodes, double* best_cost, dou
 			free(inverse_costs);
 		#endif 
 
-		time_t end = clock();
-		remaining_time = remaining_time - ((double)(end - start) / (double)CLOCKS_PER_SEC);
+		remaining_time = time_left(&timer);
 		#ifndef MULTI_START
-			printf("\r%sRemaining time : %s%.2lf  %.2lf ", CYAN, WHITE, remaining_time, *best_cost);
+			progress_post(&source, num_iterations, *best_cost, (double)k, remaining_time);
 		#endif
 
 	}
-	printf("\n");
+
+	#ifdef WINDOW_REFINEMENT
+		#ifndef MULTI_START
+			pool_destroy(&pool);
+		#endif
+	#endif
+
+	archive_free(&archive);
 	free(local_min_visited_nodes);
 }
 
@@ -1026,7 +1166,7 @@ int min_kopt_sequence(tsp_instance* tsp_in, int* kopt_visited_nodes, double* kop
 	return 0;
 }
 
-int new_random_sol(tsp_instance* tsp_in, int* local_min_visited_nodes, double* local_cost, double** inverse_costs, double* inverse_costs_sum)
+int new_random_sol(tsp_instance* tsp_in, int* local_min_visited_nodes, double* local_cost, double** inverse_costs, double* inverse_costs_sum, rng_state* rng)
 {
 	int first;
 	int k;
@@ -1044,7 +1184,7 @@ int new_random_sol(tsp_instance* tsp_in, int* local_min_visited_nodes, double* l
 			int j = 0;
 			for (; j < tsp_in->num_nodes; j++)
 			{
-				double choice = (double)(rand() % ((int)(((*inverse_costs_sum) / inverse_costs[i][j]) * 1000.0)));
+				double choice = (double)rng_int(rng, (int)(((*inverse_costs_sum) / inverse_costs[i][j]) * 1000.0));
 
 				if (choice < 1000.0)
 				{
@@ -1057,10 +1197,10 @@ int new_random_sol(tsp_instance* tsp_in, int* local_min_visited_nodes, double* l
 			}
 		}
 	#else
-		first = rand() % tsp_in->num_nodes;
+		first = rng_int(rng, tsp_in->num_nodes);
 
 		//k = ( rand() % (int)  ceil((tsp_in->num_nodes / 2)) ) + 1 ;
-		k = rand() % (tsp_in->num_nodes - 2);
+		k = rng_int(rng, tsp_in->num_nodes - 2);
 		second = (first + k) % tsp_in->num_nodes;
 	#endif
 
@@ -1142,12 +1282,15 @@ void succ_construction(int* visited_nodes, int* succ, int num_nodes)//needed suc
 
 void tabu_search(tsp_instance* tsp_in, int* visited_nodes, double* best_cost, double deadline)
 {
-	time_t start = clock();
-	double remaining_time = deadline;
+	deadline_timer timer;
+	timer_start(&timer, deadline);
 
 	int* succ = (int*)calloc((size_t)tsp_in->num_nodes, sizeof(int));
 	succ_construction(visited_nodes, succ, tsp_in->num_nodes);
 
+	progress_source source;
+	progress_source_init(&source);
+
 	#ifndef MULTI_START
 	if (tsp_in->verbose > 50)	
 		printf("%sStarting cost :%s%.2lf\n",RED, WHITE, *best_cost);
@@ -1173,14 +1316,11 @@ void tabu_search(tsp_instance* tsp_in, int* visited_nodes, double* best_cost, do
 
 	int num_tabu_edges = 0;
 	double actual_cost = *best_cost;
-
-	time_t end = clock();
-	remaining_time = remaining_time - ((double)(end - start) / CLOCKS_PER_SEC);
+	double remaining_time = time_left(&timer);
 
 	int num_iteration = 0;
 	for (; remaining_time > 0; num_iteration++)
 	{
-		start = clock();
 
 		double min_increase = DBL_MAX;
 
@@ -1192,31 +1332,10 @@ void tabu_search(tsp_instance* tsp_in, int* visited_nodes, double* best_cost, do
 		actual_cost = actual_cost + min_increase;
 
 		if (min_increase < 0.0 )
-		{
 			greedy_refinement_for_tabu_search(tsp_in, succ, tabu_list, &param, max_tenure, min_tenure, &num_tabu_edges, &actual_cost);
 
-			#ifndef MULTI_START
-			if (tsp_in->verbose > 50)
-			{
-				printf("\r%sfind local minimum: %s%.2lf",GREEN, WHITE, actual_cost);
-			}
-			#endif 
-
-		}
-		else
-		{
-			
-			#ifndef MULTI_START
-			if (tsp_in->verbose > 50)
-				printf("\r%sUpdate cost :%s %.2lf      ", BLUE, WHITE, actual_cost);
-			#endif
-			
-		}
-
 		if (actual_cost < *best_cost)
 		{
-			*best_cost = actual_cost;
-			
 			int j = 0;
 			int next = j;
 			for (; j < tsp_in->num_nodes; j++)
@@ -1224,19 +1343,24 @@ void tabu_search(tsp_instance* tsp_in, int* visited_nodes, double* best_cost, do
 				visited_nodes[j] = next;
 				next = succ[next];
 			}
+
+			#ifdef WINDOW_REFINEMENT
+				//the search goes on from the refined tour, with the same tabu list
+				window_refinement(tsp_in, visited_nodes, &actual_cost, &timer, NULL);
+				succ_construction(visited_nodes, succ, tsp_in->num_nodes);
+			#endif
+
+			*best_cost = actual_cost;
 		}
 
-		end = clock();
-		remaining_time = remaining_time - ((double)(end - start) / CLOCKS_PER_SEC);
+		remaining_time = time_left(&timer);
 
 		#ifndef MULTI_START
-			printf("%sRemaining time : %s%.2lf", CYAN, WHITE, remaining_time);
+			progress_post(&source, num_iteration, *best_cost, actual_cost, remaining_time);
 		#endif 
 
 	}
 
-	printf("\n");
-
 	free(succ);
 	free(tabu_list[0]);
 	free(tabu_list[1]);
@@ -1522,248 +1646,857 @@ void greedy_refinement_for_tabu_search(tsp_instance* tsp_in, int* succ, int** ta
 }
 
 
-void simulated_annealing(tsp_instance* tsp_in, int* visited_nodes, double* best_cost, double deadline)
+void parallel_tabu_search(tsp_instance* tsp_in, int* visited_nodes, double* best_cost, double deadline, rng_state* rng)
 {
-	//static int count_cost = 0;
+	deadline_timer timer;
+	timer_start(&timer, deadline);
+	int num_threads = tsp_in->num_threads;
 
-	#ifndef MULTI_START
-	//printf("%d %.2lf\n", count_cost, *best_cost);
-	//count_cost++;
-	printf("%sStarting cost:%s %.2lf\n", RED, WHITE, *best_cost);
-	#endif 
+	tour_archive archive;
+	archive_init(&archive, tsp_in->num_nodes, ELITE_POOL_SIZE);
+	archive_insert(&archive, visited_nodes, *best_cost, tour_hash(visited_nodes, tsp_in->num_nodes));
 
-	int outer_iteration;
-	double remaining_time = deadline;
-	double alpha = 0.99;
-	double t_min = 100.0; 
-	double t_max = 5000.0;
-	double t = t_max ;
-	double x = 2.3; // 10 = e^x
-	double r = 0.0;
+	int i;
 
-	int* new_visited_nodes = (int*)calloc((size_t)tsp_in->num_nodes, sizeof(int));
+	#ifndef MULTI_START
+	if (tsp_in->verbose > 50)
+		printf("%sStarting cost :%s%.2lf     %sWorkers :%s %d\n", RED, WHITE, *best_cost, RED, WHITE, num_threads);
+	#endif
 
-	int k;
-	for (k = 0; k < tsp_in->num_nodes; k++)
-		new_visited_nodes[k] = visited_nodes[k];
+	pthread_t* threads = (pthread_t*)calloc((size_t)num_threads, sizeof(pthread_t));
+	tabu_worker_args* param = (tabu_worker_args*)calloc((size_t)num_threads, sizeof(tabu_worker_args));
 
-	double cost = *best_cost;
-	
-	//formula for the decrease of the temperature: t = (alpha)^i * t_start + t_min
+	//the workers use independent streams of a seed drawn from the generator of the thread
+	uint64_t seed = rng_next(rng);
 
-	for (outer_iteration = 0; remaining_time > 0.0 ; outer_iteration++)
+	for (i = 0; i < num_threads; i++)
 	{
-		int i;
-		int increase_accepted = 0;
+		//tenure of the workers goes from 0.5 to 1.5 times the one of the sequential tabu search
+		double factor = 0.5 + ((double)i) / ((double)num_threads);
 
-#ifndef MULTI_START
+		param[i].tsp_in = tsp_in;
+		param[i].archive = &archive;
+		param[i].id = i;
+		rng_stream(&(param[i].rng), seed, (uint64_t)(i + 1));
+		param[i].min_tenure = (int)ceil(factor * tsp_in->num_nodes / 10.0);
+		param[i].max_tenure = (int)ceil(factor * tsp_in->num_nodes / 5.0);
+		param[i].timer = &timer;
+		param[i].num_restarts = 0;
+		progress_source_init(&(param[i].source));
+		param[i].cost = *best_cost;
+		param[i].visited_nodes = (int*)calloc((size_t)tsp_in->num_nodes, sizeof(int));
+		memcpy(param[i].visited_nodes, visited_nodes, tsp_in->num_nodes * sizeof(int));
+
+		if (param[i].min_tenure < 2)
+			param[i].min_tenure = 2;
+
+		if (param[i].max_tenure < param[i].min_tenure + 2)
+			param[i].max_tenure = param[i].min_tenure + 2;
+
+		pthread_create(&threads[i], NULL, tabu_worker, (void*)&param[i]);
+	}
 
-		printf("\r%sT :%s %.2lf  %sRemaining_time :%s %.2lf ", BLUE, WHITE, t, CYAN, WHITE, remaining_time);
+	for (i = 0; i < num_threads; i++)
+	{
+		int rc = pthread_join(threads[i], NULL);
 
-#endif 
+		if (rc)
+			exit(-1);
 
-		for (i=0; !increase_accepted; i++)
+		if (param[i].cost < *best_cost)
 		{
-			#ifndef MULTI_START
-				printf("\r%sT :%s %.2lf  %sRemaining_time :%s %.2lf ", BLUE, WHITE, t, CYAN, WHITE, remaining_time);
-			#endif 
+			*best_cost = param[i].cost;
+			memcpy(visited_nodes, param[i].visited_nodes, tsp_in->num_nodes * sizeof(int));
+		}
+	}
 
-			srand( (outer_iteration+1) * (i+1) * 100);
+	#ifndef MULTI_START
+	//the status line is closed before the statistics of the workers
+	progress_stop();
+	#endif
 
-			time_t start_inner_iteration = clock();
+	for (i = 0; i < num_threads; i++)
+	{
+		#ifndef MULTI_START
+		if (tsp_in->verbose > 50)
+			printf("%s[Worker %2d]%s tenure: %4d - %4d     restarts: %5d     cost: %.2lf\n",
+				BLUE, i, WHITE, param[i].min_tenure, param[i].max_tenure, param[i].num_restarts, param[i].cost);
+		#endif
 
-			double choice =(double) (rand() % 100);
-			double range = 100.0 / tsp_in->num_nodes;
-			int j;
-			for (j = 0; j < tsp_in->num_nodes; j++)
-			{
-				if (choice < ((j+1) * range) )
-					break;
-			}
+		free(param[i].visited_nodes);
+	}
 
-			int index_node1 = -1;
-			if (j != tsp_in->num_nodes)
-				index_node1 = j;
-			else
-				printf("ERROR\n");
+	archive_free(&archive);
+	free(threads);
+	free(param);
+}
 
-			int value = rand() % 100;
-			int offset = (value < 50) ?	1 : 2;
+void* tabu_worker(void* param)
+{
+	tabu_worker_args* args = (tabu_worker_args*)param;
+	tsp_instance* tsp_in = args->tsp_in;
 
-			int  index_node2 = (index_node1 + offset) %tsp_in->num_nodes;
+	//best tour since the last restart of the worker
+	int* visited_nodes = (int*)calloc((size_t)tsp_in->num_nodes, sizeof(int));
+	memcpy(visited_nodes, args->visited_nodes, tsp_in->num_nodes * sizeof(int));
+	double actual_cost = args->cost;
 
-			//printf("\033[0;34m index_node1 = %d     index_node2=%d\n", index_node1, index_node2);
-			//printf("\033[0m");
+	//the first worker starts from the constructed tour, the others from a diversification of it
+	if (args->id > 0)
+	{
+		double_bridge_kick(tsp_in, visited_nodes, &actual_cost, &(args->rng));
+		greedy_refinement(tsp_in, visited_nodes, &actual_cost);
+	}
 
-			double new_cost = 0.0;
-		
-			double delta = 0.0;
-			if (tsp_in->integerDist)
-			{
-				int  x1_new, x2_new, x1_old, x2_old;
-				dist(new_visited_nodes[(index_node1 - 1 + tsp_in->num_nodes)% tsp_in->num_nodes], new_visited_nodes[index_node2], tsp_in, &x1_new);
-				dist(new_visited_nodes[index_node1], new_visited_nodes[(index_node2  + 1) % tsp_in->num_nodes], tsp_in, &x2_new);
-				dist(new_visited_nodes[(index_node1 - 1 + tsp_in->num_nodes) % tsp_in->num_nodes], new_visited_nodes[index_node1], tsp_in, &x1_old);
-				dist(new_visited_nodes[index_node2], new_visited_nodes[(index_node2 + 1)% tsp_in->num_nodes], tsp_in, &x2_old);
-				delta = (double)(x1_new + x2_new - x1_old - x2_old);
-			}
-			else
-			{
-				double  x1_new, x2_new, x1_old, x2_old;
-				dist(new_visited_nodes[(index_node1 - 1 + tsp_in->num_nodes) % tsp_in->num_nodes], new_visited_nodes[index_node2], tsp_in, &x1_new);
-				dist(new_visited_nodes[index_node1], new_visited_nodes[(index_node2 + 1) % tsp_in->num_nodes], tsp_in, &x2_new);
-				dist(new_visited_nodes[(index_node1 - 1 + tsp_in->num_nodes) % tsp_in->num_nodes], new_visited_nodes[index_node1], tsp_in, &x1_old);
-				dist(new_visited_nodes[index_node2], new_visited_nodes[(index_node2 + 1) % tsp_in->num_nodes], tsp_in, &x2_old);
-				delta = x1_new + x2_new - x1_old - x2_old;
-			}
+	double local_best_cost = actual_cost;
 
-			new_cost = cost + delta;
+	int* succ = (int*)calloc((size_t)tsp_in->num_nodes, sizeof(int));
+	succ_construction(visited_nodes, succ, tsp_in->num_nodes);
 
-			//printf("new cost : %lf <<<<<<<<<<< delta %lf >>>>>>>>> best cost : %lf\n", new_cost,delta, *best_cost);
+	int** tabu_list = (int**)calloc((size_t)2, sizeof(int*));
+	tabu_list[0] = (int*)calloc((size_t)args->max_tenure, sizeof(int));
+	tabu_list[1] = (int*)calloc((size_t)args->max_tenure, sizeof(int));
 
-			if (new_cost < cost)
-			{
-				/*
-				printf("\033[1;32m Improvement  cost: %lf\n", new_cost);
-				printf("node1: visited_nodes[%d]=%d     node2: visited_nodes[%d] = %d\n",
-					index_node1, new_visited_nodes[index_node1], index_node2, new_visited_nodes[index_node2]);
-				printf("\033[0m");
-				*/
+	tabu_list_params list_param;
+	list_param.end_list = -1;
+	list_param.start_list = 0;
 
-				#ifndef MULTI_START
-				printf("				%simprovement cost:%s %.2lf", GREEN, WHITE, new_cost);
-				//printf("%d %.2lf\n", count, new_cost);
-				#endif 
+	int i;
+	for (i = 0; i < args->max_tenure; i++)
+	{
+		tabu_list[0][i] = -1;
+		tabu_list[1][i] = -1;
+	}
 
-				int temp = new_visited_nodes[index_node1];
-				new_visited_nodes[index_node1] = new_visited_nodes[index_node2];
-				new_visited_nodes[index_node2] = temp;
+	int num_tabu_edges = 0;
+	int no_improvement = 0;
+	long long num_iterations = 0;
 
-				cost = new_cost;
+	while (time_left(args->timer) > 0)
+	{
+		num_iterations++;
 
-				greedy_refinement(tsp_in, new_visited_nodes, &cost);
+		double min_increase = move2opt_for_tabu_search(tsp_in, succ, tabu_list, &(args->max_tenure), &list_param);
 
-				/*
-				if (count_cost <= 1000)
-				{
-					//printf("%d; %.2lf\n", count_cost, cost);
-					count_cost++;
-				}
-				*/
+		if (num_tabu_edges < args->max_tenure)
+			num_tabu_edges = num_tabu_edges + 2;
 
-				if (cost < *best_cost)
-				{
-					int h;
-					for (h = 0; h < tsp_in->num_nodes; h++)
-						visited_nodes[h] = new_visited_nodes[h];
+		actual_cost = actual_cost + min_increase;
 
-					*best_cost = cost;
-				}
-				
-			}
-			else if (new_cost > cost)
-			{
-				int accept = 0;
-				
-				double expo = (new_cost - cost) / t; 
-				int magnitude =(int) floor(expo / x); 
-				double coeff = exp(expo - magnitude * x);
+		if (min_increase < 0.0)
+			greedy_refinement_for_tabu_search(tsp_in, succ, tabu_list, &list_param, args->max_tenure, args->min_tenure, &num_tabu_edges, &actual_cost);
 
-				int k;
-				int count = 0;
-				for (k = 0; k < magnitude; k++)
-				{
-					int r = rand() % 100;
-					if (r < 10)
-						count++;
-				}
-				if (count == magnitude)
-				{
-					int max_range = (int) (10 * coeff);
-					
-					int r = rand() % max_range;
-					if (r < 10)
-						accept = 1;
-				}
-				//printf("\033[1;36m magnitude = %d    coeff = %lf \n", magnitude, coeff);
-				//printf("\033[0m");
-				
-				if (accept)
-				{
-					/*
-					printf("\033[1;31m Accepted  new solution       cost: %lf\n",new_cost);
-					printf("node1: visited_nodes[%d]=%d     node2: visited_nodes[%d] = %d\n",
-						index_node1, new_visited_nodes[index_node1], index_node2, new_visited_nodes[index_node2]);
-					printf("\033[0m");
-					*/ 
+		if (actual_cost < local_best_cost - EPS)
+		{
+			local_best_cost = actual_cost;
+			no_improvement = 0;
 
-					int temp = new_visited_nodes[index_node1];
-					new_visited_nodes[index_node1] = new_visited_nodes[index_node2];
-					new_visited_nodes[index_node2] = temp;
+			int j = 0;
+			int next = j;
+			for (; j < tsp_in->num_nodes; j++)
+			{
+				visited_nodes[j] = next;
+				next = succ[next];
+			}
 
-					cost = new_cost;
+			if (actual_cost < args->cost)
+			{
+				args->cost = actual_cost;
+				memcpy(args->visited_nodes, visited_nodes, tsp_in->num_nodes * sizeof(int));
+			}
+		}
+		else
+			no_improvement++;
 
-					#ifndef MULTI_START
-					printf("%snew worst cost:%s   %.2lf", BLUE, WHITE, new_cost);
-					/*if (count_cost <= 1000)
-					{
-						printf("%d; %.2lf\n", count_cost, cost);
-						count_cost++;
-					}
-					*/
-					#endif
+		if (no_improvement == STAGNATION_ITERATIONS)
+		{
+			//share the local optimum and restart from a diversified elite tour, with an empty tabu list
+			archive_insert(args->archive, visited_nodes, local_best_cost, tour_hash(visited_nodes, tsp_in->num_nodes));
+			archive_restart(tsp_in, args->archive, visited_nodes, &actual_cost, &(args->rng));
+			greedy_refinement(tsp_in, visited_nodes, &actual_cost);
+			succ_construction(visited_nodes, succ, tsp_in->num_nodes);
 
-					increase_accepted = 1;
-				}
+			for (i = 0; i < args->max_tenure; i++)
+			{
+				tabu_list[0][i] = -1;
+				tabu_list[1][i] = -1;
+			}
+
+			list_param.end_list = -1;
+			list_param.start_list = 0;
+			num_tabu_edges = 0;
+			no_improvement = 0;
+			local_best_cost = actual_cost;
+			(args->num_restarts)++;
+		}
+
+		#ifndef MULTI_START
+			//the samples are throttled by the source, so a new best of the worker is posted within PROGRESS_POST_MS
+			progress_post(&(args->source), num_iterations, args->cost, actual_cost, time_left(args->timer));
+		#endif
+	}
+
+	archive_insert(args->archive, args->visited_nodes, args->cost, tour_hash(args->visited_nodes, tsp_in->num_nodes));
+
+	free(visited_nodes);
+	free(succ);
+	free(tabu_list[0]);
+	free(tabu_list[1]);
+	free(tabu_list);
+
+	pthread_exit(NULL);
+}
+
+int archive_restart(tsp_instance* tsp_in, tour_archive* archive, int* visited_nodes, double* cost, rng_state* rng)
+{
+	int i;
+	for (i = 0; i < MAX_RESTART_KICKS; i++)
+	{
+		if (!archive_pull(archive, visited_nodes, cost, rng))
+			return 0;
+
+		double_bridge_kick(tsp_in, visited_nodes, cost, rng);
+
+		if (!archive_seen(archive, tour_hash(visited_nodes, tsp_in->num_nodes)))
+			break;
+	}
+
+	return 1;
+}
+
+double tour_cost(tsp_instance* tsp_in, int* visited_nodes)
+{
+	double cost = 0.0;
+
+	int i;
+	for (i = 0; i < tsp_in->num_nodes; i++)
+		cost += edge_cost(tsp_in, visited_nodes[i], visited_nodes[(i + 1) % tsp_in->num_nodes]);
+
+	return cost;
+}
+
+void double_bridge_kick(tsp_instance* tsp_in, int* visited_nodes, double* cost, rng_state* rng)
+{
+	int n = tsp_in->num_nodes;
+
+	if (n < 8)
+		return;
+
+	//cut positions 0 < p1 < p2 < p3 < n, that define segments A=[0,p1) B=[p1,p2) C=[p2,p3) D=[p3,n)
+	int p1 = 1 + rng_int(rng, n - 3);
+	int p2 = p1 + 1 + rng_int(rng, n - p1 - 2);
+	int p3 = p2 + 1 + rng_int(rng, n - p2 - 1);
+
+	(*cost) += edge_cost(tsp_in, visited_nodes[p1 - 1], visited_nodes[p2])
+		+ edge_cost(tsp_in, visited_nodes[p3 - 1], visited_nodes[p1])
+		+ edge_cost(tsp_in, visited_nodes[p2 - 1], visited_nodes[p3])
+		- edge_cost(tsp_in, visited_nodes[p1 - 1], visited_nodes[p1])
+		- edge_cost(tsp_in, visited_nodes[p2 - 1], visited_nodes[p2])
+		- edge_cost(tsp_in, visited_nodes[p3 - 1], visited_nodes[p3]);
+
+	int* segment = (int*)calloc((size_t)(p3 - p1), sizeof(int));
+	memcpy(segment, visited_nodes + p2, (p3 - p2) * sizeof(int));
+	memcpy(segment + (p3 - p2), visited_nodes + p1, (p2 - p1) * sizeof(int));
+	memcpy(visited_nodes + p1, segment, (p3 - p1) * sizeof(int));
+
+	free(segment);
+}
+
+void simulated_annealing(tsp_instance* tsp_in, int* visited_nodes, double* best_cost, double deadline, rng_state* rng)
+{
+	//the construction and the greedy refinement can use all the time, and the schedule is a fraction of the deadline
+	if (deadline <= 0.0)
+		return;
+
+	deadline_timer timer;
+	timer_start(&timer, deadline);
+
+	#ifndef MULTI_START
+	printf("%sStarting cost:%s %.2lf\n", RED, WHITE, *best_cost);
+	#endif 
+
+	int n = tsp_in->num_nodes;
+
+	candidate_list cand;
+	build_candidate_list(tsp_in, &cand, NUM_CANDIDATES);
+
+	double* exp_table = (double*)calloc((size_t)EXP_TABLE_SIZE, sizeof(double));
+	build_exp_table(exp_table);
+
+	sa_chain chain;
+	sa_chain_init(&chain, visited_nodes, *best_cost, n, rng_next(rng));
+
+	double t_start, t_end;
+	sa_calibrate(tsp_in, &cand, &chain, &t_start, &t_end);
+
+	//the temperature depends on the elapsed fraction f of the deadline: t = t_high * (t_end / t_high)^((f - f_origin) / (1 - f_origin)),
+	//so the chain is always cold at the deadline; a reheat moves (f_origin, t_high) to the actual fraction and a hotter temperature
+	double t_high = t_start;
+	double f_origin = 0.0;
+	double t = t_start;
+
+	progress_source source;
+	progress_source_init(&source);
+
+	double f = timer_elapsed(&timer) / deadline;
+	double f_improvement = f;
+	double last_best_cost = chain.best_cost;
+	int num_reheats = 0;
+
+	//time_left also stops the chain when the deadlines are expired by the lower bound
+	while (time_left(&timer) > 0.0)
+	{
+		//the fraction and time_left read the clock at different instants
+		if (f < 0.0)
+			f = 0.0;
+		else if (f > 1.0 - EPS)
+			f = 1.0 - EPS;
+
+		t = t_high * pow(t_end / t_high, (f - f_origin) / (1.0 - f_origin));
+		sa_chain_run(tsp_in, &cand, exp_table, &chain, 1.0 / t, SA_TIME_CHECK);
+
+		f = timer_elapsed(&timer) / deadline;
+
+		#ifndef MULTI_START
+		progress_post(&source, chain.num_moves, chain.best_cost, t, time_left(&timer));
+		#endif
+
+		if (chain.best_cost < last_best_cost - EPS)
+		{
+			last_best_cost = chain.best_cost;
+			f_improvement = f;
+		}
+		else if (f - f_improvement > SA_STAGNATION && f < SA_REHEAT_LIMIT)
+		{
+			//reheat to the geometric mean between the starting and the actual temperature
+			t_high = sqrt(t_start * t);
+			f_origin = f;
+			f_improvement = f;
+			num_reheats++;
+		}
+	}
+
+	sa_chain_best(tsp_in, &chain);
+	memcpy(visited_nodes, chain.best_tour, n * sizeof(int));
+	*best_cost = chain.best_cost;
+
+	#ifndef MULTI_START
+	//the status line is closed before the statistics of the annealing
+	progress_stop();
+	if (tsp_in->verbose > 50)
+	{
+		printf("%sT start :%s %.2lf  %sT end :%s %.4lf  %sreheats :%s %d\n", BLUE, WHITE, t_start, BLUE, WHITE, t_end, BLUE, WHITE, num_reheats);
+		printf("%sMoves :%s %lld  %saccepted :%s %lld  %smoves/s :%s %.0lf\n", BLUE, WHITE, chain.num_moves, BLUE, WHITE, chain.num_accepted,
+			BLUE, WHITE, chain.num_moves / (timer_elapsed(&timer) + 1e-9));
+	}
+	#endif
+
+	sa_chain_free(&chain);
+	free(exp_table);
+	free_candidate_list(&cand);
+}
+
+void parallel_tempering(tsp_instance* tsp_in, int* visited_nodes, double* best_cost, double deadline, rng_state* rng)
+{
+	tempering_params pt;
+	timer_start(&(pt.timer), deadline);
+	pt.tsp_in = tsp_in;
+	pt.num_replicas = tsp_in->num_threads;
+	pt.round = 0;
+	pt.num_attempts = 0;
+	pt.num_swaps = 0;
+	pt.stop = 0;
+
+	#ifndef MULTI_START
+	printf("%sStarting cost:%s %.2lf     %sReplicas:%s %d\n", RED, WHITE, *best_cost, RED, WHITE, pt.num_replicas);
+	#endif
+
+	int n = tsp_in->num_nodes;
+
+	candidate_list cand;
+	build_candidate_list(tsp_in, &cand, NUM_CANDIDATES);
+	pt.cand = &cand;
+
+	pt.exp_table = (double*)calloc((size_t)EXP_TABLE_SIZE, sizeof(double));
+	build_exp_table(pt.exp_table);
+
+	pt.inverse_t = (double*)calloc((size_t)pt.num_replicas, sizeof(double));
+	pt.replica = (int*)calloc((size_t)pt.num_replicas, sizeof(int));
+	pt.temperature = (int*)calloc((size_t)pt.num_replicas, sizeof(int));
+	pt.costs = (double*)calloc((size_t)pt.num_replicas, sizeof(double));
+	pt.best_costs = (double*)calloc((size_t)pt.num_replicas, sizeof(double));
+	pt.best_cost = *best_cost;
+	progress_source_init(&(pt.source));
+	//the generators of the exchanges and of the replicas are seeded by the generator of the thread
+	rng_seed(&(pt.rng), rng_next(rng));
+	pthread_barrier_init(&(pt.barrier), NULL, (unsigned)pt.num_replicas);
+
+	pthread_t* threads = (pthread_t*)calloc((size_t)pt.num_replicas, sizeof(pthread_t));
+	replica_args* param = (replica_args*)calloc((size_t)pt.num_replicas, sizeof(replica_args));
+
+	int i;
+	for (i = 0; i < pt.num_replicas; i++)
+	{
+		param[i].params = &pt;
+		param[i].id = i;
+		sa_chain_init(&(param[i].chain), visited_nodes, *best_cost, n, rng_next(rng));
+	}
+
+	double t_start, t_end;
+	sa_calibrate(tsp_in, &cand, &(param[0].chain), &t_start, &t_end);
+
+	for (i = 0; i < pt.num_replicas; i++)
+	{
+		//geometric ladder of temperatures from t_end to t_start
+		double t = t_end;
+		if (pt.num_replicas > 1)
+			t = t_end * pow(t_start / t_end, ((double)i) / (pt.num_replicas - 1));
+
+		pt.inverse_t[i] = 1.0 / t;
+		pt.replica[i] = i;
+		pt.temperature[i] = i;
+		pt.costs[i] = *best_cost;
+		pt.best_costs[i] = *best_cost;
+	}
+
+	for (i = 0; i < pt.num_replicas; i++)
+		pthread_create(&threads[i], NULL, tempering_replica, (void*)&param[i]);
+
+	for (i = 0; i < pt.num_replicas; i++)
+	{
+		int rc = pthread_join(threads[i], NULL);
+
+		if (rc)
+			exit(-1);
+
+		if (param[i].chain.best_cost < *best_cost)
+		{
+			*best_cost = param[i].chain.best_cost;
+			memcpy(visited_nodes, param[i].chain.best_tour, n * sizeof(int));
+		}
+	}
+
+	#ifndef MULTI_START
+	//the status line is closed before the statistics of the replicas
+	progress_stop();
+	#endif
+
+	for (i = 0; i < pt.num_replicas; i++)
+	{
+		#ifndef MULTI_START
+		if (tsp_in->verbose > 50)
+			printf("%s[Replica %2d]%s T: %8.2lf     moves: %12lld     accepted: %10lld     cost: %.2lf\n", BLUE, i, WHITE,
+				1.0 / pt.inverse_t[pt.temperature[i]], param[i].chain.num_moves, param[i].chain.num_accepted, param[i].chain.best_cost);
+		#endif
+
+		sa_chain_free(&(param[i].chain));
+	}
+
+	#ifndef MULTI_START
+	if (tsp_in->verbose > 50)
+		printf("%sExchanges :%s %d / %d\n", BLUE, WHITE, pt.num_swaps, pt.num_attempts);
+	#endif
+
+	pthread_barrier_destroy(&(pt.barrier));
+	free(threads);
+	free(param);
+	free(pt.inverse_t);
+	free(pt.replica);
+	free(pt.temperature);
+	free(pt.costs);
+	free(pt.best_costs);
+	free(pt.exp_table);
+	free_candidate_list(&cand);
+}
+
+void* tempering_replica(void* param)
+{
+	replica_args* args = (replica_args*)param;
+	tempering_params* pt = args->params;
+
+	while (!pt->stop)
+	{
+		sa_chain_run(pt->tsp_in, pt->cand, pt->exp_table, &(args->chain), pt->inverse_t[pt->temperature[args->id]], PT_SWAP_INTERVAL);
+		pt->costs[args->id] = args->chain.cost;
+		pt->best_costs[args->id] = args->chain.best_cost;
+
+		//one thread does the exchanges, while the others wait on the second barrier
+		if (pthread_barrier_wait(&(pt->barrier)) == PTHREAD_BARRIER_SERIAL_THREAD)
+			tempering_exchange(pt);
+
+		pthread_barrier_wait(&(pt->barrier));
+	}
+
+	sa_chain_best(pt->tsp_in, &(args->chain));
+
+	pthread_exit(NULL);
+}
+
+void tempering_exchange(tempering_params* pt)
+{
+	int k;
+	for (k = pt->round % 2; k + 1 < pt->num_replicas; k += 2)
+	{
+		int cold = pt->replica[k];
+		int hot = pt->replica[k + 1];
+
+		//acceptance probability min(1, exp((1/t_k - 1/t_k+1) * (cost_cold - cost_hot)))
+		double x = (pt->inverse_t[k] - pt->inverse_t[k + 1]) * (pt->costs[cold] - pt->costs[hot]);
+		pt->num_attempts++;
+
+		if (x >= 0.0 || rng_double(&(pt->rng)) < exp(x))
+		{
+			pt->replica[k] = hot;
+			pt->replica[k + 1] = cold;
+			pt->temperature[hot] = k;
+			pt->temperature[cold] = k + 1;
+			pt->num_swaps++;
+		}
+	}
+
+	pt->round++;
+
+	int r;
+	for (r = 0; r < pt->num_replicas; r++)
+	{
+		if (pt->best_costs[r] < pt->best_cost)
+			pt->best_cost = pt->best_costs[r];
+	}
+
+	#ifndef MULTI_START
+		//the samples are throttled by the source, so a new best of the replicas is posted within PROGRESS_POST_MS
+		progress_post(&(pt->source), pt->round, pt->best_cost, pt->costs[pt->replica[0]], time_left(&(pt->timer)));
+	#endif
 
+	if (time_left(&(pt->timer)) <= 0)
+		pt->stop = 1;
+}
+
+void sa_calibrate(tsp_instance* tsp_in, candidate_list* cand, sa_chain* chain, double* t_start, double* t_end)
+{
+	double sum = 0.0;
+	double min_delta = DBL_MAX;
+	int count = 0;
+
+	int m;
+	for (m = 0; m < SA_CALIBRATION_MOVES; m++)
+	{
+		sa_move move;
+		double delta = sa_random_move(tsp_in, cand, &(chain->rng), chain->tour, chain->pos, &move);
+
+		if (delta > EPS && delta < DBL_MAX)
+		{
+			sum += delta;
+			count++;
+			if (delta < min_delta)
+				min_delta = delta;
+		}
+	}
+
+	//if no uphill move is sampled, the average edge of the tour is used as average uphill move
+	double mean = (count > 0) ? sum / count : chain->cost / tsp_in->num_nodes;
+	if (count == 0)
+		min_delta = mean;
+
+	//the average uphill move is accepted with probability SA_START_ACCEPTANCE at the start,
+	//the smallest one with probability SA_END_ACCEPTANCE at the end
+	*t_start = -mean / log(SA_START_ACCEPTANCE);
+	*t_end = -min_delta / log(SA_END_ACCEPTANCE);
+	if (*t_end > *t_start)
+		*t_end = *t_start;
+}
+
+void sa_chain_init(sa_chain* chain, int* visited_nodes, double cost, int num_nodes, uint64_t seed)
+{
+	chain->tour = (int*)calloc((size_t)num_nodes, sizeof(int));
+	chain->pos = (int*)calloc((size_t)num_nodes, sizeof(int));
+	chain->best_tour = (int*)calloc((size_t)num_nodes, sizeof(int));
+
+	int k;
+	for (k = 0; k < num_nodes; k++)
+	{
+		chain->tour[k] = visited_nodes[k];
+		chain->best_tour[k] = visited_nodes[k];
+		chain->pos[visited_nodes[k]] = k;
+	}
+
+	chain->cost = cost;
+	chain->best_cost = cost;
+	chain->best_is_current = 1;
+	chain->num_moves = 0;
+	chain->num_accepted = 0;
+	rng_seed(&(chain->rng), seed);
+}
+
+void sa_chain_run(tsp_instance* tsp_in, candidate_list* cand, double* exp_table, sa_chain* chain, double inverse_t, int num_moves)
+{
+	int n = tsp_in->num_nodes;
+
+	int m;
+	for (m = 0; m < num_moves; m++)
+	{
+		sa_move move;
+		double delta = sa_random_move(tsp_in, cand, &(chain->rng), chain->tour, chain->pos, &move);
+
+		if (metropolis(&(chain->rng), exp_table, delta, inverse_t))
+		{
+			if (chain->cost + delta < chain->best_cost - EPS)
+			{
+				chain->best_cost = chain->cost + delta;
+				chain->best_is_current = 1;
+			}
+			else if (chain->best_is_current)
+			{
+				memcpy(chain->best_tour, chain->tour, n * sizeof(int));
+				chain->best_is_current = 0;
 			}
 
-			time_t end_inner_iteration =  clock();
+			sa_apply_move(chain->tour, chain->pos, n, &move);
+			chain->cost += delta;
+			chain->num_accepted++;
+		}
+	}
 
-			remaining_time = remaining_time - ((double)(end_inner_iteration - start_inner_iteration) /(double) CLOCKS_PER_SEC);
+	chain->num_moves += num_moves;
+}
 
-			if (remaining_time <= 0.0 )
-				break;
+void sa_chain_best(tsp_instance* tsp_in, sa_chain* chain)
+{
+	if (chain->best_is_current)
+		memcpy(chain->best_tour, chain->tour, tsp_in->num_nodes * sizeof(int));
+
+	//remove the rounding errors accumulated by the deltas
+	chain->best_cost = tour_cost(tsp_in, chain->best_tour);
+}
+
+void sa_chain_free(sa_chain* chain)
+{
+	free(chain->tour);
+	free(chain->pos);
+	free(chain->best_tour);
+}
+
+double sa_random_move(tsp_instance* tsp_in, candidate_list* cand, rng_state* rng, int* tour, int* pos, sa_move* move)
+{
+	int n = tsp_in->num_nodes;
+	int a = rng_int(rng, n);
+	int r = rng_int(rng, cand->k);
+	int c = cand->nodes[a * cand->k + r];
+	double cost_a_c = cand->costs[a * cand->k + r];
+	uint64_t bits = rng_next(rng);
+
+	if (bits & 1)
+	{
+		//2-opt move that creates the edge (a,c), using the successors or the predecessors of a and c
+		int b, d;
+		if (bits & 2)
+		{
+			b = tour[(pos[a] + 1) % n];
+			d = tour[(pos[c] + 1) % n];
 		}
-		t = ((pow(alpha, outer_iteration+1) )* t_max) + t_min;
-		if ((t - t_min) < 0.1)
+		else
 		{
-			t = t_max;
-			outer_iteration = 0;
+			b = tour[(pos[a] - 1 + n) % n];
+			d = tour[(pos[c] - 1 + n) % n];
 		}
+
+		if (c == b || d == a)
+			return DBL_MAX;
+
+		move->type = 0;
+		move->a = a;
+		move->b = b;
+		move->c = c;
+		move->d = d;
+
+		return cost_a_c + edge_cost(tsp_in, b, d) - edge_cost(tsp_in, a, b) - edge_cost(tsp_in, c, d);
+	}
+
+	//Or-opt move of the segment that starts in a, inserted next to c
+	int length = 1 + (int)((bits >> 2) % MAX_OR_OPT);
+
+	if (length > n - 4)
+		return DBL_MAX;
+
+	int s1 = a;
+	int s2 = tour[(pos[a] + length - 1) % n];
+	int p = tour[(pos[a] - 1 + n) % n];
+	int nx = tour[(pos[s2] + 1) % n];
+
+	//c must be outside the segment and the insertion edge must be c->d in the orientation of the tour
+	int offset = (pos[c] - pos[s1] + n) % n;
+	if (offset < length || c == p)
+		return DBL_MAX;
+
+	int d = tour[(pos[c] + 1) % n];
+	if (d == p)
+		return DBL_MAX;
+
+	double common = edge_cost(tsp_in, p, nx) - edge_cost(tsp_in, p, s1) - edge_cost(tsp_in, s2, nx) - edge_cost(tsp_in, c, d);
+	double delta_reversed = common + edge_cost(tsp_in, c, s2) + edge_cost(tsp_in, s1, d);
+	double delta_forward = common + cost_a_c + edge_cost(tsp_in, s2, d);
+
+	move->type = 1;
+	move->p = p;
+	move->s1 = s1;
+	move->s2 = s2;
+	move->nx = nx;
+	move->c = c;
+	move->d = d;
+	move->reversed = (length == 1 || delta_reversed < delta_forward);
+
+	return (move->reversed) ? delta_reversed : delta_forward;
+}
+
+void sa_apply_move(int* tour, int* pos, int num_nodes, sa_move* move)
+{
+	if (move->type == 0)
+	{
+		two_opt_move(tour, pos, num_nodes, move->a, move->b, move->c);
+		return;
 	}
+
+	//p s1...s2 nx ... c d  ->  p c ... nx s2...s1 d  ->  p nx ... c s2...s1 d
+	two_opt_move(tour, pos, num_nodes, move->p, move->s1, move->c);
+	two_opt_move(tour, pos, num_nodes, move->p, move->c, move->nx);
+
+	//p nx ... c s1...s2 d
+	if (!move->reversed)
+		two_opt_move(tour, pos, num_nodes, move->c, move->s2, move->s1);
+}
+
+void two_opt_move(int* tour, int* pos, int num_nodes, int a, int b, int c)
+{
+	if (tour[(pos[a] + 1) % num_nodes] == b)
+		tour_reverse(tour, pos, num_nodes, pos[b], pos[c]);
+	else
+		tour_reverse(tour, pos, num_nodes, pos[c], pos[b]);
+}
+
+void tour_reverse(int* tour, int* pos, int num_nodes, int from, int to)
+{
+	int length = ((to - from + num_nodes) % num_nodes) + 1;
+
+	//the reversal of the complementary path gives the same tour
+	if (2 * length > num_nodes)
+	{
+		int tmp = from;
+		from = (to + 1) % num_nodes;
+		to = (tmp - 1 + num_nodes) % num_nodes;
+		length = num_nodes - length;
+	}
+
+	int i;
+	for (i = 0; i < length / 2; i++)
+	{
+		int tmp = tour[from];
+		tour[from] = tour[to];
+		tour[to] = tmp;
+		pos[tour[from]] = from;
+		pos[tour[to]] = to;
+
+		from = (from + 1 == num_nodes) ? 0 : from + 1;
+		to = (to == 0) ? num_nodes - 1 : to - 1;
+	}
+}
+
+void build_exp_table(double* exp_table)
+{
+	int i;
+	for (i = 0; i < EXP_TABLE_SIZE; i++)
+		exp_table[i] = exp(-(i * EXP_TABLE_MAX) / EXP_TABLE_SIZE);
+}
+
+int metropolis(rng_state* rng, double* exp_table, double delta, double inverse_t)
+{
+	if (delta <= 0.0)
+		return 1;
+
+	double x = delta * inverse_t * (EXP_TABLE_SIZE / EXP_TABLE_MAX);
+
+	if (x >= EXP_TABLE_SIZE)
+		return 0;
+
+	return rng_double(rng) < exp_table[(int)x];
 }
+
 void genetic_solver(tsp_instance* tsp_in)
 {
-	time_t start = clock();
+	deadline_timer timer;
+	timer_start(&timer, tsp_in->deadline);
+	timers_expire(0);
 
 	tsp_in->bestCostD = DBL_MAX;
 	tsp_in->bestCostI = INT_MAX;
 
-	int num_worst = 0;
-	int* worst_members = (int*)calloc((size_t)NUM_WORST_MEMBERS, sizeof(int));
+	//one island with the whole population, or one island for each thread (island model)
+	int num_islands = 1;
+	if (tsp_in->migration_interval > 0)
+	{
+		num_islands = tsp_in->num_threads;
+		if (num_islands > tsp_in->population_size / MIN_ISLAND_SIZE)
+			num_islands = tsp_in->population_size / MIN_ISLAND_SIZE;
+	}
 
 	//printf(LINE);
 	printf("%sHeuristic solver%s\n", RED, WHITE);
 	printf("%s[Construction]  %sNearest Neighborhood\n", BLUE, WHITE);
 
-	printf("%s[Meta-heuristic] %sGenetic\n", BLUE, WHITE);
+	if (num_islands > 1)
+		printf("%s[Meta-heuristic] %sGenetic (%d islands, migration every %d generations)\n", BLUE, WHITE, num_islands, tsp_in->migration_interval);
+	else
+		printf("%s[Meta-heuristic] %sGenetic\n", BLUE, WHITE);
 	printf(LINE);
 
-	int** members = (int**)calloc((size_t)POPULATION_SIZE, sizeof(int*));
-	double* fitnesses = (double*)calloc((size_t)POPULATION_SIZE, sizeof(double));
-	double sum_prob = 0.0;
+	island* islands = (island*)calloc((size_t)num_islands, sizeof(island));
 
 	int i = 0;
-	for (i = 0; i < POPULATION_SIZE; i++)
+	for (i = 0; i < num_islands; i++)
 	{
-		members[i] = (int*)calloc((size_t)tsp_in->num_nodes, sizeof(int));
-		fitnesses[i] = DBL_MAX;
+		//the last island contains also the remaining members
+		int size = tsp_in->population_size / num_islands;
+		if (i == num_islands - 1)
+			size = tsp_in->population_size - size * i;
+
+		//number of offspring of each generation (even, since the crossover generates pairs of offspring)
+		int num_worst = (size / 2 < NUM_WORST_MEMBERS) ? size / 2 : NUM_WORST_MEMBERS;
+		num_worst -= num_worst % 2;
+
+		islands[i].tsp_in = tsp_in;
+		islands[i].id = i;
+		islands[i].timer = &timer;
+		islands[i].best_index = -1;
+		population_init(&(islands[i].pop), size, tsp_in->num_nodes, num_worst);
+		islands[i].worst_members = (int*)calloc((size_t)num_worst, sizeof(int));
+		migration_queue_init(&(islands[i].queue), tsp_in->num_nodes);
+
+		int j;
+		for (j = 0; j < size; j++)
+			islands[i].pop.fitnesses[j] = DBL_MAX;
 	}
 
-	int num_threads = NUM_MULTI_START;
-	pthread_t* threads = (pthread_t*)calloc((size_t)num_threads, sizeof(pthread_t));
-	construction_args* param = (construction_args*)calloc((size_t)num_threads, sizeof(construction_args));
+	//ring topology
+	for (i = 0; i < num_islands; i++)
+		islands[i].next_queue = &(islands[(i + 1) % num_islands].queue);
+
+	//candidate lists used by the EAX crossover to merge the subtours
+	candidate_list cand;
+	#ifdef EAX_CROSSOVER
+	build_candidate_list(tsp_in, &cand, NUM_CANDIDATES);
+	#else
+	memset(&cand, 0, sizeof(candidate_list));
+	#endif
+
+	for (i = 0; i < num_islands; i++)
+		islands[i].cand = &cand;
+
+	//persistent pool used by the construction and by the evolution (islands or offspring of each generation)
+	thread_pool pool;
+	pool_init(&pool, tsp_in->num_threads);
+
+	//each island is split in chunks of members built by different jobs, so that idle threads steal the remaining ones
+	int num_chunks = (tsp_in->num_threads * CONSTRUCTION_CHUNKS + num_islands - 1) / num_islands;
+	construction_args* param = (construction_args*)calloc((size_t)(num_islands * num_chunks), sizeof(construction_args));
 
 	int update = 0;
 
@@ -1789,79 +2522,96 @@ void genetic_solver(tsp_instance* tsp_in)
 	}
 
 	int num_instances = 0;
-	int num_members = POPULATION_SIZE / num_threads;
-	int best_index = 0;
-	double sum_fitnesses = 0.0;
+	int num_jobs = 0;
 
-	i = 0;
-	for (; i < num_threads; i++)
+	for (i = 0; i < num_islands; i++)
 	{
-		param[i].tsp_in = tsp_in;
-		param[i].members = members;
-		param[i].fitnesses = fitnesses;
-		param[i].num_instances = &num_instances;
-		param[i].first_index = (POPULATION_SIZE / num_threads) * i;
-		param[i].best_index = &best_index;
-		param[i].sum_fitnesses = &sum_fitnesses;
-
-		if (i == num_threads)
-			param[i].num_members = num_members;
-		else
-		{
-			num_members += POPULATION_SIZE % num_threads;
-			param[i].num_members = num_members;
-		}
-
-		param[i].sum_prob = &sum_prob;
-		pthread_create(&(threads[i]), NULL, construction, (void*)&param[i]);
-	}
-
-	for (i = 0; i < num_threads; i++)
-	{
-		int rc = pthread_join(threads[i], NULL);
+		island* isl = &(islands[i]);
+		int chunks = (num_chunks < isl->pop.num_members) ? num_chunks : isl->pop.num_members;
+		int num_members = isl->pop.num_members / chunks;
+
+		int j;
+		for (j = 0; j < chunks; j++, num_jobs++)
+		{
+			param[num_jobs].tsp_in = tsp_in;
+			param[num_jobs].pop = &(isl->pop);
+			param[num_jobs].population_size = tsp_in->population_size;
+			param[num_jobs].num_instances = &num_instances;
+			param[num_jobs].first_index = num_members * j;
+			param[num_jobs].first_stream = (tsp_in->population_size / num_islands) * i + num_members * j + 1;
+			param[num_jobs].best_index = &(isl->best_index);
+			param[num_jobs].sum_fitnesses = &(isl->sum_fitnesses);
+
+			//the last chunk contains also the remaining members
+			if (j == chunks - 1)
+				param[num_jobs].num_members = isl->pop.num_members - num_members * j;
+			else
+				param[num_jobs].num_members = num_members;
 
-		if (rc)
-			exit(-1);
+			pool_submit(&pool, construction, (void*)&param[num_jobs]);
+		}
 	}
 
-	free(threads);
+	pool_wait(&pool);
 	free(param);
 
-	for (i = 0; i < NUM_WORST_MEMBERS; i++)
-	{
-		worst_members[i] = -1;
-	}
-	/*
-	int* succ = (int*)calloc(tsp_in->num_nodes, sizeof(int));
-	int* comp = (int*)calloc(tsp_in->num_nodes, sizeof(int));
-	int n_comps = 1;*/
+	for (i = 0; i < num_islands; i++)
+		population_build_selection(&(islands[i].pop));
+
 	int  num_edges = (tsp_in->num_nodes * (tsp_in->num_nodes-1)) / 2;
 	tsp_in->sol = (double*)calloc((size_t)num_edges, sizeof(double));
 
-	/*update_solution(members[best_index], tsp_in->sol, tsp_in->num_nodes);
-	define_tour(tsp_in, tsp_in->sol, succ, comp, &n_comps);
-	plot(tsp_in, succ, comp, &n_comps);
+	island* best_island = &(islands[0]);
 
-	double tmp = 0.0;
-	for (i = 0; i < tsp_in->num_nodes; i++)
+	if (num_islands > 1)
 	{
-		double x;
-		dist(members[best_index][i], members[best_index][(i + 1) % tsp_in->num_nodes], tsp_in, &x);
-		tmp += x;
-	}*/
-	evolution(tsp_in, members, fitnesses, &best_index, worst_members, &sum_prob, &sum_fitnesses, start);
+		printf("\n%s", LINE);
+
+		//each island is a source of the progress reports
+		progress_start(tsp_in, "genetic", "average");
+
+		//at most one island for each thread of the pool, so all the islands evolve at the same time
+		for (i = 0; i < num_islands; i++)
+			pool_submit(&pool, island_evolution, (void*)&islands[i]);
+
+		pool_wait(&pool);
+		progress_stop();
+
+		printf("%s", LINE);
+		for (i = 0; i < num_islands; i++)
+		{
+			printf("%s[Island %2d]%s  generations: %5d    migrants: %3d    best: %.2lf    average: %.2lf\n", BLUE, i, WHITE,
+				islands[i].num_generations, islands[i].num_migrants, islands[i].pop.fitnesses[islands[i].best_index],
+				islands[i].sum_fitnesses / (double)islands[i].pop.num_members);
+
+			if (islands[i].pop.fitnesses[islands[i].best_index] < best_island->pop.fitnesses[best_island->best_index])
+				best_island = &(islands[i]);
+		}
+		printf("%s", LINE);
+
+		tsp_in->bestCostD = best_island->pop.fitnesses[best_island->best_index];
+		tsp_in->bestCostI = (int)tsp_in->bestCostD;
+	}
+	else
+		evolution(tsp_in, &(best_island->pop), &(best_island->best_index), best_island->worst_members, &(best_island->sum_fitnesses), &cand, &timer, &pool);
+
+	pool_destroy(&pool);
+
+	tsp_in->execution_time = timer_elapsed(&timer);
+	tsp_in->cpu_execution_time = timer_cpu(&timer);
 
 	print_cost(tsp_in);
-	printf("%sExecution time:%s %.2lf seconds\n", GREEN, WHITE, tsp_in->execution_time);
+	printf("%sExecution time:%s %.2lf seconds (CPU %.2lf seconds)\n", GREEN, WHITE, tsp_in->execution_time, tsp_in->cpu_execution_time);
 	printf("%s%s%s", RED, LINE, WHITE);
 
-	
+	int* best_tour = (int*)calloc(tsp_in->num_nodes, sizeof(int));
 	int* succ = (int*)calloc(tsp_in->num_nodes, sizeof(int));
 	int* comp = (int*)calloc(tsp_in->num_nodes, sizeof(int));
 	int n_comps = 1;
 	
-	succ_construction(members[best_index], succ, tsp_in->num_nodes);
-	update_solution(members[best_index], tsp_in->sol, tsp_in->num_nodes);
+	population_load(&(best_island->pop), best_island->best_index, best_tour);
+	succ_construction(best_tour, succ, tsp_in->num_nodes);
+	update_solution(best_tour, tsp_in->sol, tsp_in->num_nodes);
 
 	if (tsp_in->plot)
 	{
@@ -1870,53 +2620,67 @@ void genetic_solver(tsp_instance* tsp_in)
 			comp[k] = 1;
 
 		plot(tsp_in, succ, comp, &n_comps);
-
-		free(succ);
-		free(comp);
 	}
 
-	for (i = 0; i < POPULATION_SIZE; i++)
-		free(members[i]);
+	free(best_tour);
+	free(succ);
+	free(comp);
+
+	for (i = 0; i < num_islands; i++)
+	{
+		free(islands[i].worst_members);
+		population_free(&(islands[i].pop));
+		migration_queue_free(&(islands[i].queue));
+	}
 
-	free(members);
-	free(fitnesses);
+	free(islands);
 	free(tsp_in->sol);
+
+	#ifdef EAX_CROSSOVER
+	free_candidate_list(&cand);
+	#endif
 }
 
 void construction(void* param)
 {
 	construction_args* args = (construction_args*)param;
+	population* pop = args->pop;
 	double best_cost = DBL_MAX;
 	int best_index = -1;
-	double sum_prob = 0.0;
 	double sum_fitnesses = 0.0;
-	double best_wrong_cost=0.0;
+	int* visited_nodes = (int*)calloc((size_t)args->tsp_in->num_nodes, sizeof(int));
+	rng_state rng;
 
 	int i = 0;
-	for (; i < args->num_members && i < POPULATION_SIZE; i++)
+	for (; i < args->num_members && i + args->first_index < pop->num_members; i++)
 	{
-		nearest_neighborhood(args->tsp_in, args->members[i + args->first_index], &(args->fitnesses[i + args->first_index]), args->first_index + i + 1, (i + args->first_index) % args->tsp_in->num_nodes);
-		double cost = args->fitnesses[i+args->first_index];
-		greedy_refinement(args->tsp_in, args->members[i + args->first_index], &(args->fitnesses[i + args->first_index]));
+		int index = i + args->first_index;
+		double fitness;
+
+		//a stream for each member, so that the population does not depend on the split in jobs
+		rng_stream(&rng, (uint64_t)args->tsp_in->seed, (uint64_t)(args->first_stream + i));
+		nearest_neighborhood(args->tsp_in, visited_nodes, &fitness, &rng, index % args->tsp_in->num_nodes);
+		greedy_refinement(args->tsp_in, visited_nodes, &fitness);
+		population_store(pop, index, visited_nodes, fitness);
 		
-		sum_prob += (1000.0 / args->fitnesses[i + args->first_index]);
-		sum_fitnesses += args->fitnesses[i + args->first_index];
+		sum_fitnesses += fitness;
 
-		if ((args->fitnesses[i + args->first_index]) < best_cost)
+		if (fitness < best_cost)
 		{
-			best_cost = args->fitnesses[i + args->first_index];
-			best_index = i + args->first_index;
-			best_wrong_cost = cost;
+			best_cost = fitness;
+			best_index = index;
 		}
 	}
 
+	free(visited_nodes);
+
 	pthread_mutex_lock(&mutex);
 
 	*(args->num_instances) += args->num_members;
 	printf("\r[%s", GREEN);
 
 	i = 0;
-	int update = (((double)*(args->num_instances)) / (double)(POPULATION_SIZE)) * 10.0;
+	int update = (((double)*(args->num_instances)) / (double)(args->population_size)) * 10.0;
 
 	for (; i < 10; i++)
 	{
@@ -1926,457 +2690,732 @@ void construction(void* param)
 			printf(" ");
 	}
 
-	printf("%s] %3d %%     ", WHITE, (int)(update * 10.0));
-	
-	if (args->tsp_in->integerDist)
+	printf("%s] %3d %%     ", WHITE, (int)(update * 10.0));
+
+	//best member of the population built by this and the previous threads
+	if (best_index != -1 && (*(args->best_index) == -1 || best_cost < pop->fitnesses[*(args->best_index)]))
+		*args->best_index = best_index;
+	
+	if (args->tsp_in->integerDist)
+	{
+		if (best_cost < args->tsp_in->bestCostI)
+			args->tsp_in->bestCostI = (int)best_cost;
+	}
+	else
+	{
+		if (best_cost < args->tsp_in->bestCostD)
+			args->tsp_in->bestCostD = best_cost;
+	}
+
+	(*(args->sum_fitnesses)) += sum_fitnesses;
+
+	pthread_mutex_unlock(&mutex);
+}
+
+void evolution(tsp_instance* tsp_in, population* pop, int* best_index, 
+	           int* worst_members, double* sum_fitnesses, candidate_list* cand, deadline_timer* timer, thread_pool* pool)
+{
+	int num_epochs = 0;
+	printf("\n%s", LINE);
+	printf("incumbent: %.2lf  average: %.2lf\n", tsp_in->bestCostD, *sum_fitnesses/((double) pop->num_members));
+
+	progress_start(tsp_in, "genetic", "average");
+	progress_source source;
+	progress_source_init(&source);
+
+	//each thread generates a contiguous range of offspring (pairs of offspring for the crossover)
+	int num_threads = (pool->num_workers < pop->num_slots / 2) ? pool->num_workers : pop->num_slots / 2;
+	offspring_args* param = (offspring_args*)calloc((size_t)num_threads, sizeof(offspring_args));
+
+	//permutation of the members that gives the pairs of parents of the EAX crossover
+	int* parents = (int*)calloc((size_t)pop->num_members, sizeof(int));
+	rng_state rng;
+
+	//the offspring equal to a tour already seen (a member of the population too) are discarded
+	tour_archive archive;
+	archive_init(&archive, tsp_in->num_nodes, 0);
+
+	int i;
+	for (i = 0; i < num_threads; i++)
 	{
-		if (best_cost < args->tsp_in->bestCostI)
-		{
-			args->tsp_in->bestCostI = (int)best_cost;
-			*args->best_index = best_index;
-		}
+		offspring_args_init(&param[i], tsp_in, pop, worst_members, cand, timer);
+		param[i].parents = parents;
+		param[i].archive = &archive;
+
+		//ranges of offspring of the same size (even, apart from the last one)
+		int num_pairs = (pop->num_slots / 2) / num_threads;
+		param[i].first_slot = 2 * num_pairs * i;
+		param[i].last_slot = (i == num_threads - 1) ? pop->num_slots : 2 * num_pairs * (i + 1);
 
-		/*
-		printf("incumbent: %d     ", args->tsp_in->bestCostI);
-		printf("best_index: %d", (*args->best_index));
-		printf("average: %d", (int)(*args->sum_fitnesses / (double)POPULATION_SIZE));
-		*/
-		/*
-		printf("[Thread %2d]  best_cost: %d    instances: %5d     incumbent: %d\n",
-			   args->id, best_cost, *(args->num_instances), args->tsp_in->bestCostI);
-		*/
+		//streams after the ones of the construction
+		rng_stream(&(param[i].rng), (uint64_t)tsp_in->seed, (uint64_t)(tsp_in->population_size + i + 1));
 	}
-	else
+
+	rng_stream(&rng, (uint64_t)tsp_in->seed, 0);
+	archive_population(&archive, pop, param[0].dad);
+
+	while (time_left(timer) > 0)
 	{
-		if (best_cost < args->tsp_in->bestCostD)
+		population_worst(pop, worst_members);
+
+		//the parents are selected from the current generation, which is read-only until the commit
+		#ifdef EAX_CROSSOVER
+		int is_crossover = 1;
+		population_permutation(pop, parents, &rng);
+		#else
+		int is_crossover = (num_epochs % 5 == 0);
+		#endif
+		for (i = 0; i < num_threads; i++)
 		{
-			args->tsp_in->bestCostD = best_cost;
-			*args->best_index = best_index;
+			param[i].crossover = is_crossover;
+			pool_submit(pool, offspring_worker, (void*)&param[i]);
 		}
 
-		/*
-		printf("incumbent: %.2lf     ", args->tsp_in->bestCostD);
-		printf("best_index: %d     ", (*args->best_index));
-		printf("average: %.2lf", *args->sum_fitnesses / (double)POPULATION_SIZE);
-		*/
+		pool_wait(pool);
+
+		//insertion of the whole batch of offspring in the worst slots, in order of slot
+		commit_offspring(pop, best_index, sum_fitnesses);
+
+		if (tsp_in->integerDist)
+			tsp_in->bestCostI = (int)pop->fitnesses[*best_index];
+		else
+			tsp_in->bestCostD = pop->fitnesses[*best_index];
+
+		num_epochs++;
 
-		/*
-		printf("[Thread %2d]  best_cost: %.2lf    instances: %5d     incumbent: %.2lf\n",
-			   args->id, best_cost, *(args->num_instances), args->tsp_in->bestCostD);
-		*/
+		progress_post(&source, num_epochs, pop->fitnesses[*best_index], *sum_fitnesses / (double)pop->num_members, time_left(timer));
 	}
 
-	(*(args->sum_prob)) += sum_prob;
-	(*(args->sum_fitnesses)) += sum_fitnesses;
+	progress_stop();
 
-	pthread_mutex_unlock(&mutex);
+	for (i = 0; i < num_threads; i++)
+		offspring_args_free(&param[i]);
 
-	pthread_exit(NULL);
+	archive_free(&archive);
+	free(parents);
+	free(param);
+
+	printf("%s", LINE);
 }
 
-void evolution(tsp_instance* tsp_in, int** members, double* fitnesses, int* best_index, 
-	           int* worst_members, double* sum_prob, double* sum_fitnesses, time_t start)
+void offspring_args_init(offspring_args* args, tsp_instance* tsp_in, population* pop, int* worst_members, candidate_list* cand, deadline_timer* timer)
 {
-	int num_epochs = 0;
-	time_t end = clock();
-	printf("\n%s", LINE);
-	printf("incumbent: %.2lf  average: %.2lf\n", tsp_in->bestCostD, *sum_fitnesses/((double) POPULATION_SIZE));
-	int index=0; //first_index of worst_members
+	args->tsp_in = tsp_in;
+	args->pop = pop;
+	args->worst_members = worst_members;
+	args->cand = cand;
+	args->parents = NULL;
+	args->archive = NULL;
+	args->timer = timer;
+	args->dad = (int*)calloc((size_t)tsp_in->num_nodes, sizeof(int));
+	args->mom = (int*)calloc((size_t)tsp_in->num_nodes, sizeof(int));
+	args->offspring1 = (int*)calloc((size_t)tsp_in->num_nodes, sizeof(int));
+	args->offspring2 = (int*)calloc((size_t)tsp_in->num_nodes, sizeof(int));
+	args->in_offspring1 = (char*)calloc((size_t)tsp_in->num_nodes, sizeof(char));
+	args->in_offspring2 = (char*)calloc((size_t)tsp_in->num_nodes, sizeof(char));
+
+	#ifdef EAX_CROSSOVER
+	eax_workspace_init(&(args->eax), tsp_in->num_nodes);
+	#endif
+}
+
+void offspring_args_free(offspring_args* args)
+{
+	free(args->dad);
+	free(args->mom);
+	free(args->offspring1);
+	free(args->offspring2);
+	free(args->in_offspring1);
+	free(args->in_offspring2);
+
+	#ifdef EAX_CROSSOVER
+	eax_workspace_free(&(args->eax));
+	#endif
+}
 
-	while ((((double)(end - start) / (double)CLOCKS_PER_SEC)) < tsp_in->deadline)
+void offspring_worker(void* param)
+{
+	offspring_args* args = (offspring_args*)param;
+
+	if (args->crossover)
+		crossover(args);
+	else
+		mutation(args);
+}
+
+void crossover(offspring_args* args)
+{
+	tsp_instance* tsp_in = args->tsp_in;
+	population* pop = args->pop;
+	int n = tsp_in->num_nodes;
+	int* dad = args->dad;
+	int* mom = args->mom;
+	int* offspring1 = args->offspring1;
+
+	int slot = args->first_slot;
+	for (; slot + 1 < args->last_slot; slot += 2)
 	{
-		//printf("Sum_fitnesses: %.2lf      \n", (*sum_fitnesses));
-		if (index%NUM_WORST_MEMBERS == 0)
+		#ifdef EAX_CROSSOVER
+		//each member A of the permutation is crossed with the next one B, and it is replaced only by a better offspring
+		//(the offspring keep the edges of the parents, so they are not refined)
+		int k;
+		for (k = slot; k < slot + 2; k++)
 		{
-			index = 0;
-			update_worst(fitnesses, worst_members);
+			int a_index = args->parents[k];
+			population_load(pop, a_index, dad);
+			population_load(pop, args->parents[(k + 1) % pop->num_members], mom);
+
+			double fitness = eax_crossover(tsp_in, args->cand, &(args->eax), &(args->rng), dad, pop->fitnesses[a_index], mom, offspring1);
+			int is_new = (fitness < pop->fitnesses[a_index]) && !archive_seen(args->archive, tour_hash(offspring1, n));
+			population_stage(pop, k, is_new ? a_index : -1, offspring1, fitness);
 		}
+		#else
+		int* offspring2 = args->offspring2;
+		char* in_offspring1 = args->in_offspring1;
+		char* in_offspring2 = args->in_offspring2;
 
-		if (num_epochs % 5 == 0)
-		{
-			crossover(tsp_in, members, fitnesses, best_index, worst_members, sum_prob, sum_fitnesses, (num_epochs + 1) * 100, &index);
+		population_load(pop, population_select(pop, &(args->rng)), dad);
+		population_load(pop, population_select(pop, &(args->rng)), mom);
 
-			printf(LINE);
-			if (tsp_in->integerDist)
-				printf("%s[Crossover]%s      added instances: %d     incumbent: %d    average: %d\n",
-					RED, WHITE, index, tsp_in->bestCostI, (int)(*sum_fitnesses / (double)POPULATION_SIZE));
-			else
-				printf("%s[Crossover]%s      added instances: %d     incumbent: %.2lf    average: %.2lf\n",
-					RED, WHITE, index, tsp_in->bestCostD, *sum_fitnesses / (double)POPULATION_SIZE);
-				//printf("%d %.2lf %.2lf\n", num_epochs-1, tsp_in->bestCostD, *sum_fitnesses / (double)POPULATION_SIZE);
+		int j = 0;
+		int begin = (int)(((double)n) /2.0);
+
+		memset(in_offspring1, 0, (size_t)n * sizeof(char));
+		memset(in_offspring2, 0, (size_t)n * sizeof(char));
+
+		//second half of the dad and first half of the mom are copied in the offspring
+		for (j = begin; j < n; j++)
+		{
+			offspring1[j] = dad[j];
+			in_offspring1[dad[j]] = 1;
+			offspring2[j-begin] = mom[j-begin];
+			in_offspring2[mom[j - begin]] = 1;
 		}
-		else
+
+		//the offspring are completed with the missing nodes, in the order of the other parent
+		int count1 = 0;
+		int count2 = n - begin;
+		for (j = 0; j < n && (count1 < begin || count2 < n); j++)
 		{
-			mutation(tsp_in, members, fitnesses, best_index, worst_members, sum_prob, sum_fitnesses, (num_epochs + 1) * 100, &index);
+			if (!in_offspring1[mom[j]])
+				offspring1[count1++] = mom[j];
 
-			if (tsp_in->integerDist)
-				printf("%s[Mutation]%s       added instances: %d     incumbent: %d    average: %d\n", 
-					   BLUE, WHITE, index, tsp_in->bestCostI, (int) (*sum_fitnesses/(double) POPULATION_SIZE));
-			else
-				printf("%s[Mutation]%s       added instances: %d     incumbent: %.2lf    average: %.2lf\n",
-					BLUE, WHITE, index, tsp_in->bestCostD, *sum_fitnesses / (double)POPULATION_SIZE);
-				//printf("%d %.2lf %.2lf\n", num_epochs-1, tsp_in->bestCostD, *sum_fitnesses / (double)POPULATION_SIZE);
+			if (!in_offspring2[dad[j]])
+				offspring2[count2++] = dad[j];
 		}
 
-		printf("%sbest index:%s %5d\n", GREEN, WHITE, *best_index);
+		double fitness;
+		int is_new = refine_offspring(args, offspring1, &fitness);
+		population_stage(pop, slot, is_new ? args->worst_members[slot] : -1, offspring1, fitness);
 
-		end = clock();
-		num_epochs++;
+		is_new = refine_offspring(args, offspring2, &fitness);
+		population_stage(pop, slot + 1, is_new ? args->worst_members[slot + 1] : -1, offspring2, fitness);
+		#endif
 	}
-
-	printf("\n%s",LINE);
-	tsp_in->execution_time = ((double)(end - start) / (double)CLOCKS_PER_SEC);
 }
 
-void crossover(tsp_instance* tsp_in, int** members, double* fitnesses, int* best_index,
-	          int* worst_members, double* sum_prob, double* sum_fitnesses, int seed, int* index)
+void mutation(offspring_args* args)
 {
-	srand(seed);
-
-	int i = 0;
-	for (; i < NUM_WORST_MEMBERS/2; i++)
+	tsp_instance* tsp_in = args->tsp_in;
+	population* pop = args->pop;
+	int n = tsp_in->num_nodes;
+	int* dad = args->dad;
+	int* offspring = args->offspring1;
+
+	int slot = args->first_slot;
+	for (; slot < args->last_slot; slot++)
 	{
-		int j = 0;
-		double dad = (double)(rand() % ((int)((*sum_prob) * 100000.0)));
-		double mom = (double)(rand() % ((int)((*sum_prob) * 100000.0)));
-		//printf("SUM: %.2lf\n",sum_prob*1000);
-		//printf("SUM: %.2lf\n", dad);
-		//printf("SUM: %.2lf\n", mom);
-
-		double sum_ranges = 0.0;
-		int found_dad = 0;
-		int found_mom = 0;
-		int dad_index;
-		int mom_index;
+		population_load(pop, population_select(pop, &(args->rng)), dad);
 
-		/*
-		printf(LINE);
-		printf("Mom: %.2lf   fitness: %.2lf\n", mom, *sum_fitnesses/ tsp_in->num_nodes);
-		printf("Dad: %.2lf   fitness: %.2lf\n", dad, *sum_fitnesses/ tsp_in->num_nodes);
-		*/
+		//the second half of the dad is reversed
+		int j = 0;
+		int start_range = (int)(((double)n) / 2.0);
+		int end_range = n;
 
-		//1/fitness[i]
-		for (j = 0; j < POPULATION_SIZE; j++)
+		for (j = start_range; j < end_range; j++)
 		{
+			offspring[j] = dad[end_range - 1 - j + start_range];
+		}
 
-			if (((100000000.0 / ((*sum_prob) * fitnesses[j])) + sum_ranges) > dad && !found_dad)
-			{
-				dad_index = j;
-				found_dad = 1;
-			}
+		for (j = 0; j < start_range; j++)
+		{
+			offspring[j] = dad[j];
+		}
 
-			if (((100000000.0 / ((*sum_prob) * fitnesses[j])) + sum_ranges) > mom && !found_mom)
-			{
-				mom_index = j;
-				found_mom = 1;
-			}
+		double fitness;
+		int is_new = refine_offspring(args, offspring, &fitness);
+		population_stage(pop, slot, is_new ? args->worst_members[slot] : -1, offspring, fitness);
+	}
+}
 
-			if (found_dad && found_mom)
-				break;
+int refine_offspring(offspring_args* args, int* offspring, double* fitness)
+{
+	tsp_instance* tsp_in = args->tsp_in;
+	*fitness = tour_cost(tsp_in, offspring);
 
-			sum_ranges += (100000000.0 / ((*sum_prob) * fitnesses[j]));
-		}
+	//an offspring already seen would be refined again to a known local optimum
+	if (archive_seen(args->archive, tour_hash(offspring, tsp_in->num_nodes)))
+		return 0;
 
-		int* offspring1 = (int*)calloc((size_t)tsp_in->num_nodes, sizeof(int));
-		int* offspring2 = (int*)calloc((size_t)tsp_in->num_nodes, sizeof(int));
+	greedy_refinement(tsp_in, offspring, fitness);
 
-		j = 0;
-		int begin = (int)(((double)tsp_in->num_nodes) /2.0);
+	#ifdef WINDOW_REFINEMENT
+		//the offspring are already generated in parallel, so the windows are refined in the thread
+		window_refinement(tsp_in, offspring, fitness, args->timer, NULL);
+	#endif
 
-		for (j = begin; j < tsp_in->num_nodes; j++)
-		{
-			offspring1[j] = members[dad_index][j];
-			offspring2[j-begin] = members[mom_index][j-begin];
-		}
+	//the local optima already seen are in the population or were already replaced
+	return !archive_seen(args->archive, tour_hash(offspring, tsp_in->num_nodes));
+}
 
-		int count1 = 0;
-		int count2 = tsp_in->num_nodes - begin;
-		for (j = 0; j < tsp_in->num_nodes && (count1 < begin || count2 < tsp_in->num_nodes); j++)
-		{
-			int k;
+void archive_population(tour_archive* archive, population* pop, int* visited_nodes)
+{
+	int i;
+	for (i = 0; i < pop->num_members; i++)
+	{
+		population_load(pop, i, visited_nodes);
+		archive_seen(archive, tour_hash(visited_nodes, archive->num_nodes));
+	}
+}
 
-			//Offspring 1 fullfill
-			for (k = begin; k < tsp_in->num_nodes; k++)
-			{
-				if (members[mom_index][j] == offspring1[k])
-					break;
-			}
+void eax_workspace_init(eax_workspace* eax, int num_nodes)
+{
+	eax->adj_a = (int*)calloc((size_t)2 * num_nodes, sizeof(int));
+	eax->adj_b = (int*)calloc((size_t)2 * num_nodes, sizeof(int));
+	eax->link = (int*)calloc((size_t)2 * num_nodes, sizeof(int));
+	eax->diff_a = (int*)calloc((size_t)2 * num_nodes, sizeof(int));
+	eax->diff_b = (int*)calloc((size_t)2 * num_nodes, sizeof(int));
+	eax->num_diff_a = (int*)calloc((size_t)num_nodes, sizeof(int));
+	eax->num_diff_b = (int*)calloc((size_t)num_nodes, sizeof(int));
+	eax->path = (int*)calloc((size_t)2 * num_nodes + 2, sizeof(int));
+	eax->path_index = (int*)calloc((size_t)num_nodes, sizeof(int));
+	eax->subtour = (int*)calloc((size_t)num_nodes, sizeof(int));
+	eax->nodes = (int*)calloc((size_t)num_nodes, sizeof(int));
+	eax->subtour_size = (int*)calloc((size_t)num_nodes, sizeof(int));
+	eax->subtour_node = (int*)calloc((size_t)num_nodes, sizeof(int));
+}
 
-			if (k == tsp_in->num_nodes)
-				offspring1[count1++] = members[mom_index][j];
+void eax_workspace_free(eax_workspace* eax)
+{
+	free(eax->adj_a);
+	free(eax->adj_b);
+	free(eax->link);
+	free(eax->diff_a);
+	free(eax->diff_b);
+	free(eax->num_diff_a);
+	free(eax->num_diff_b);
+	free(eax->path);
+	free(eax->path_index);
+	free(eax->subtour);
+	free(eax->nodes);
+	free(eax->subtour_size);
+	free(eax->subtour_node);
+}
 
+double eax_crossover(tsp_instance* tsp_in, candidate_list* cand, eax_workspace* eax, rng_state* rng,
+	                 int* parent_a, double cost_a, int* parent_b, int* offspring)
+{
+	int n = tsp_in->num_nodes;
+	int* link = eax->link;
+	int i;
 
-			//Offspring2 fullfill
-			for (k = 0; k < (tsp_in->num_nodes - begin); k++)
-			{
-				if (members[dad_index][j] == offspring2[k])
-					break;
-			}
+	//neighbors of each node in the two parents
+	for (i = 0; i < n; i++)
+	{
+		eax->adj_a[2 * parent_a[i]] = parent_a[(i + n - 1) % n];
+		eax->adj_a[2 * parent_a[i] + 1] = parent_a[(i + 1) % n];
+		eax->adj_b[2 * parent_b[i]] = parent_b[(i + n - 1) % n];
+		eax->adj_b[2 * parent_b[i] + 1] = parent_b[(i + 1) % n];
+	}
 
-			if (k == (tsp_in->num_nodes-begin))
-				offspring2[count2++] = members[dad_index][j];
-		}
+	//edges of a parent that are not in the other one (each node has the same number of A-edges and B-edges)
+	for (i = 0; i < n; i++)
+	{
+		eax->num_diff_a[i] = 0;
+		eax->num_diff_b[i] = 0;
+		eax->path_index[i] = -1;
 
 		int k;
-		double fitness = 0.0;
-		for (k = 0; k < tsp_in->num_nodes; k++)
+		for (k = 0; k < 2; k++)
 		{
-			members[worst_members[(*index)]][k] = offspring1[k];
+			int a = eax->adj_a[2 * i + k];
+			int b = eax->adj_b[2 * i + k];
 
-			if (tsp_in->integerDist)
-			{
-				int x;
-				dist(offspring1[k], offspring1[(k + 1) % tsp_in->num_nodes], tsp_in, &x);
-
-				fitness += (double)x;
-			}
-			else
-			{
-				double x;
-				dist(offspring1[k], offspring1[(k + 1) % tsp_in->num_nodes], tsp_in, &x);
+			if (a != eax->adj_b[2 * i] && a != eax->adj_b[2 * i + 1])
+				eax->diff_a[2 * i + eax->num_diff_a[i]++] = a;
 
-				fitness += x;
-			}
+			if (b != eax->adj_a[2 * i] && b != eax->adj_a[2 * i + 1])
+				eax->diff_b[2 * i + eax->num_diff_b[i]++] = b;
 		}
+	}
 
-		free(offspring1);
-		greedy_refinement(tsp_in, members[worst_members[*index]], &fitness);
+	memcpy(offspring, parent_a, (size_t)n * sizeof(int));
+	double best_cost = cost_a;
 
-		if (tsp_in->integerDist)
+	//each trial applies to A a different (disjoint) AB-cycle
+	int length = 0;
+	int first;
+	int trial;
+	for (trial = 0; trial < EAX_NUM_TRIALS && eax_next_ab_cycle(eax, rng, n, &first, &length); trial++)
+	{
+		//intermediate solution: A without the A-edges of the AB-cycle, with the B-edges of the AB-cycle
+		memcpy(link, eax->adj_a, (size_t)2 * n * sizeof(int));
+		double cost = cost_a;
+
+		for (i = first; i < length - 1; i += 2)
 		{
-			if ((int)fitness < tsp_in->bestCostI)
-			{
-				tsp_in->bestCostI = (int)fitness;
-				(*best_index) = worst_members[(*index)];
-			}
+			int u = eax->path[i];
+			int w = eax->path[i + 1];
+
+			link[2 * u + (link[2 * u] == w ? 0 : 1)] = -1;
+			link[2 * w + (link[2 * w] == u ? 0 : 1)] = -1;
+			cost -= edge_cost(tsp_in, u, w);
 		}
-		else
+
+		for (i = first + 1; i < length - 1; i += 2)
 		{
-			if (fitness < tsp_in->bestCostD)
-			{
-				tsp_in->bestCostD = fitness;
-				(*best_index) = worst_members[(*index)];
-			}
+			int w = eax->path[i];
+			int x = eax->path[i + 1];
+
+			link[2 * w + (link[2 * w] == -1 ? 0 : 1)] = x;
+			link[2 * x + (link[2 * x] == -1 ? 0 : 1)] = w;
+			cost += edge_cost(tsp_in, w, x);
 		}
 
-		(*sum_prob) += ((1000.0 / fitness) - (1000.0 / fitnesses[worst_members[(*index)]]));
-		(*sum_fitnesses) += (fitness - fitnesses[worst_members[(*index)]]);
-		fitnesses[worst_members[(*index)]] = fitness;
-		worst_members[(*index)] = -1;
-		(*index)++;
+		//the AB-cycle is removed from the walk, that goes on from its first node (also its last one)
+		for (i = first + 2; i < length - 1; i += 2)
+			eax->path_index[eax->path[i]] = -1;
+		length = first + 1;
 
-		fitness = 0.0;
-		for (k = 0; k < tsp_in->num_nodes; k++)
-		{
-			members[worst_members[(*index)]][k] = offspring2[k];
+		cost += eax_merge_subtours(tsp_in, cand, eax);
 
-			if (tsp_in->integerDist)
-			{
-				int x;
-				dist(offspring2[k], offspring2[(k + 1) % tsp_in->num_nodes], tsp_in, &x);
+		if (cost < best_cost - EPS)
+		{
+			best_cost = cost;
 
-				fitness += (double)x;
-			}
-			else
+			//sequence of visited nodes of the offspring
+			int prev = -1;
+			int node = 0;
+			for (i = 0; i < n; i++)
 			{
-				double x;
-				dist(offspring2[k], offspring2[(k + 1) % tsp_in->num_nodes], tsp_in, &x);
-
-				fitness += x;
+				offspring[i] = node;
+				int next = (link[2 * node] != prev) ? link[2 * node] : link[2 * node + 1];
+				prev = node;
+				node = next;
 			}
 		}
+	}
 
-		free(offspring2);
-		greedy_refinement(tsp_in, members[worst_members[*index]], &fitness);
+	for (i = 0; i < length; i += 2)
+		eax->path_index[eax->path[i]] = -1;
 
-		if (tsp_in->integerDist)
-		{
-			if ((int)fitness < tsp_in->bestCostI)
-			{
-				tsp_in->bestCostI = (int)fitness;
-				(*best_index) = worst_members[(*index)];
-			}
-		}
-		else
+	return best_cost;
+}
+
+int eax_next_ab_cycle(eax_workspace* eax, rng_state* rng, int num_nodes, int* first, int* length)
+{
+	//the walk restarts from a random node if its last node has no more edges
+	if (*length == 1 && eax->num_diff_a[eax->path[0]] == 0)
+	{
+		eax->path_index[eax->path[0]] = -1;
+		*length = 0;
+	}
+
+	if (*length == 0)
+	{
+		int start = rng_int(rng, num_nodes);
+		int count = 0;
+
+		while (eax->num_diff_a[start] == 0 && count < num_nodes)
 		{
-			if (fitness < tsp_in->bestCostD)
-			{
-				tsp_in->bestCostD = fitness;
-				(*best_index) = worst_members[(*index)];
-			}
+			start = (start + 1) % num_nodes;
+			count++;
 		}
 
-		(*sum_prob) += ((1000.0 / fitness) - (1000.0 / fitnesses[worst_members[(*index)]]));
-		(*sum_fitnesses) += (fitness - fitnesses[worst_members[(*index)]]);
-		fitnesses[worst_members[(*index)]] = fitness;
-		worst_members[(*index)] = -1;
-		(*index)++;
+		if (count == num_nodes)
+			return 0;
 
+		eax->path[0] = start;
+		eax->path_index[start] = 0;
+		*length = 1;
 	}
-	//printf("Index: %d   ", *index);
-}
-
-void mutation(tsp_instance* tsp_in, int** members, double* fitnesses, int* best_index,
-	          int* worst_members, double* sum_prob, double* sum_fitnesses, int seed, int* index)
-{
-	srand(seed);
 
-	int i = 0;
-	for (; i < NUM_WORST_MEMBERS; i++)
+	//alternating walk (A-edge, B-edge, ...) until it reaches a node already reached by a B-edge
+	while (1)
 	{
-		int j = 0;
-		double dad = (double)(rand() % ((int)((*sum_prob) * 100000.0)));
-		int dad_index;
+		int u = eax->path[*length - 1];
+		int w = eax_take_edge(eax->diff_a, eax->num_diff_a, u, rng);
+		eax->path[(*length)++] = w;
 
-		double sum_ranges = 0.0;
+		int x = eax_take_edge(eax->diff_b, eax->num_diff_b, w, rng);
+		eax->path[(*length)++] = x;
 
-		//1/fitness[i]
-		for (j = 0; j < POPULATION_SIZE; j++)
+		if (eax->path_index[x] != -1)
 		{
-			if (((100000000.0 / ((*sum_prob) * fitnesses[j])) + sum_ranges) > dad)
-			{
-				dad_index = j;
-				break;
-			}
-
-			sum_ranges += (100000000.0 / ((*sum_prob) * fitnesses[j]));
+			*first = eax->path_index[x];
+			return 1;
 		}
 
-		double start_choice = (double)(rand() % 100);
-		double end_choice = (double)(rand() % 100);
-		int start_range = -1;
-		int end_range = -1;
-		double node_range = 200.0 / tsp_in->num_nodes;
-		int found_start = 0;
-		int found_end = 0;
+		eax->path_index[x] = *length - 1;
+	}
+}
 
-		for (j = 0; j < tsp_in->num_nodes; j++)
-		{
-			if ((node_range * (j + 1)) > start_choice && !found_start)
-			{
-				start_range = j;
-				found_start = 1;
-			}
+int eax_take_edge(int* diff, int* num_diff, int u, rng_state* rng)
+{
+	int k = (num_diff[u] == 2) ? rng_int(rng, 2) : 0;
+	int w = diff[2 * u + k];
 
-			if ((node_range * (j + 1)) > end_choice && !found_end)
-			{
-				end_range = j + (int)((double)tsp_in->num_nodes / 2);
-				found_end = 1;
-			}
+	diff[2 * u + k] = diff[2 * u + num_diff[u] - 1];
+	num_diff[u]--;
 
-			if (found_start && found_end)
-				break;
+	//the edge is removed also from the list of the other endpoint
+	k = (diff[2 * w] == u) ? 0 : 1;
+	diff[2 * w + k] = diff[2 * w + num_diff[w] - 1];
+	num_diff[w]--;
 
-		}
+	return w;
+}
 
-		int* offspring = (int*)calloc((size_t)tsp_in->num_nodes, sizeof(int));
-		j = 0;
-		start_range = (int)(((double)tsp_in->num_nodes) / 2.0);
-		end_range = (int)(((double)tsp_in->num_nodes));
+double eax_merge_subtours(tsp_instance* tsp_in, candidate_list* cand, eax_workspace* eax)
+{
+	int n = tsp_in->num_nodes;
+	int* link = eax->link;
+	int* subtour = eax->subtour;
+	double delta = 0.0;
 
-		for (j = start_range; j < end_range; j++)
+	//label of the subtour of each node
+	int num_subtours = 0;
+	int i;
+	for (i = 0; i < n; i++)
+		subtour[i] = -1;
+
+	for (i = 0; i < n; i++)
+	{
+		if (subtour[i] != -1)
+			continue;
+
+		eax->subtour_size[num_subtours] = 0;
+		eax->subtour_node[num_subtours] = i;
+
+		int prev = -1;
+		int node = i;
+		do
 		{
-			offspring[j] = members[dad_index][end_range - 1 - j + start_range];
-		}
+			subtour[node] = num_subtours;
+			eax->subtour_size[num_subtours]++;
+			int next = (link[2 * node] != prev) ? link[2 * node] : link[2 * node + 1];
+			prev = node;
+			node = next;
+		} while (node != i);
 
-		for (j = 0; j < start_range; j++)
+		num_subtours++;
+	}
+
+	int num_labels = num_subtours;
+
+	while (num_subtours > 1)
+	{
+		//the smallest subtour is merged with another one by the best 2-exchange
+		int label = -1;
+		for (i = 0; i < num_labels; i++)
 		{
-			offspring[j] = members[dad_index][j];
+			if (eax->subtour_size[i] > 0 && (label == -1 || eax->subtour_size[i] < eax->subtour_size[label]))
+				label = i;
 		}
 
-		for (j = end_range; j < tsp_in->num_nodes; j++)
+		int size = 0;
+		int prev = -1;
+		int node = eax->subtour_node[label];
+		do
 		{
-			offspring[j] = members[dad_index][j];
-		}
+			eax->nodes[size++] = node;
+			int next = (link[2 * node] != prev) ? link[2 * node] : link[2 * node + 1];
+			prev = node;
+			node = next;
+		} while (node != eax->subtour_node[label]);
 
-		int k;
-		double fitness = 0.0;
+		double best_delta = DBL_MAX;
+		int best_u = -1, best_u2 = -1, best_v = -1, best_v2 = -1;
 
-		for (k = 0; k < tsp_in->num_nodes; k++)
+		int h;
+		for (h = 0; h < size; h++)
 		{
-			members[worst_members[(*index)]][k] = offspring[k];
+			int u = eax->nodes[h];
 
-			if (tsp_in->integerDist)
+			int c;
+			for (c = 0; c < cand->k; c++)
 			{
-				int x;
-				dist(offspring[k], offspring[(k + 1) % tsp_in->num_nodes], tsp_in, &x);
+				int v = cand->nodes[(size_t)u * cand->k + c];
 
-				fitness += (double)x;
-			}
-			else
-			{
-				double x;
-				dist(offspring[k], offspring[(k + 1) % tsp_in->num_nodes], tsp_in, &x);
+				if (subtour[v] == label)
+					continue;
 
-				fitness += x;
+				eax_best_exchange(tsp_in, link, u, v, &best_delta, &best_u, &best_u2, &best_v, &best_v2);
 			}
 		}
 
-		free(offspring);
-		greedy_refinement(tsp_in, members[worst_members[*index]], &fitness);
-
-		if (tsp_in->integerDist)
-		{
-			if ((int)fitness < tsp_in->bestCostI)
-			{
-				tsp_in->bestCostI = (int)fitness;
-				(*best_index) = worst_members[(*index)];
-			}
-		}
-		else
+		//no candidate in another subtour: all the other nodes are considered
+		if (best_u == -1)
 		{
-			if (fitness < tsp_in->bestCostD)
+			for (h = 0; h < size; h++)
 			{
-				tsp_in->bestCostD = fitness;
-				(*best_index) = worst_members[(*index)];
+				int v;
+				for (v = 0; v < n; v++)
+				{
+					if (subtour[v] != label)
+						eax_best_exchange(tsp_in, link, eax->nodes[h], v, &best_delta, &best_u, &best_u2, &best_v, &best_v2);
+				}
 			}
 		}
 
-		(*sum_prob) += ((1000.0 / fitness) - (1000.0 / fitnesses[worst_members[(*index)]]));
-		(*sum_fitnesses) += (fitness - fitnesses[worst_members[(*index)]]);
-		fitnesses[worst_members[(*index)]] = fitness;
-		worst_members[(*index)] = -1;
-		(*index)++;
+		//(u,u2) and (v,v2) are replaced by (u,v) and (u2,v2)
+		link[2 * best_u + (link[2 * best_u] == best_u2 ? 0 : 1)] = best_v;
+		link[2 * best_v + (link[2 * best_v] == best_v2 ? 0 : 1)] = best_u;
+		link[2 * best_u2 + (link[2 * best_u2] == best_u ? 0 : 1)] = best_v2;
+		link[2 * best_v2 + (link[2 * best_v2] == best_v ? 0 : 1)] = best_u2;
+		delta += best_delta;
+
+		int merged = subtour[best_v];
+		for (h = 0; h < size; h++)
+			subtour[eax->nodes[h]] = merged;
+
+		eax->subtour_size[merged] += size;
+		eax->subtour_size[label] = 0;
+		num_subtours--;
 	}
-	//printf("Index: %d   ", *index);
+
+	return delta;
 }
 
-void update_worst(double* fitnesses, int* worst_members)
+void eax_best_exchange(tsp_instance* tsp_in, int* link, int u, int v, double* best_delta, int* best_u, int* best_u2, int* best_v, int* best_v2)
 {
-	int i = 0;
-	int size = 0;
-
-	for (; i < POPULATION_SIZE; i++)
+	int k, h;
+	for (k = 0; k < 2; k++)
 	{
-		int j = 0;
-		int found_worst = 0;
+		int u2 = link[2 * u + k];
+		double removed_u = edge_cost(tsp_in, u, u2);
 
-		for (; j <= size; j++)
+		for (h = 0; h < 2; h++)
 		{
-			if (worst_members[j] == -1)
-				break;
+			int v2 = link[2 * v + h];
+			double delta = edge_cost(tsp_in, u, v) + edge_cost(tsp_in, u2, v2) - removed_u - edge_cost(tsp_in, v, v2);
 
-			if (fitnesses[worst_members[j]] < fitnesses[i])
+			if (delta < *best_delta)
 			{
-				found_worst = 1;
-				break;
+				*best_delta = delta;
+				*best_u = u;
+				*best_u2 = u2;
+				*best_v = v;
+				*best_v2 = v2;
 			}
 		}
+	}
+}
 
-		if (j < NUM_WORST_MEMBERS)
+void commit_offspring(population* pop, int* best_index, double* sum_fitnesses)
+{
+	double best_cost = pop->fitnesses[*best_index];
+
+	int slot;
+	for (slot = 0; slot < pop->num_slots; slot++)
+	{
+		int index = pop->next_index[slot];
+		double fitness = pop->next_fitnesses[slot];
+
+		if (index == -1)
+			continue;
+
+		if (fitness < best_cost)
 		{
-			int k = j;
+			best_cost = fitness;
+			(*best_index) = index;
+		}
+
+		(*sum_fitnesses) += (fitness - pop->fitnesses[index]);
+	}
+
+	population_commit(pop, pop->num_slots);
+}
+
+void island_evolution(void* param)
+{
+	island* isl = (island*)param;
+	tsp_instance* tsp_in = isl->tsp_in;
+	population* pop = &(isl->pop);
+
+	//the island generates all its offspring in its own thread
+	offspring_args args;
+	offspring_args_init(&args, tsp_in, pop, isl->worst_members, isl->cand, isl->timer);
+	args.first_slot = 0;
+	args.last_slot = pop->num_slots;
+	args.parents = (int*)calloc((size_t)pop->num_members, sizeof(int));
+	rng_stream(&(args.rng), (uint64_t)tsp_in->seed, (uint64_t)(tsp_in->population_size + isl->id + 1));
+
+	tour_archive archive;
+	archive_init(&archive, tsp_in->num_nodes, 0);
+	archive_population(&archive, pop, args.dad);
+	args.archive = &archive;
+
+	isl->num_generations = 0;
+	isl->num_migrants = 0;
+
+	progress_source source;
+	progress_source_init(&source);
+
+	while (time_left(isl->timer) > 0)
+	{
+		population_worst(pop, isl->worst_members);
+
+		#ifdef EAX_CROSSOVER
+		args.crossover = 1;
+		population_permutation(pop, args.parents, &(args.rng));
+		#else
+		args.crossover = (isl->num_generations % 5 == 0);
+		#endif
+		offspring_worker((void*)&args);
 
-			for (j = size; found_worst && j > k; j--)
-				worst_members[j] = worst_members[j - 1];
+		commit_offspring(pop, &(isl->best_index), &(isl->sum_fitnesses));
+		isl->num_generations++;
 
-			worst_members[j] = i;
-			size = (size == (NUM_WORST_MEMBERS - 1)) ? size : (size + 1);
+		//the best member of the island is sent to the next island of the ring
+		if (isl->num_generations % tsp_in->migration_interval == 0)
+		{
+			population_load(pop, isl->best_index, args.dad);
+			migration_queue_push(isl->next_queue, args.dad, pop->fitnesses[isl->best_index]);
 		}
+
+		double fitness;
+		while (migration_queue_pop(&(isl->queue), args.dad, &fitness))
+			migrate_member(isl, args.dad, fitness);
+
+		progress_post(&source, isl->num_generations, pop->fitnesses[isl->best_index], isl->sum_fitnesses / (double)pop->num_members,
+			time_left(isl->timer));
 	}
 
-	/*
-	for(i=0; i<1000; i++)
-		printf("[%d] worst_member: %2d    fitness: %.2lf\n", i, worst_members[i], fitnesses[worst_members[i]]);
-	*/
-}
\ No newline at end of file
+	offspring_args_free(&args);
+	archive_free(&archive);
+	free(args.parents);
+}
+
+void migrate_member(island* isl, int* visited_nodes, double fitness)
+{
+	population* pop = &(isl->pop);
+
+	int worst = 0;
+	int i;
+	for (i = 1; i < pop->num_members; i++)
+	{
+		if (pop->fitnesses[i] > pop->fitnesses[worst])
+			worst = i;
+	}
+
+	if (fitness >= pop->fitnesses[worst])
+		return;
+
+	isl->sum_fitnesses += (fitness - pop->fitnesses[worst]);
+	population_replace(pop, worst, visited_nodes, fitness);
+	isl->num_migrants++;
+
+	if (fitness < pop->fitnesses[isl->best_index])
+		isl->best_index = worst;
+}
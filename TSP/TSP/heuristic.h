@@ -10,6 +10,14 @@
 
 #include "tsp.h"
 #include "utility.h"
+#include "rng.h"
+#include "candidate.h"
+#include "population.h"
+#include "threadpool.h"
+#include "incumbent.h"
+#include "timer.h"
+#include "progress.h"
+#include "archive.h"
 #include <time.h>
 #include <float.h>
 #include <math.h>
@@ -17,47 +25,197 @@
 #define HAVE_STRUCT_TIMESPEC
 #include <pthread.h>
 //#define MULTI_START //Comment or not if you want multistart or not
+#define WINDOW_REFINEMENT //Comment or not if you want the new best tours of VNS and tabu search and the offspring refined also by exact windows
+#define GPX_MERGE //Comment or not if you want the tour of each start merged with the incumbent by partition crossover (MULTI_START)
+#define LOWER_BOUND //Comment or not if you want the Held-Karp lower bound computed during the solver (gap reported, stop if the incumbent is optimal)
 
 #define STEP_SEED 100
-#define NUM_MULTI_START 12 //Number of threads in multi start and for construction in Genetic
-#define POPULATION_SIZE 12000 //Size of the population
-#define NUM_WORST_MEMBERS 1000 //Size of the buffer with indices of worst members in the population
+#define CONSTRUCTION_CHUNKS 4 //Number of construction jobs of the genetic algorithm for each thread of the pool
+#define NUM_WORST_MEMBERS 1000 //Size of the buffer with indices of worst members in the population (offspring of each generation)
+#define MIN_ISLAND_SIZE 4 //Minimum number of members of an island in the island model
+#define EAX_CROSSOVER //Comment or not if you want the order crossover and mutation (with greedy refinement) or the EAX crossover
+#define EAX_NUM_TRIALS 10 //Number of AB-cycles tried for each offspring of the EAX crossover
 #define FIXED_TIME_MS
 //#define UNIFORM_PROB
 
 typedef struct
 {
 	tsp_instance* tsp_in; //pointer to tsp instance
-	int* succ; //pointer to the best visited nodes sequence
+	incumbent* best; //best visited nodes sequence of all the threads
 	int seed; //seed used by each thread
-	time_t start;
+	deadline_timer* timer; //deadline of the solver
+	tour_archive* archive; //seen and elite tours of all the starts (NULL without MULTI_START)
 }thread_args;
 
 typedef struct
 {
 	tsp_instance* tsp_in; //pointer to tsp instance
-	int** members; //members of the population
+	incumbent* best; //best visited nodes sequence of all the starts
+	deadline_timer* timer; //deadline of the solver
+	thread_pool* pool; //pool that executes the starts
+	int next_seed; //index of the next start (atomic)
+	progress_source source; //source of the progress samples of all the starts (posted under the mutex)
+	tour_archive archive; //seen and elite tours of all the starts
+}multi_start_params;
+
+typedef struct
+{
+	tsp_instance* tsp_in; //pointer to tsp instance
+	population* pop; //population of the genetic algorithm
+	int population_size; //members of the whole population (of all the islands)
 	int num_members;
 	int first_index;
-	double* fitnesses; //costs of each
+	int first_stream; //stream of the generator of the member first_index (distinct for all the members of all the islands)
 	int* num_instances;
 	double* sum_fitnesses;
-	double* sum_prob;
 	int* best_index;
 }construction_args;
 
+typedef struct
+{
+	int* adj_a; //neighbors of each node in the first parent (2 x num_nodes)
+	int* adj_b; //neighbors of each node in the second parent (2 x num_nodes)
+	int* link; //neighbors of each node in the intermediate solution (2 x num_nodes, -1 if missing)
+	int* diff_a; //edges of the first parent not in the second one, not yet in an AB-cycle (2 x num_nodes)
+	int* diff_b; //edges of the second parent not in the first one, not yet in an AB-cycle (2 x num_nodes)
+	int* num_diff_a; //number of edges in diff_a of each node
+	int* num_diff_b; //number of edges in diff_b of each node
+	int* path; //nodes of the alternating walk
+	int* path_index; //position of each node in path (after a B-edge), -1 if not in path
+	int* subtour; //label of the subtour of each node in the intermediate solution
+	int* subtour_size; //number of nodes of each subtour (0 if already merged)
+	int* subtour_node; //a node of each subtour
+	int* nodes; //nodes of the subtour to merge
+} eax_workspace;
+
+typedef struct
+{
+	tsp_instance* tsp_in; //pointer to tsp instance
+	population* pop; //population of the genetic algorithm
+	candidate_list* cand; //candidate lists of the nodes (EAX crossover)
+	eax_workspace eax; //scratch of the EAX crossover of the thread
+	int* parents; //permutation of the members, member parents[i] is crossed with parents[i+1] (EAX crossover)
+	int* worst_members; //indices of the members replaced by the offspring (one for each slot)
+	int crossover; //1 if the offspring are generated by crossover, 0 if by mutation
+	int first_slot; //first slot of the offspring generated by the thread
+	int last_slot; //last slot (excluded) of the offspring generated by the thread
+	rng_state rng; //generator of the thread
+	int* dad; //scratch tours of the thread
+	int* mom;
+	int* offspring1;
+	int* offspring2;
+	char* in_offspring1; //1 if the node is already in offspring1, 0 otherwise
+	char* in_offspring2;
+	tour_archive* archive; //seen tours of the genetic algorithm (the duplicated offspring are discarded)
+	deadline_timer* timer; //deadline of the genetic algorithm (window refinement of the offspring)
+}offspring_args;
+
+typedef struct
+{
+	tsp_instance* tsp_in; //pointer to tsp instance
+	int id; //index of the island in the ring
+	population pop; //sub-population of the island
+	int* worst_members; //indices of the worst members of the sub-population
+	double sum_fitnesses; //sum of the fitnesses of the sub-population
+	int best_index; //index of the best member of the sub-population
+	migration_queue queue; //migrants received from the previous island of the ring
+	migration_queue* next_queue; //queue of the next island of the ring
+	candidate_list* cand; //candidate lists of the nodes (shared by all the islands)
+	int num_generations;
+	int num_migrants; //number of received migrants inserted in the sub-population
+	deadline_timer* timer; //deadline of the genetic algorithm
+}island;
+
 typedef struct
 {
 	int end_list;//-1
 	int start_list; //0
 } tabu_list_params;
 
+typedef struct
+{
+	int type; //0 = 2-opt, 1 = Or-opt
+	int a, b, c, d; //2-opt: edges (a,b) (c,d) replaced by (a,c) (b,d); Or-opt: segment inserted between c and d
+	int p, s1, s2, nx; //Or-opt: segment s1...s2 between p and nx in the tour
+	int reversed; //Or-opt: 1 if the segment is inserted reversed (c,s2) (s1,d), 0 otherwise (c,s1) (s2,d)
+} sa_move;
+
+typedef struct
+{
+	int* tour; //current sequence of visited nodes of the chain
+	int* pos; //position of each node in tour
+	double cost; //cost of tour
+	int* best_tour; //best sequence of visited nodes found by the chain
+	double best_cost; //cost of the best sequence
+	int best_is_current; //1 if the best sequence is tour (best_tour is updated only before leaving it)
+	rng_state rng; //generator of the chain
+	long long num_moves; //number of moves tried by the chain
+	long long num_accepted; //number of moves accepted by the chain
+} sa_chain;
+
+typedef struct
+{
+	tsp_instance* tsp_in; //pointer to tsp instance
+	candidate_list* cand; //candidate list of each node
+	double* exp_table; //table of exp(-x) used by the Metropolis test
+	pthread_barrier_t barrier; //synchronization of the replicas before and after the exchanges
+	int num_replicas; //number of replicas, one for each thread
+	double* inverse_t; //inverse of each temperature of the ladder, from the coldest to the hottest one
+	int* replica; //index of the replica at each temperature of the ladder
+	int* temperature; //index in the ladder of the temperature of each replica
+	double* costs; //current cost of each replica
+	double* best_costs; //best cost found by each replica
+	double best_cost; //best cost found by all the replicas (updated by the exchanges)
+	progress_source source; //progress reports of the exchanges
+	rng_state rng; //generator used for the exchanges
+	int round; //number of exchange rounds (even rounds try pairs (0,1) (2,3)..., odd rounds (1,2) (3,4)...)
+	int num_attempts; //number of tried exchanges
+	int num_swaps; //number of accepted exchanges
+	int stop; //1 if the time limit is reached
+	deadline_timer timer; //deadline of the parallel tempering
+} tempering_params;
+
+typedef struct
+{
+	tempering_params* params; //parameters shared by all the replicas
+	int id; //index of the replica
+	sa_chain chain; //chain of the replica
+} replica_args;
+
+typedef struct
+{
+	tsp_instance* tsp_in; //pointer to tsp instance
+	tour_archive* archive; //seen and elite tours shared by all the workers
+	int* visited_nodes; //starting sequence of visited nodes, at the end the best one found by the worker
+	double cost; //cost of visited_nodes
+	int id; //index of the worker
+	rng_state rng; //generator of the worker
+	int min_tenure; //min dimension of the tabu list of the worker
+	int max_tenure; //max dimension of the tabu list of the worker
+	deadline_timer* timer; //deadline shared by all the workers
+	int num_restarts; //number of restarts from the elite pool done by the worker
+	progress_source source; //progress reports of the worker
+} tabu_worker_args;
+
 #define GRASP
 #define MAX_LOCAL_MINS 200
 #define MAX_NUM_ITERATIONS 1000
 #define CONSTRUCTION_TYPE 0	// 0 = nearest neighborhood algorithm, 1 = insertion algorithm
 #define REACTIVE //define for use the reactive tabu search
 #define MAX_NUM_EPOCHS 100
+#define ELITE_POOL_SIZE 20 //Max number of elite tours in the archive of the parallel tabu search and of the multi start
+#define MAX_RESTART_KICKS 10 //Kicks of elite tours tried by a restart before refining a tour already seen
+#define STAGNATION_ITERATIONS 100 //Iterations without improvement before a tabu worker restarts from the elite pool
+#define SA_TIME_CHECK 1024 //Moves of the simulated annealing between two checks of the remaining time
+#define MAX_OR_OPT 3 //Max length of the segment moved by an Or-opt move
+#define EXP_TABLE_MAX 20.0 //exp(-x) is approximated by 0 for x >= EXP_TABLE_MAX
+#define EXP_TABLE_SIZE 20480 //Number of entries of the table with the values of exp(-x)
+#define SA_CALIBRATION_MOVES 1000 //Moves sampled from the starting tour to calibrate the temperatures of the annealing
+#define SA_START_ACCEPTANCE 0.5 //Probability of accepting the average uphill move at the starting temperature
+#define SA_END_ACCEPTANCE 1e-6 //Probability of accepting the smallest sampled uphill move at the final temperature (at the deadline)
+#define SA_STAGNATION 0.1 //Fraction of the deadline without improvements of the best tour that triggers a reheat
+#define SA_REHEAT_LIMIT 0.8 //Fraction of the deadline after which the annealing is not reheated anymore
+#define PT_SWAP_INTERVAL 10000 //Moves of each replica of the parallel tempering between two exchange rounds
 
 /**
 	@brief Compute the solution of the instance invoking the correct function (MULTITHREADING).
@@ -66,6 +224,22 @@ typedef struct
 
 void* computeSolution(void* param);
 
+/**
+	@brief Compute a start of the multi start with the next seed and, if there is still time, submit the next start to the pool.
+	@param param parameters shared by all the starts (multi_start_params)
+*/
+
+void multi_start_job(void* param);
+
+/**
+	@brief Merge the tour of a start with the incumbent by partition crossover (MULTI_START with GPX_MERGE).
+	@param tsp_in reference to tsp instance structure
+	@param best incumbent of all the starts
+	@param visited_nodes sequence of the visited nodes of the start, replaced by the offspring if it is better
+	@param best_cost cost of the tour of the start, replaced by the cost of the offspring if it is better
+*/
+void gpx_merge(tsp_instance* tsp_in, incumbent* best, int* visited_nodes, double* best_cost);
+
 /**
 	@brief Heuristic solver, call the select algorithm.
 	@param tsp_in reference to tsp instance structure
@@ -75,14 +249,16 @@ void heuristic_solver(tsp_instance* tsp_in);
 /**
 	@brief Insertion algorithm.
 	@param tsp_in reference to tsp instance structure
+	@param rng generator of the thread, for the GRASP option
 */
-void insertion(tsp_instance* tsp_in, int* visited_nodes, double* best_cost, int seed, int first_node);
+void insertion(tsp_instance* tsp_in, int* visited_nodes, double* best_cost, rng_state* rng, int first_node);
 
 /**
 	@brief Nearest neighborhood algorithm.
 	@param tsp_in reference to tsp instance structure
+	@param rng generator of the thread, for the GRASP option
 */
-void nearest_neighborhood(tsp_instance* tsp_in, int* visited_nodes, double* best_cost, int seed, int first_node);
+void nearest_neighborhood(tsp_instance* tsp_in, int* visited_nodes, double* best_cost, rng_state* rng, int first_node);
 
 /**
 	@brief find the free node at the min distance.
@@ -91,10 +267,10 @@ void nearest_neighborhood(tsp_instance* tsp_in, int* visited_nodes, double* best
 	@param i starting node
 	@param min_dist at the end, it will contain the minimum distance find 
 	@param best at the end, it will contain the position of the node find
-	@param seed random seed for the GRASP option
+	@param rng generator of the thread, for the GRASP option
 */
 
-void min_cost(tsp_instance* tsp_in, int* nodes, int i, double* min_dist, int* best, int seed);
+void min_cost(tsp_instance* tsp_in, int* nodes, int i, double* min_dist, int* best, rng_state* rng);
 
 /**
 	@brief Compute the minimum extra-mileage.
@@ -108,10 +284,22 @@ void min_cost(tsp_instance* tsp_in, int* nodes, int i, double* min_dist, int* be
 	@param k_best node to insert
 	@param best_cost_h variation of the cost 
 	@param best_cost final cost of the tour
-	@param seed random seed for the GRASP option
+	@param rng generator of the thread, for the GRASP option
 */
 
-void min_extra_mileage(tsp_instance* tsp_in, int count, int* visited_nodes, int* node1, int* node2, double* costs, int* i_best, int* k_best, double* best_cost_h, double* best_cost, int seed);
+void min_extra_mileage(tsp_instance* tsp_in, int count, int* visited_nodes, int* node1, int* node2, double* costs, int* i_best, int* k_best, double* best_cost_h, double* best_cost, rng_state* rng);
+
+/**
+	@brief Compute the extra-mileage of the insertion of a node in an edge of the tour.
+	@param tsp_in reference to tsp instance structure
+	@param node node to insert
+	@param node1 first node of the edge
+	@param node2 second node of the edge
+	@param cost cost of the edge (node1, node2)
+	@return variation of the cost of the tour
+*/
+
+double extra_mileage(tsp_instance* tsp_in, int node, int node1, int node2, double cost);
 
 /**
 	@brief Compute a 2-opt refinement to the actual solution
@@ -130,9 +318,10 @@ void greedy_refinement(tsp_instance* tsp_in, int* visited_nodes, double * cost);
 	@param visited_nodes array with sequence of the visited nodes
 	@param best_cost cost of the solution
 	@param deadline time limit
+	@param rng generator of the thread
 */
 
-void hybrid_vns(tsp_instance* tsp_in, int* visited_nodes, double* best_cost, double deadline);
+void hybrid_vns(tsp_instance* tsp_in, int* visited_nodes, double* best_cost, double deadline, rng_state* rng);
 
 /**
 	@brief Find the k-opt sequence at the minimun distance
@@ -153,9 +342,10 @@ int min_kopt_sequence(tsp_instance* tsp_in, int* kopt_visited_nodes, double* kop
 	@param local_cost cost of the local minimun
 	@param inverse_costs array with the inverse costs
 	@param inverse_costs_sum sum of the inverse costs
+	@param rng generator of the thread
 */
 
-int new_random_sol(tsp_instance* tsp_in, int* local_min_visited_nodes, double* local_cost, double** inverse_costs, double* inverse_costs_sum);
+int new_random_sol(tsp_instance* tsp_in, int* local_min_visited_nodes, double* local_cost, double** inverse_costs, double* inverse_costs_sum, rng_state* rng);
 
 /**
 	@brief Update the array with the solution.
@@ -234,15 +424,203 @@ int check_tabu_list(int** tabu_list, int tenure, int node1, int node2);
 
 double move2opt_for_tabu_search(tsp_instance* tsp_in, int* succ, int** tabu_list, int* tenure, tabu_list_params* params);
 
+/**
+	@brief Compute the parallel Tabu Search, with one worker for each thread and a shared pool of elite solutions.
+	@param tsp_in reference to tsp instance structure
+	@param visited_nodes array with sequence of the visited nodes
+	@param best_cost cost of the solution
+	@param deadline time limit
+	@param rng generator of the thread, that seeds the generators of the workers
+*/
+
+void parallel_tabu_search(tsp_instance* tsp_in, int* visited_nodes, double* best_cost, double deadline, rng_state* rng);
+
+/**
+	@brief Worker of the parallel Tabu Search, with its own tabu list and tenure (MULTITHREADING).
+	@param param pointer to a tabu_worker_args structure
+*/
+
+void* tabu_worker(void* param);
+
+/**
+	@brief Copy a random elite tour of the archive and diversify it with a double bridge kick (thread safe).
+	The kicked tours already seen are discarded (up to MAX_RESTART_KICKS times), since their refinement is known.
+	@param tsp_in reference to tsp instance structure
+	@param archive reference to the archive
+	@param visited_nodes on return, sequence of the visited nodes of the diversified tour
+	@param cost on return, cost of the diversified tour
+	@param rng generator of the worker
+	@return 1 if the tour is replaced, 0 if the archive has no elite tours
+*/
+
+int archive_restart(tsp_instance* tsp_in, tour_archive* archive, int* visited_nodes, double* cost, rng_state* rng);
+
+/**
+	@brief Compute the cost of a tour.
+	@param tsp_in reference to tsp instance structure
+	@param visited_nodes array with sequence of the visited nodes
+*/
+
+double tour_cost(tsp_instance* tsp_in, int* visited_nodes);
+
+/**
+	@brief Apply a random double bridge move (segments A B C D become A C B D) to a tour.
+	@param tsp_in reference to tsp instance structure
+	@param visited_nodes array with sequence of the visited nodes
+	@param cost cost of the tour, updated with the variation
+	@param rng generator of the thread
+*/
+
+void double_bridge_kick(tsp_instance* tsp_in, int* visited_nodes, double* cost, rng_state* rng);
+
 /**
 	@brief Compute the Simulated Annealing algorithm.
 	@param tsp_in reference to tsp instance structure
 	@param visited_nodes array with sequence of the visited nodes
 	@param best_cost cost of the solution
 	@param deadline time limit
+	@param rng generator of the thread, that seeds the chain
+*/
+
+void simulated_annealing(tsp_instance* tsp_in, int* visited_nodes, double* best_cost, double deadline, rng_state* rng);
+
+/**
+	@brief Compute the Parallel Tempering (replica exchange), with one annealing chain for each thread at a ladder of temperatures.
+	@param tsp_in reference to tsp instance structure
+	@param visited_nodes array with sequence of the visited nodes
+	@param best_cost cost of the solution
+	@param deadline time limit
+	@param rng generator of the thread, that seeds the chains of the replicas
+*/
+
+void parallel_tempering(tsp_instance* tsp_in, int* visited_nodes, double* best_cost, double deadline, rng_state* rng);
+
+/**
+	@brief Replica of the parallel tempering, that runs its chain at the temperature assigned at each exchange round (MULTITHREADING).
+	@param param pointer to a replica_args structure
+*/
+
+void* tempering_replica(void* param);
+
+/**
+	@brief Try the exchanges of temperature between adjacent replicas of the ladder, post the best cost of the replicas and check the time limit.
+	@param pt parameters shared by the replicas
+*/
+
+void tempering_exchange(tempering_params* pt);
+
+/**
+	@brief Calibrate the starting and final temperatures of the annealing from the uphill moves sampled around the tour of a chain.
+	@param tsp_in reference to tsp instance structure
+	@param cand candidate list of each node
+	@param chain reference to the chain
+	@param t_start on return, temperature at which the average uphill move is accepted with probability SA_START_ACCEPTANCE
+	@param t_end on return, temperature at which the smallest sampled uphill move is accepted with probability SA_END_ACCEPTANCE
 */
 
-void simulated_annealing(tsp_instance* tsp_in, int* visited_nodes, double* best_cost, double deadline);
+void sa_calibrate(tsp_instance* tsp_in, candidate_list* cand, sa_chain* chain, double* t_start, double* t_end);
+
+/**
+	@brief Initialize an annealing chain that starts from a tour.
+	@param chain reference to the chain
+	@param visited_nodes array with sequence of the visited nodes
+	@param cost cost of the tour
+	@param num_nodes number of nodes in the problem
+	@param seed seed of the generator of the chain
+*/
+
+void sa_chain_init(sa_chain* chain, int* visited_nodes, double cost, int num_nodes, uint64_t seed);
+
+/**
+	@brief Run a number of Metropolis moves of an annealing chain at a fixed temperature.
+	@param tsp_in reference to tsp instance structure
+	@param cand candidate list of each node
+	@param exp_table table built by build_exp_table
+	@param chain reference to the chain
+	@param inverse_t inverse of the temperature
+	@param num_moves number of moves to try
+*/
+
+void sa_chain_run(tsp_instance* tsp_in, candidate_list* cand, double* exp_table, sa_chain* chain, double inverse_t, int num_moves);
+
+/**
+	@brief Store in best_tour the best sequence of the chain, if it is the current one, and remove rounding errors from best_cost.
+	@param tsp_in reference to tsp instance structure
+	@param chain reference to the chain
+*/
+
+void sa_chain_best(tsp_instance* tsp_in, sa_chain* chain);
+
+/**
+	@brief Deallocation of an annealing chain.
+	@param chain reference to the chain
+*/
+
+void sa_chain_free(sa_chain* chain);
+
+/**
+	@brief Sample a random 2-opt or Or-opt move, built from the candidate list of a random node, in O(1).
+	@param tsp_in reference to tsp instance structure
+	@param cand candidate list of each node
+	@param rng generator of the thread
+	@param tour sequence of the visited nodes
+	@param pos position of each node in tour
+	@param move on return, the sampled move
+	@return variation of the cost of the tour (DBL_MAX if the sampled move is not valid)
+*/
+
+double sa_random_move(tsp_instance* tsp_in, candidate_list* cand, rng_state* rng, int* tour, int* pos, sa_move* move);
+
+/**
+	@brief Apply a move sampled by sa_random_move.
+	@param tour sequence of the visited nodes
+	@param pos position of each node in tour
+	@param num_nodes number of nodes in the problem
+	@param move move to apply
+*/
+
+void sa_apply_move(int* tour, int* pos, int num_nodes, sa_move* move);
+
+/**
+	@brief Replace the edges (a,b) (c,d) with (a,c) (b,d), where a->b ... c->d in one of the two orientations of the tour
+	(the path from b to c is reversed, so d is not needed).
+	@param tour sequence of the visited nodes
+	@param pos position of each node in tour
+	@param num_nodes number of nodes in the problem
+	@param a first node of the first edge
+	@param b second node of the first edge
+	@param c first node of the second edge
+*/
+
+void two_opt_move(int* tour, int* pos, int num_nodes, int a, int b, int c);
+
+/**
+	@brief Reverse the nodes of the tour from position from to position to (going forward), or the complementary path if shorter.
+	@param tour sequence of the visited nodes
+	@param pos position of each node in tour
+	@param num_nodes number of nodes in the problem
+	@param from position of the first node of the path
+	@param to position of the last node of the path
+*/
+
+void tour_reverse(int* tour, int* pos, int num_nodes, int from, int to);
+
+/**
+	@brief Fill the table with the values of exp(-x) for x in [0, EXP_TABLE_MAX).
+	@param exp_table array of EXP_TABLE_SIZE elements
+*/
+
+void build_exp_table(double* exp_table);
+
+/**
+	@brief Metropolis acceptance test, return 1 if the move is accepted, 0 otherwise.
+	@param rng generator of the thread
+	@param exp_table table built by build_exp_table
+	@param delta variation of the cost
+	@param inverse_t inverse of the temperature
+*/
+
+int metropolis(rng_state* rng, double* exp_table, double delta, double inverse_t);
 
 /**
 	@brief Manage the genetic algorithm.
@@ -261,54 +639,186 @@ void construction(void* param);
 /**
 	@brief Compute the evolution of the genetic algorithm.
 	@param tsp_in reference to tsp instance structure
-	@param members visited nodes of each member of the population
-	@param fitnesses cost of the solution of each member of the population
+	@param pop population of the genetic algorithm
 	@param best_index index of the member with the minimum cost
 	@param worst_members array with the indices of members with maximum cost
-	@param sum_prob sum of the probabilities
 	@param sum_fitnesses sum of the fitnesses
-	@param start starting time of the computation
+	@param cand candidate lists of the nodes (used only by the EAX crossover)
+	@param timer deadline of the genetic algorithm
+	@param pool thread pool that generates the offspring
+*/
+
+void evolution(tsp_instance* tsp_in, population* pop, int* best_index, int* worst_members, double* sum_fitnesses, candidate_list* cand, deadline_timer* timer, thread_pool* pool);
+
+/**
+	@brief Allocate the scratch of a thread that generates offspring.
+	@param args information of the thread
+	@param tsp_in reference to tsp instance structure
+	@param pop population of the genetic algorithm
+	@param worst_members array with the indices of members with maximum cost
+	@param cand candidate lists of the nodes (used only by the EAX crossover)
+	@param timer deadline of the genetic algorithm
+*/
+
+void offspring_args_init(offspring_args* args, tsp_instance* tsp_in, population* pop, int* worst_members, candidate_list* cand, deadline_timer* timer);
+
+/**
+	@brief Free the scratch of a thread that generates offspring.
+	@param args information of the thread
+*/
+
+void offspring_args_free(offspring_args* args);
+
+/**
+	@brief Generate the offspring of a range of slots of the next generation (MULTITHREADING).
+	@param param information needed for the generation (offspring_args)
 */
 
-void evolution(tsp_instance* tsp_in, int** members, double* fitnesses, int* best_index, int* worst_members, double* sum_prob, double* sum_fitnesses, time_t start);
+void offspring_worker(void* param);
 
 /** 
 	@brief Compute the crossover in the evolution of the genetic algorithm.
+	The offspring are written in the slots of the thread in the next generation.
+	@param args information of the thread
+*/
+
+void crossover(offspring_args* args);
+
+/**
+	@brief Allocate the scratch of the EAX crossover.
+	@param eax reference to the scratch
+	@param num_nodes number of nodes
+*/
+
+void eax_workspace_init(eax_workspace* eax, int num_nodes);
+
+/**
+	@brief Free the scratch of the EAX crossover.
+	@param eax reference to the scratch
+*/
+
+void eax_workspace_free(eax_workspace* eax);
+
+/**
+	@brief Edge Assembly Crossover (single AB-cycle strategy).
+	For each of EAX_NUM_TRIALS AB-cycles (alternating edges of A not in B and of B not in A, built by a random walk),
+	the intermediate solution is A with the A-edges of the AB-cycle replaced by its B-edges,
+	and its subtours are merged by 2-exchanges towards candidate nodes; the best offspring is returned.
 	@param tsp_in reference to tsp instance structure
-	@param members visited nodes of each member of the population
-	@param fitnesses cost of the solution of each member of the population
-	@param best_index index of the member with the minimum cost
-	@param worst_members array with the indices of members with maximum cost
-	@param sum_prob sum of the probabilities
-	@param sum_fitnesses sum of the fitnesses
-	@param seed random seed
-	@param index first_index of worst_members
+	@param cand candidate lists of the nodes
+	@param eax scratch of the thread
+	@param rng generator of the thread
+	@param parent_a visited nodes of the first parent (A)
+	@param cost_a cost of the first parent
+	@param parent_b visited nodes of the second parent (B)
+	@param offspring on return, visited nodes of the offspring (already allocated)
+	@return cost of the offspring (cost_a if no offspring is better than A, and then offspring is A)
 */
 
-void crossover(tsp_instance* tsp_in, int** members, double* fitnesses, int* best_index, int* worst_members, double* sum_prob, double* sum_fitnesses, int seed, int* index);
+double eax_crossover(tsp_instance* tsp_in, candidate_list* cand, eax_workspace* eax, rng_state* rng,
+	                 int* parent_a, double cost_a, int* parent_b, int* offspring);
 
 /**
-	@brief Compute the mutation in the evolution of the genetic algorithm.
+	@brief Extend the alternating walk of the EAX crossover until it closes the next AB-cycle.
+	The AB-cycles built by consecutive calls are disjoint.
+	@param eax scratch of the thread (path and edges not yet in an AB-cycle)
+	@param rng generator of the thread
+	@param num_nodes number of nodes
+	@param first on return, position in eax->path of the first node of the AB-cycle
+	@param length length of the walk, on return the AB-cycle is in eax->path[first...length-1]
+	@return 1 if an AB-cycle is found, 0 if there are no more edges
+*/
+
+int eax_next_ab_cycle(eax_workspace* eax, rng_state* rng, int num_nodes, int* first, int* length);
+
+/**
+	@brief Remove a random edge of a node from the edges not yet in an AB-cycle.
+	@param diff edges of each node (2 x num_nodes)
+	@param num_diff number of edges of each node
+	@param u node
+	@param rng generator of the thread
+	@return other endpoint of the removed edge
+*/
+
+int eax_take_edge(int* diff, int* num_diff, int u, rng_state* rng);
+
+/**
+	@brief Merge the subtours of the intermediate solution of the EAX crossover (in eax->link) into a tour,
+	starting each time from the smallest subtour.
+	@param tsp_in reference to tsp instance structure
+	@param cand candidate lists of the nodes
+	@param eax scratch of the thread
+	@return variation of the cost due to the merges
+*/
+
+double eax_merge_subtours(tsp_instance* tsp_in, candidate_list* cand, eax_workspace* eax);
+
+/**
+	@brief Find the best 2-exchange that removes an edge of u and an edge of v (in different subtours)
+	and joins u with v, updating the best exchange found so far.
 	@param tsp_in reference to tsp instance structure
-	@param members visited nodes of each member of the population
-	@param fitnesses cost of the solution of each member of the population
+	@param link neighbors of each node in the intermediate solution
+	@param u node of the subtour to merge
+	@param v node of another subtour
+	@param best_delta variation of the cost of the best exchange
+	@param best_u, best_u2 edge of the subtour to merge removed by the best exchange
+	@param best_v, best_v2 edge of the other subtour removed by the best exchange
+*/
+
+void eax_best_exchange(tsp_instance* tsp_in, int* link, int u, int v, double* best_delta, int* best_u, int* best_u2, int* best_v, int* best_v2);
+
+/**
+	@brief Compute the mutation in the evolution of the genetic algorithm.
+	The offspring are written in the slots of the thread in the next generation.
+	@param args information of the thread
+*/
+
+void mutation(offspring_args* args);
+
+/**
+	@brief Refine an offspring with the greedy refinement, unless it is already in the seen tours of the genetic algorithm.
+	@param args information of the thread
+	@param offspring visited nodes of the offspring, replaced by the refined ones
+	@param fitness on return, cost of the offspring (after the refinement, if it was refined)
+	@return 1 if the refined offspring is a new tour, 0 if the offspring or its refinement were already seen
+*/
+
+int refine_offspring(offspring_args* args, int* offspring, double* fitness);
+
+/**
+	@brief Mark all the members of a population as seen tours.
+	@param archive reference to the archive
+	@param pop reference to the population
+	@param visited_nodes scratch tour of num_nodes elements
+*/
+
+void archive_population(tour_archive* archive, population* pop, int* visited_nodes);
+
+/**
+	@brief Move the offspring of the next generation into the population, updating the best member and the sum of the fitnesses.
+	@param pop population of the genetic algorithm
 	@param best_index index of the member with the minimum cost
-	@param worst_members array with the indices of members with maximum cost
-	@param sum_prob sum of the probabilities
 	@param sum_fitnesses sum of the fitnesses
-	@param seed random seed
-	@param index first_index of worst_members
 */
 
-void mutation(tsp_instance* tsp_in, int** members, double* fitnesses, int* best_index, int* worst_members, double* sum_prob, double* sum_fitnesses, int seed, int* index);
+void commit_offspring(population* pop, int* best_index, double* sum_fitnesses);
 
 /**
-	@brief Update the array with the worst members of the population.
-	@param fitnesses cost of the solution of each member of the population
-	@param worst_members array with the indices of members with maximum cost
+	@brief Compute the evolution of an island of the island model, with migration of its best member
+	to the next island of the ring every migration_interval generations (MULTITHREADING).
+	@param param island of the thread
+*/
+
+void island_evolution(void* param);
+
+/**
+	@brief Insert a migrant in an island, in place of its worst member (only if the migrant is better).
+	@param isl reference to the island
+	@param visited_nodes sequence of visited nodes of the migrant
+	@param fitness cost of the migrant
 */
 
-void update_worst(double* fitnesses, int* worst_members);
+void migrate_member(island* isl, int* visited_nodes, double fitness);
 
 
 #endif
@@ -0,0 +1,83 @@
+/**
+	@file incumbent.c
+	@author Cristina Fabris
+	@author Raffaele Di Nardo Di Maio
+	@brief Incumbent solution shared by the threads, published without locks.
+*/
+
+#include "incumbent.h"
+
+void incumbent_init(incumbent* inc, int num_nodes)
+{
+	inc->num_nodes = num_nodes;
+	inc->tours[0] = (int*)calloc((size_t)num_nodes, sizeof(int));
+	inc->tours[1] = (int*)calloc((size_t)num_nodes, sizeof(int));
+	inc->costs[0] = DBL_MAX;
+	inc->costs[1] = DBL_MAX;
+	inc->version = 0;
+	inc->writing = 0;
+}
+
+void incumbent_free(incumbent* inc)
+{
+	free(inc->tours[0]);
+	free(inc->tours[1]);
+}
+
+double incumbent_cost(incumbent* inc)
+{
+	int version;
+	double cost;
+
+	//a buffer is rewritten only two publications after it is read, so an unchanged version means a consistent cost
+	do
+	{
+		version = ATOMIC_LOAD(&(inc->version));
+		cost = inc->costs[version % 2];
+	} while (ATOMIC_LOAD(&(inc->version)) != version);
+
+	return cost;
+}
+
+int incumbent_publish(incumbent* inc, int* visited_nodes, double cost)
+{
+	if (cost >= incumbent_cost(inc))
+		return 0;
+
+	//only one writer at a time: improvements are rare, so the other writers spin for the time of a copy
+	while (!ATOMIC_CAS(&(inc->writing), 0, 1));
+
+	//the version cannot change while this thread is the writer
+	int version = inc->version;
+	int published = 0;
+
+	if (cost < inc->costs[version % 2])
+	{
+		int next = (version + 1) % 2;
+
+		memcpy(inc->tours[next], visited_nodes, (size_t)inc->num_nodes * sizeof(int));
+		inc->costs[next] = cost;
+
+		ATOMIC_STORE(&(inc->version), version + 1);
+		published = 1;
+	}
+
+	ATOMIC_STORE(&(inc->writing), 0);
+
+	return published;
+}
+
+double incumbent_load(incumbent* inc, int* visited_nodes)
+{
+	int version;
+	double cost;
+
+	do
+	{
+		version = ATOMIC_LOAD(&(inc->version));
+		memcpy(visited_nodes, inc->tours[version % 2], (size_t)inc->num_nodes * sizeof(int));
+		cost = inc->costs[version % 2];
+	} while (ATOMIC_LOAD(&(inc->version)) != version);
+
+	return cost;
+}
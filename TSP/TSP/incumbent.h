@@ -0,0 +1,64 @@
+/**
+	@file incumbent.h
+	@author Cristina Fabris
+	@author Raffaele Di Nardo Di Maio
+	@brief Header of the incumbent solution shared by the threads, published without locks.
+*/
+
+#ifndef INCUMBENT
+#define INCUMBENT
+
+#include <float.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "atomics.h"
+
+typedef struct
+{
+	int num_nodes; //number of nodes of each tour
+	int* tours[2]; //double buffer: the published tour and the one written by the next improvement
+	double costs[2]; //cost of the tour of each buffer
+	int version; //number of publications (atomic); the published buffer is version % 2
+	int writing; //1 while a thread writes the unpublished buffer (atomic)
+} incumbent;
+
+/**
+	@brief Allocate an empty incumbent (cost DBL_MAX).
+	@param inc reference to the incumbent
+	@param num_nodes number of nodes of the tours
+*/
+void incumbent_init(incumbent* inc, int num_nodes);
+
+/**
+	@brief Free the buffers of the incumbent.
+	@param inc reference to the incumbent
+*/
+void incumbent_free(incumbent* inc);
+
+/**
+	@brief Cost of the published tour, read without locks.
+	@param inc reference to the incumbent
+	@return cost of the incumbent (DBL_MAX if no tour is published)
+*/
+double incumbent_cost(incumbent* inc);
+
+/**
+	@brief Publish a tour if it strictly improves the incumbent. The tour is copied in the unpublished buffer,
+	that becomes the published one by incrementing the version (the previous tour is kept as the next buffer).
+	@param inc reference to the incumbent
+	@param visited_nodes sequence of visited nodes
+	@param cost cost of the tour
+	@return 1 if the tour is published, 0 otherwise
+*/
+int incumbent_publish(incumbent* inc, int* visited_nodes, double cost);
+
+/**
+	@brief Copy the published tour.
+	@param inc reference to the incumbent
+	@param visited_nodes on return, sequence of visited nodes of the incumbent
+	@return cost of the incumbent
+*/
+double incumbent_load(incumbent* inc, int* visited_nodes);
+
+#endif
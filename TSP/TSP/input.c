@@ -24,6 +24,11 @@ void parse_cmd(char** argv, int argc, tsp_instance* tsp_in)
 	tsp_in->verbose = VERBOSE;
 	tsp_in->size = -1;
 	tsp_in->heuristic = 0;
+	tsp_in->num_threads = NUM_THREADS;
+	tsp_in->population_size = POPULATION_SIZE;
+	tsp_in->migration_interval = 0;
+	tsp_in->seed = RUN_SEED;
+	tsp_in->progress = PROGRESS_FORMAT;
 
 	int def_deadline = 0;
 
@@ -137,6 +142,67 @@ void parse_cmd(char** argv, int argc, tsp_instance* tsp_in)
 			continue;
 		}
 
+		if (strncmp(argv[i], "-threads", 8) == 0)
+		{
+			double threadsF = atof(argv[++i]);
+			int n_threads = (int)threadsF;
+
+			//the value inserted by the user must be an integer (n_threads!=0 && threadsF==n_threads)
+			//but also the value must be greater than zero
+			assert(n_threads > 0 && threadsF == n_threads);
+
+			tsp_in->num_threads = n_threads;
+			continue;
+		}
+
+		if (strncmp(argv[i], "-pop", 4) == 0)
+		{
+			double popF = atof(argv[++i]);
+			int n_pop = (int)popF;
+
+			//the value inserted by the user must be an integer
+			//and the population must contain at least four members (each generation replaces half of them at most)
+			assert(n_pop > 3 && popF == n_pop);
+
+			tsp_in->population_size = n_pop;
+			continue;
+		}
+
+		if (strncmp(argv[i], "-migration", 10) == 0)
+		{
+			double intervalF = atof(argv[++i]);
+			int interval = (int)intervalF;
+
+			//the value inserted by the user must be a non negative integer
+			assert(interval >= 0 && intervalF == interval);
+
+			tsp_in->migration_interval = interval;
+			continue;
+		}
+
+		if (strncmp(argv[i], "-seed", 5) == 0)
+		{
+			double seedF = atof(argv[++i]);
+			int seed = (int)seedF;
+
+			//the value inserted by the user must be a non negative integer
+			assert(seed >= 0 && seedF == seed);
+
+			tsp_in->seed = seed;
+			continue;
+		}
+
+		if (strncmp(argv[i], "-progress", 9) == 0)
+		{
+			i++;
+
+			//the format must be text or csv
+			assert(strncmp(argv[i], "text", 4) == 0 || strncmp(argv[i], "csv", 3) == 0);
+
+			tsp_in->progress = (strncmp(argv[i], "csv", 3) == 0) ? PROGRESS_CSV : PROGRESS_TEXT;
+			continue;
+		}
+
 		if ((strncmp(argv[i], "-help", 5) == 0 || strncmp(argv[i], "-h", 2) == 0))
 		{
 			//print set of commands and exit from the program
@@ -174,11 +240,13 @@ void parse_cmd(char** argv, int argc, tsp_instance* tsp_in)
 			printf("Not valid algorithm for heuristic option\n");
 			exit(1);
 		}
-		else if (tsp_in->which_alg[0] == 1 || tsp_in->which_alg[3] == 1 || tsp_in->which_alg[4] == 1 ||
-			tsp_in->which_alg[5] == 1 || tsp_in->which_alg[6] == 1 || tsp_in->which_alg[7] == 1 ||
-			tsp_in->which_alg[8] == 1 || tsp_in->which_alg[9] == 1 || tsp_in->which_alg[10] == 1 )
+		else
 		{
-			printf("The heuristic option will be ignored for algorithms different from 2 and 3\n");
+			int k = 0;
+			for (; k < NUM_ALGS && (k == 1 || k == 2 || tsp_in->which_alg[k] != 1); k++);
+
+			if (k < NUM_ALGS)
+				printf("The heuristic option will be ignored for algorithms different from 2 and 3\n");
 		}
 	}
 }
@@ -203,6 +271,13 @@ void help()
 	printf("9) %s \n", ALG9);
 	printf("10) %s \n", ALG10);
 	printf("11) %s \n", ALG11);
+	printf("12) %s \n", ALG12);
+	printf("13) %s \n", ALG13);
+	printf("14) %s \n", ALG14);
+	printf("15) %s \n", ALG15);
+	printf("16) %s \n", ALG16);
+	printf("17) %s \n", ALG17);
+	printf("18) %s \n", ALG18);
 	printf(STAR_LINE);
 	printf("Insert the max time of the execution\n");
 	printf("-d dead_time\n");
@@ -228,6 +303,21 @@ void help()
 	printf("Insert the max number of nodes in instances in specified dir (with -dir)\n");
 	printf("-size max_size              where max_size = max number of nodes for an instance\n");
 	printf(STAR_LINE);
+	printf("Insert the number of threads used by the parallel algorithms\n");
+	printf("-threads num_threads        where num_threads = number of threads (default %d)\n", NUM_THREADS);
+	printf(STAR_LINE);
+	printf("Insert the size of the population of the genetic algorithm\n");
+	printf("-pop size                   where size = number of members of the population (default %d)\n", POPULATION_SIZE);
+	printf(STAR_LINE);
+	printf("Use the island model in the genetic algorithm (one island for each thread, ring migration)\n");
+	printf("-migration K                where K = generations between two migrations (default 0 = single population)\n");
+	printf(STAR_LINE);
+	printf("Insert the seed of the run (the same seed and number of threads give the same random choices)\n");
+	printf("-seed seed                  where seed = non negative integer (default %d)\n", RUN_SEED);
+	printf(STAR_LINE);
+	printf("Insert the format of the progress reports of the heuristics (printed if verbose > %d)\n", PROGRESS_VERBOSE);
+	printf("-progress format            where format = text (status line) or csv (machine readable lines)\n");
+	printf(STAR_LINE);
 	printf("Set verbose information during the execution\n");
 	printf("-v\n");
 	printf("-verbose\n");
@@ -9,6 +9,7 @@
 #define INPUT
 
 #include "utility.h"
+#include "progress.h"
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
@@ -25,9 +25,11 @@ void loop_solver(CPXENVptr env, CPXLPptr lp, tsp_instance* tsp_in, int* succ, in
 
 	CPXsetintparam(env, CPX_PARAM_RANDOMSEED, tsp_in->seed);
 
-	time_t start, start_iter, end_iter, end;
-	start = clock();
-	start_iter = start;
+	deadline_timer timer;
+	timer_start(&timer, tsp_in->deadline);
+
+	double start_iter = coarse_time();
+	double end_iter;
 	cplex_build_model(tsp_in, env, lp);
 
 	int i = 0;
@@ -36,7 +38,7 @@ void loop_solver(CPXENVptr env, CPXLPptr lp, tsp_instance* tsp_in, int* succ, in
 	//double* x = calloc(sizeof(double), tsp_in->num_cols);
 
 	CPXmipopt(env, lp);
-	end_iter = clock();
+	end_iter = coarse_time();
 	CPXgetbestobjval(env, lp, &tsp_in->bestCostD);
 	assert(CPXgetmipx(env, lp, tsp_in->sol, 0, CPXgetnumcols(env, lp) - 1) == 0);
 	define_tour(tsp_in, tsp_in->sol, succ, comp, n_comps);
@@ -44,18 +46,18 @@ void loop_solver(CPXENVptr env, CPXLPptr lp, tsp_instance* tsp_in, int* succ, in
 
 	print_state(env, lp, *n_comps, start_iter, end_iter);
 
-	double remaining_time = tsp_in->deadline - ((double) (end_iter - start_iter) / CLOCKS_PER_SEC);
+	double remaining_time = time_left(&timer);
 
 	while ((*n_comps) >= 2)
 	{
 		
 		CPXsetdblparam(env, CPXPARAM_TimeLimit, remaining_time);
-		start_iter = clock();
+		start_iter = coarse_time();
 		add_sec_constraint(env, lp, tsp_in, comp, *n_comps);
 
 		CPXmipopt(env, lp);
-		end_iter = clock();
-		remaining_time = remaining_time - ((double)(end_iter - start_iter) / CLOCKS_PER_SEC);
+		end_iter = coarse_time();
+		remaining_time = time_left(&timer);
 		if (remaining_time <= 0)
 			break;
 		
@@ -81,31 +83,31 @@ void loop_solver(CPXENVptr env, CPXLPptr lp, tsp_instance* tsp_in, int* succ, in
 		CPXsetintparam(env, CPX_PARAM_INTSOLLIM, 2100000000);
 		CPXsetdblparam(env, CPX_PARAM_EPGAP, 1e-04);
 
-		start_iter = clock();
+		start_iter = coarse_time();
 		CPXmipopt(env, lp);
-		end_iter = clock();
+		end_iter = coarse_time();
 		CPXgetbestobjval(env, lp, &tsp_in->bestCostD);
 		assert(CPXgetmipx(env, lp, tsp_in->sol, 0, CPXgetnumcols(env, lp) - 1) == 0);
 		define_tour(tsp_in, tsp_in->sol, succ, comp, n_comps);
 		print_state(env, lp, *n_comps, start_iter, end_iter);
 		//plot(tsp_in, succ, comp, &n_comps);
 
-		remaining_time = remaining_time - ((double) (end_iter - start_iter) / CLOCKS_PER_SEC);
+		remaining_time = time_left(&timer);
 
 		while (*n_comps >= 2)
 		{
 			CPXsetdblparam(env, CPXPARAM_TimeLimit, remaining_time);
-			start_iter = clock();
+			start_iter = coarse_time();
 			add_sec_constraint(env, lp, tsp_in, comp, *n_comps);
 
 			CPXmipopt(env, lp);
-			end_iter = clock();
+			end_iter = coarse_time();
 			CPXgetbestobjval(env, lp, &tsp_in->bestCostD);
 			assert(CPXgetmipx(env, lp, tsp_in->sol, 0, CPXgetnumcols(env, lp) - 1) == 0);
 			define_tour(tsp_in, tsp_in->sol, succ, comp, n_comps);
 			print_state(env, lp, *n_comps, start_iter, end_iter);
 
-			remaining_time = remaining_time - ((double)(end_iter - start_iter) / CLOCKS_PER_SEC);
+			remaining_time = time_left(&timer);
 			if (remaining_time < 0)
 				break;
 			//plot(tsp_in, succ, comp, &n_comps);
@@ -198,7 +200,7 @@ void add_sec_constraint(CPXENVptr env, CPXLPptr lp, tsp_instance* tsp_in, int* c
 
 }
 
-void print_state(CPXENVptr env, CPXLPptr lp, int ncomps, time_t start, time_t end)
+void print_state(CPXENVptr env, CPXLPptr lp, int ncomps, double start, double end)
 {
 	double actual_bound, best_bound;
 	CPXgetbestobjval(env, lp, &best_bound);
@@ -206,5 +208,5 @@ void print_state(CPXENVptr env, CPXLPptr lp, int ncomps, time_t start, time_t en
 	printf("\n%sBest bound of all the remaining open nodes:%s %.2lf\n",BLUE,WHITE, best_bound);
 	printf("%sObject value of the solution in the solution pool:%s %.2lf\n",BLUE, WHITE, actual_bound);
 	printf("%sNumber of components:%s %d\n",BLUE, WHITE, ncomps);
-	printf("%sTime:%s %.2lf seconds\n\n",BLUE, WHITE, (((double)(end - start) / (double)CLOCKS_PER_SEC)));
+	printf("%sTime:%s %.2lf seconds\n\n",BLUE, WHITE, end - start);
 }
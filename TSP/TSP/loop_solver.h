@@ -36,9 +36,9 @@ void add_sec_constraint(CPXENVptr env, CPXLPptr lp, tsp_instance* tsp_in, int* c
 	@param env pointer to the ENV structure, used by CPLEX solver
 	@param lp pointer to the LP structure, used by CPLEX solver
 	@param ncomps number of components in this iteration of the loop solver
-	@param start time in which this iteration begins
-	@param end time in which this iteration ends
+	@param start wall time in which this iteration begins (seconds)
+	@param end wall time in which this iteration ends (seconds)
 */
-void print_state(CPXENVptr env, CPXLPptr lp, int ncomps, time_t start, time_t end);
+void print_state(CPXENVptr env, CPXLPptr lp, int ncomps, double start, double end);
 
 #endif
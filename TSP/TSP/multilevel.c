@@ -0,0 +1,894 @@
+/**
+	@file multilevel.c
+	@author Cristina Fabris
+	@author Raffaele Di Nardo Di Maio
+	@brief Multilevel solver for large instances (coarsening by matching of fragments, refinement of each level).
+*/
+
+#include "multilevel.h"
+
+void multilevel_solver(tsp_instance* tsp_in)
+{
+	deadline_timer timer;
+	timer_start(&timer, tsp_in->deadline);
+
+	printf("%sMultilevel solver%s\n", RED, WHITE);
+	printf("%s[Coarsening]%s Matching of fragments (at most %d fragments)\n", BLUE, WHITE, MULTILEVEL_COARSEST);
+	printf("%s[Coarsest level]%s Guided local search\n", BLUE, WHITE);
+	printf("%s[Refinement]%s 2-opt and Or-opt on the candidates of each level, POPMUSIC\n", BLUE, WHITE);
+	printf("%s%s%s", RED, LINE, WHITE);
+
+	printf("\n");
+
+	int n = tsp_in->num_nodes;
+	int k = MULTILEVEL_CANDIDATES;
+
+	multilevel_state state;
+	state.tsp_in = tsp_in;
+	state.fragment_of = (int*)calloc((size_t)n, sizeof(int));
+	state.cand = (int*)calloc((size_t)n * k, sizeof(int));
+	state.cand_cost = (double*)calloc((size_t)n * k, sizeof(double));
+	state.num_cand = (int*)calloc((size_t)n, sizeof(int));
+	state.seq = (int*)calloc((size_t)n, sizeof(int));
+	state.pos = (int*)calloc((size_t)n, sizeof(int));
+	state.rev = (int*)calloc((size_t)n, sizeof(int));
+	state.queue = (int*)calloc((size_t)n, sizeof(int));
+	state.in_queue = (int*)calloc((size_t)n, sizeof(int));
+
+	rng_state rng;
+	rng_stream(&rng, (uint64_t)tsp_in->seed, 0);
+
+	//level 0: each node is a fragment
+	int capacity = 8;
+	state.levels = (ml_level*)calloc((size_t)capacity, sizeof(ml_level));
+	state.num_levels = 1;
+
+	ml_level* level = &(state.levels[0]);
+	level->num_fragments = n;
+	level->head = (int*)calloc((size_t)n, sizeof(int));
+	level->tail = (int*)calloc((size_t)n, sizeof(int));
+	level->length = (double*)calloc((size_t)n, sizeof(double));
+
+	int i;
+	for (i = 0; i < n; i++)
+	{
+		level->head[i] = i;
+		level->tail[i] = i;
+	}
+
+	while (1)
+	{
+		level = &(state.levels[state.num_levels - 1]);
+		ml_candidates(&state, level);
+
+		if (level->num_fragments <= MULTILEVEL_COARSEST)
+			break;
+
+		if (state.num_levels == capacity)
+		{
+			capacity *= 2;
+			state.levels = (ml_level*)realloc(state.levels, (size_t)capacity * sizeof(ml_level));
+			level = &(state.levels[state.num_levels - 1]);
+		}
+
+		ml_level* coarse = &(state.levels[state.num_levels]);
+		ml_coarsen(&state, level, coarse, &rng);
+		state.num_levels++;
+
+		//the matching does not reduce the fragments anymore (few candidates of the fragments not yet matched)
+		if (coarse->num_fragments > MULTILEVEL_MIN_REDUCTION * level->num_fragments)
+		{
+			ml_candidates(&state, coarse);
+			break;
+		}
+	}
+
+	if (tsp_in->verbose > 50)
+	{
+		for (i = 0; i < state.num_levels; i++)
+			printf("%sLevel %d :%s %d fragments\n", BLUE, i, WHITE, state.levels[i].num_fragments);
+	}
+
+	level = &(state.levels[state.num_levels - 1]);
+	ml_solve_coarsest(&state, level, MULTILEVEL_COARSEST_TIME * time_left(&timer), &rng);
+
+	//the guided local search posts the costs of the midpoints, so the reports start with the refinement
+	progress_start(tsp_in, "multilevel", "Level");
+	progress_source source;
+	progress_source_init(&source);
+
+	ml_refine(&state, level, &timer);
+	progress_post(&source, 0, ml_tour_cost(&state, level), (double)(state.num_levels - 1), time_left(&timer));
+
+	int l;
+	for (l = state.num_levels - 1; l > 0; l--)
+	{
+		ml_expand(&state, &(state.levels[l]));
+		ml_candidates(&state, &(state.levels[l - 1]));
+		ml_refine(&state, &(state.levels[l - 1]), &timer);
+
+		progress_post(&source, state.num_levels - l, ml_tour_cost(&state, &(state.levels[l - 1])), (double)(l - 1), time_left(&timer));
+	}
+
+	//the fragments of level 0 are the nodes
+	int* visited_nodes = (int*)calloc((size_t)n, sizeof(int));
+	memcpy(visited_nodes, state.seq, (size_t)n * sizeof(int));
+	double best_cost = tour_cost(tsp_in, visited_nodes);
+	double levels_cost = best_cost;
+	double levels_time = timer_elapsed(&timer);
+
+	thread_pool pool;
+	pool_init(&pool, tsp_in->num_threads);
+
+	int num_rounds = 0;
+	int num_sweeps = 0;
+	if (time_left(&timer) > 0.0)
+		num_sweeps = popmusic_rounds(tsp_in, visited_nodes, &best_cost, &timer, &pool, &num_rounds);
+
+	progress_stop();
+	pool_destroy(&pool);
+
+	if (tsp_in->verbose > 50)
+	{
+		printf("%sRefinement of the levels :%s %.2lf (%.2lf seconds)\n", BLUE, WHITE, levels_cost, levels_time);
+		printf("%sPOPMUSIC rounds :%s %d  %sSweeps :%s %d\n", BLUE, WHITE, num_rounds, BLUE, WHITE, num_sweeps);
+	}
+
+	tsp_in->bestCostD = tour_cost(tsp_in, visited_nodes);
+	tsp_in->bestCostI = (int)tsp_in->bestCostD;
+
+	//as in the POPMUSIC solver, the O(n^2) edge variables (sol) are not built
+	int* succ = (int*)calloc((size_t)n, sizeof(int));
+	succ_construction(visited_nodes, succ, n);
+
+	tsp_in->execution_time = timer_elapsed(&timer);
+	tsp_in->cpu_execution_time = timer_cpu(&timer);
+	print_cost(tsp_in);
+	printf("%sExecution time:%s %.3lf seconds (CPU %.3lf seconds)\n", GREEN, WHITE, tsp_in->execution_time, tsp_in->cpu_execution_time);
+	printf("%s%s%s", RED, LINE, WHITE);
+
+	if (tsp_in->plot)
+	{
+		int* comp = (int*)calloc((size_t)n, sizeof(int));
+		int n_comps = 1;
+
+		for (i = 0; i < n; i++)
+			comp[i] = 1;
+
+		plot(tsp_in, succ, comp, &n_comps);
+		free(comp);
+	}
+
+	free(succ);
+	free(visited_nodes);
+
+	for (i = 0; i < state.num_levels; i++)
+		ml_free_level(&(state.levels[i]));
+
+	free(state.levels);
+	free(state.fragment_of);
+	free(state.cand);
+	free(state.cand_cost);
+	free(state.num_cand);
+	free(state.seq);
+	free(state.pos);
+	free(state.rev);
+	free(state.queue);
+	free(state.in_queue);
+}
+
+void ml_coarsen(multilevel_state* state, ml_level* level, ml_level* coarse, rng_state* rng)
+{
+	int m = level->num_fragments;
+	int k = MULTILEVEL_CANDIDATES;
+
+	int* mate = (int*)malloc((size_t)m * sizeof(int));
+	int* join = (int*)malloc((size_t)m * sizeof(int));
+	int* order = (int*)malloc((size_t)m * sizeof(int));
+
+	int i;
+	for (i = 0; i < m; i++)
+	{
+		mate[i] = -1;
+		order[i] = i;
+	}
+
+	//random order, so the matching does not follow the order of the input file
+	for (i = m - 1; i > 0; i--)
+	{
+		int j = rng_int(rng, i + 1);
+		int tmp = order[i];
+		order[i] = order[j];
+		order[j] = tmp;
+	}
+
+	int num_coarse = m;
+	for (i = 0; i < m; i++)
+	{
+		int f = order[i];
+		if (mate[f] >= 0)
+			continue;
+
+		//cheapest edge from an endpoint of f to an endpoint of a fragment not matched yet
+		int best_a = -1, best_c = -1;
+		double best_cost = DBL_MAX;
+
+		int side;
+		for (side = 0; side < 2; side++)
+		{
+			int a = side ? level->tail[f] : level->head[f];
+			if (side == 1 && a == level->head[f])
+				break;
+
+			int h;
+			for (h = 0; h < state->num_cand[a]; h++)
+			{
+				int c = state->cand[(size_t)a * k + h];
+				if (mate[state->fragment_of[c]] >= 0)
+					continue;
+
+				if (state->cand_cost[(size_t)a * k + h] < best_cost)
+				{
+					best_cost = state->cand_cost[(size_t)a * k + h];
+					best_a = a;
+					best_c = c;
+				}
+
+				break;
+			}
+		}
+
+		if (best_a < 0)
+			continue;
+
+		int g = state->fragment_of[best_c];
+		mate[f] = g;
+		mate[g] = f;
+		join[f] = best_a;
+		join[g] = best_c;
+		num_coarse--;
+	}
+
+	coarse->num_fragments = num_coarse;
+	coarse->head = (int*)calloc((size_t)num_coarse, sizeof(int));
+	coarse->tail = (int*)calloc((size_t)num_coarse, sizeof(int));
+	coarse->length = (double*)calloc((size_t)num_coarse, sizeof(double));
+	coarse->child[0] = (int*)calloc((size_t)num_coarse, sizeof(int));
+	coarse->child[1] = (int*)calloc((size_t)num_coarse, sizeof(int));
+	coarse->reversed[0] = (int*)calloc((size_t)num_coarse, sizeof(int));
+	coarse->reversed[1] = (int*)calloc((size_t)num_coarse, sizeof(int));
+
+	int cf = 0;
+	int f;
+	for (f = 0; f < m; f++)
+	{
+		int g = mate[f];
+
+		if (g < 0)
+		{
+			coarse->child[0][cf] = f;
+			coarse->child[1][cf] = -1;
+			coarse->head[cf] = level->head[f];
+			coarse->tail[cf] = level->tail[f];
+			coarse->length[cf] = level->length[f];
+			cf++;
+		}
+		else if (f < g)
+		{
+			//f is left from its endpoint of the fixed edge, g is entered from its endpoint
+			int a = join[f];
+			int c = join[g];
+			int rev_f = (level->tail[f] != a);
+			int rev_g = (level->head[g] != c);
+
+			coarse->child[0][cf] = f;
+			coarse->child[1][cf] = g;
+			coarse->reversed[0][cf] = rev_f;
+			coarse->reversed[1][cf] = rev_g;
+			coarse->head[cf] = rev_f ? level->tail[f] : level->head[f];
+			coarse->tail[cf] = rev_g ? level->head[g] : level->tail[g];
+			coarse->length[cf] = level->length[f] + level->length[g] + edge_cost(state->tsp_in, a, c);
+			cf++;
+		}
+	}
+
+	free(mate);
+	free(join);
+	free(order);
+}
+
+void ml_candidates(multilevel_state* state, ml_level* level)
+{
+	tsp_instance* tsp_in = state->tsp_in;
+	int m = level->num_fragments;
+	int k = MULTILEVEL_CANDIDATES;
+
+	//endpoints of the level (once for the fragments with one node)
+	int* points = (int*)malloc((size_t)2 * m * sizeof(int));
+	int num_points = 0;
+
+	int f;
+	for (f = 0; f < m; f++)
+	{
+		state->fragment_of[level->head[f]] = f;
+		state->fragment_of[level->tail[f]] = f;
+
+		points[num_points++] = level->head[f];
+		if (level->tail[f] != level->head[f])
+			points[num_points++] = level->tail[f];
+	}
+
+	double min_x = DBL_MAX, max_x = -DBL_MAX, min_y = DBL_MAX, max_y = -DBL_MAX;
+	int i;
+	for (i = 0; i < num_points; i++)
+	{
+		int a = points[i];
+		if (tsp_in->x_coords[a] < min_x) min_x = tsp_in->x_coords[a];
+		if (tsp_in->x_coords[a] > max_x) max_x = tsp_in->x_coords[a];
+		if (tsp_in->y_coords[a] < min_y) min_y = tsp_in->y_coords[a];
+		if (tsp_in->y_coords[a] > max_y) max_y = tsp_in->y_coords[a];
+	}
+
+	//square cells, about two endpoints for each cell
+	int side = (int)sqrt((double)num_points / 2.0) + 1;
+	double extent = (max_x - min_x > max_y - min_y) ? max_x - min_x : max_y - min_y;
+	double cell = (extent > 0.0) ? extent / side : 1.0;
+
+	int* cell_of = (int*)malloc((size_t)num_points * sizeof(int));
+	int* cell_start = (int*)calloc((size_t)side * side + 1, sizeof(int));
+	int* cell_points = (int*)malloc((size_t)num_points * sizeof(int));
+
+	for (i = 0; i < num_points; i++)
+	{
+		int cx = (int)((tsp_in->x_coords[points[i]] - min_x) / cell);
+		int cy = (int)((tsp_in->y_coords[points[i]] - min_y) / cell);
+		cx = (cx < side) ? cx : side - 1;
+		cy = (cy < side) ? cy : side - 1;
+
+		cell_of[i] = cy * side + cx;
+		cell_start[cell_of[i] + 1]++;
+	}
+
+	for (i = 0; i < side * side; i++)
+		cell_start[i + 1] += cell_start[i];
+
+	int* fill = (int*)calloc((size_t)side * side, sizeof(int));
+	for (i = 0; i < num_points; i++)
+		cell_points[cell_start[cell_of[i]] + fill[cell_of[i]]++] = points[i];
+
+	for (i = 0; i < num_points; i++)
+	{
+		int a = points[i];
+		int* nodes = state->cand + (size_t)a * k;
+		double* costs = state->cand_cost + (size_t)a * k;
+		int size = 0;
+
+		int cx = cell_of[i] % side;
+		int cy = cell_of[i] / side;
+
+		int ring;
+		for (ring = 0; ring < side; ring++)
+		{
+			int dy;
+			for (dy = -ring; dy <= ring; dy++)
+			{
+				int y = cy + dy;
+				if (y < 0 || y >= side)
+					continue;
+
+				//only the border of the ring (all its cells if the row is the first or the last one)
+				int step = (dy == -ring || dy == ring) ? 1 : 2 * ring;
+				int dx;
+				for (dx = -ring; dx <= ring; dx += (step > 0) ? step : 1)
+				{
+					int x = cx + dx;
+					if (x < 0 || x >= side)
+						continue;
+
+					int h;
+					for (h = cell_start[y * side + x]; h < cell_start[y * side + x + 1]; h++)
+					{
+						int c = cell_points[h];
+						if (state->fragment_of[c] == state->fragment_of[a])
+							continue;
+
+						double cost = edge_cost(tsp_in, a, c);
+						if (size == k && cost >= costs[k - 1])
+							continue;
+
+						int g = (size < k) ? size++ : k - 1;
+						for (; g > 0 && costs[g - 1] > cost; g--)
+						{
+							costs[g] = costs[g - 1];
+							nodes[g] = nodes[g - 1];
+						}
+
+						costs[g] = cost;
+						nodes[g] = c;
+					}
+				}
+			}
+
+			//the endpoints outside the rings visited are farther than ring * cell
+			if (size == k && costs[k - 1] <= ring * cell)
+				break;
+		}
+
+		state->num_cand[a] = size;
+	}
+
+	free(points);
+	free(cell_of);
+	free(cell_start);
+	free(cell_points);
+	free(fill);
+}
+
+void ml_solve_coarsest(multilevel_state* state, ml_level* level, double deadline, rng_state* rng)
+{
+	int m = level->num_fragments;
+
+	//instance of the midpoints of the fragments, with the parameters of the instance
+	//(the guided local search does not print its costs, that are not the costs of the instance)
+	tsp_instance coarse = *(state->tsp_in);
+	coarse.num_nodes = m;
+	coarse.verbose = 0;
+	coarse.x_coords = (double*)calloc((size_t)m, sizeof(double));
+	coarse.y_coords = (double*)calloc((size_t)m, sizeof(double));
+
+	int i;
+	for (i = 0; i < m; i++)
+	{
+		coarse.x_coords[i] = (state->tsp_in->x_coords[level->head[i]] + state->tsp_in->x_coords[level->tail[i]]) / 2.0;
+		coarse.y_coords[i] = (state->tsp_in->y_coords[level->head[i]] + state->tsp_in->y_coords[level->tail[i]]) / 2.0;
+		state->seq[i] = i;
+	}
+
+	//the coarsening stopped early: the construction and the candidate lists of the guided local search are O(m^2),
+	//so the fragments follow the Hilbert curve of the midpoints and the tour is left to the refinement of the level
+	if (m > MULTILEVEL_COARSEST)
+		hilbert_tour(&coarse, state->seq);
+	else if (m >= 5)
+	{
+		double cost;
+		nearest_neighborhood(&coarse, state->seq, &cost, rng, rng_int(rng, m));
+		greedy_refinement(&coarse, state->seq, &cost);
+		guided_local_search(&coarse, state->seq, &cost, deadline);
+	}
+
+	for (i = 0; i < m; i++)
+		state->pos[state->seq[i]] = i;
+
+	free(coarse.x_coords);
+	free(coarse.y_coords);
+
+	ml_orient(state, level);
+}
+
+void ml_orient(multilevel_state* state, ml_level* level)
+{
+	tsp_instance* tsp_in = state->tsp_in;
+	int m = level->num_fragments;
+	int* seq = state->seq;
+
+	//from[2 * i + r]: orientation of the fragment in position i - 1 in the best path that visits position i with orientation r
+	int* from = (int*)calloc((size_t)2 * m, sizeof(int));
+	int* best_rev = (int*)calloc((size_t)m, sizeof(int));
+	double best_total = DBL_MAX;
+
+	int first;
+	for (first = 0; first < 2 && m > 1; first++)
+	{
+		double cost[2], next[2];
+		cost[first] = 0.0;
+		cost[1 - first] = DBL_MAX;
+
+		int i;
+		for (i = 1; i < m; i++)
+		{
+			int prev = seq[i - 1];
+			int f = seq[i];
+
+			int r;
+			for (r = 0; r < 2; r++)
+			{
+				int in = r ? level->tail[f] : level->head[f];
+				next[r] = DBL_MAX;
+
+				int rp;
+				for (rp = 0; rp < 2; rp++)
+				{
+					if (cost[rp] == DBL_MAX)
+						continue;
+
+					int out = rp ? level->head[prev] : level->tail[prev];
+					double c = cost[rp] + edge_cost(tsp_in, out, in);
+
+					if (c < next[r])
+					{
+						next[r] = c;
+						from[2 * i + r] = rp;
+					}
+				}
+			}
+
+			cost[0] = next[0];
+			cost[1] = next[1];
+		}
+
+		int in_first = first ? level->tail[seq[0]] : level->head[seq[0]];
+
+		int r;
+		for (r = 0; r < 2; r++)
+		{
+			int out = r ? level->head[seq[m - 1]] : level->tail[seq[m - 1]];
+			double total = cost[r] + edge_cost(tsp_in, out, in_first);
+
+			if (total < best_total)
+			{
+				best_total = total;
+
+				int rr = r;
+				for (i = m - 1; i > 0; i--)
+				{
+					best_rev[i] = rr;
+					rr = from[2 * i + rr];
+				}
+
+				best_rev[0] = first;
+			}
+		}
+	}
+
+	int i;
+	for (i = 0; i < m; i++)
+		state->rev[seq[i]] = best_rev[i];
+
+	free(from);
+	free(best_rev);
+}
+
+void ml_expand(multilevel_state* state, ml_level* coarse)
+{
+	int m = coarse->num_fragments;
+	int* fine_seq = (int*)malloc((size_t)2 * m * sizeof(int));
+	int* fine_rev = (int*)malloc((size_t)2 * m * sizeof(int));
+	int size = 0;
+
+	//a reversed fragment visits its children in the opposite order, each one reversed
+	int i;
+	for (i = 0; i < m; i++)
+	{
+		int f = state->seq[i];
+		int r = state->rev[f];
+
+		if (coarse->child[1][f] < 0)
+		{
+			fine_seq[size] = coarse->child[0][f];
+			fine_rev[size++] = coarse->reversed[0][f] ^ r;
+		}
+		else if (!r)
+		{
+			fine_seq[size] = coarse->child[0][f];
+			fine_rev[size++] = coarse->reversed[0][f];
+			fine_seq[size] = coarse->child[1][f];
+			fine_rev[size++] = coarse->reversed[1][f];
+		}
+		else
+		{
+			fine_seq[size] = coarse->child[1][f];
+			fine_rev[size++] = coarse->reversed[1][f] ^ 1;
+			fine_seq[size] = coarse->child[0][f];
+			fine_rev[size++] = coarse->reversed[0][f] ^ 1;
+		}
+	}
+
+	for (i = 0; i < size; i++)
+	{
+		state->seq[i] = fine_seq[i];
+		state->rev[fine_seq[i]] = fine_rev[i];
+		state->pos[fine_seq[i]] = i;
+	}
+
+	free(fine_seq);
+	free(fine_rev);
+}
+
+void ml_refine(multilevel_state* state, ml_level* level, deadline_timer* timer)
+{
+	int m = level->num_fragments;
+	if (m < MULTILEVEL_MAX_OR_OPT + 3)
+		return;
+
+	int i;
+	for (i = 0; i < m; i++)
+	{
+		state->queue[i] = state->seq[i];
+		state->in_queue[i] = 1;
+	}
+
+	state->queue_head = 0;
+	state->queue_size = m;
+
+	long long num_refined = 0;
+	while (state->queue_size > 0)
+	{
+		if (++num_refined % MULTILEVEL_TIME_CHECK == 0 && time_left(timer) < 0.0)
+			break;
+
+		int f = state->queue[state->queue_head];
+		state->queue_head = (state->queue_head + 1) % m;
+		state->queue_size--;
+		state->in_queue[f] = 0;
+
+		if (ml_two_opt(state, level, f) || ml_or_opt(state, level, f))
+			ml_push(state, m, f);
+	}
+
+	//the ids of the fragments of the next level are different
+	for (i = 0; i < m; i++)
+		state->in_queue[i] = 0;
+}
+
+int ml_two_opt(multilevel_state* state, ml_level* level, int fragment)
+{
+	tsp_instance* tsp_in = state->tsp_in;
+	int m = level->num_fragments;
+	int k = MULTILEVEL_CANDIDATES;
+	int i = state->pos[fragment];
+
+	int side;
+	for (side = 0; side < 2; side++)
+	{
+		//edge (a, b) of the tour that leaves the fragment (side 0) or that enters it (side 1)
+		int neighbor = side ? state->seq[(i - 1 + m) % m] : state->seq[(i + 1) % m];
+		int a = side ? ml_in(state, level, fragment) : ml_out(state, level, fragment);
+		int b = side ? ml_out(state, level, neighbor) : ml_in(state, level, neighbor);
+		double cost_ab = edge_cost(tsp_in, a, b);
+
+		int h;
+		for (h = 0; h < state->num_cand[a]; h++)
+		{
+			double cost_ac = state->cand_cost[(size_t)a * k + h];
+			if (cost_ac >= cost_ab)
+				break;
+
+			int c = state->cand[(size_t)a * k + h];
+			int g = state->fragment_of[c];
+			int j = state->pos[g];
+
+			if (side == 0)
+			{
+				//a -> b ... c -> d becomes a -> c ... b -> d
+				if (ml_out(state, level, g) != c)
+					continue;
+
+				int next = state->seq[(j + 1) % m];
+				int d = ml_in(state, level, next);
+				double delta = cost_ac + edge_cost(tsp_in, b, d) - cost_ab - edge_cost(tsp_in, c, d);
+
+				if (delta < -EPS)
+				{
+					int length = (j - i + m) % m;
+					if (length <= m - length)
+						ml_reverse(state, m, i + 1, length);
+					else
+						ml_reverse(state, m, j + 1, m - length);
+
+					ml_push(state, m, neighbor);
+					ml_push(state, m, g);
+					ml_push(state, m, next);
+					return 1;
+				}
+			}
+			else
+			{
+				//b -> a ... d -> c becomes b -> d ... a -> c
+				if (ml_in(state, level, g) != c)
+					continue;
+
+				int prev = state->seq[(j - 1 + m) % m];
+				int d = ml_out(state, level, prev);
+				double delta = cost_ac + edge_cost(tsp_in, b, d) - cost_ab - edge_cost(tsp_in, d, c);
+
+				if (delta < -EPS)
+				{
+					int length = (j - i + m) % m;
+					if (length <= m - length)
+						ml_reverse(state, m, i, length);
+					else
+						ml_reverse(state, m, j, m - length);
+
+					ml_push(state, m, neighbor);
+					ml_push(state, m, g);
+					ml_push(state, m, prev);
+					return 1;
+				}
+			}
+		}
+	}
+
+	return 0;
+}
+
+int ml_or_opt(multilevel_state* state, ml_level* level, int fragment)
+{
+	tsp_instance* tsp_in = state->tsp_in;
+	int m = level->num_fragments;
+	int k = MULTILEVEL_CANDIDATES;
+	int i = state->pos[fragment];
+
+	//segment s ... e of the fragments in positions i...i+len-1, between p and q
+	int prev = state->seq[(i - 1 + m) % m];
+	int p = ml_out(state, level, prev);
+	int s = ml_in(state, level, fragment);
+	double cost_ps = edge_cost(tsp_in, p, s);
+
+	int len;
+	for (len = 1; len <= MULTILEVEL_MAX_OR_OPT && len <= m - 3; len++)
+	{
+		int last = state->seq[(i + len - 1) % m];
+		int next = state->seq[(i + len) % m];
+		int e = ml_out(state, level, last);
+		int q = ml_in(state, level, next);
+		double remove_gain = cost_ps + edge_cost(tsp_in, e, q) - edge_cost(tsp_in, p, q);
+
+		if (remove_gain <= EPS)
+			continue;
+
+		int side;
+		for (side = 0; side < 2; side++)
+		{
+			int x = side ? e : s;
+			if (side == 1 && e == s)
+				break;
+
+			int h;
+			for (h = 0; h < state->num_cand[x]; h++)
+			{
+				if (state->cand_cost[(size_t)x * k + h] >= remove_gain)
+					break;
+
+				int c = state->cand[(size_t)x * k + h];
+				int g = state->fragment_of[c];
+				int jg = state->pos[g];
+
+				if ((jg - i + m) % m < len)
+					continue;
+
+				//c is the first endpoint of the edge (u, v) after g (type 0) or the last one of the edge before g (type 1)
+				int type;
+				for (type = 0; type < 2; type++)
+				{
+					int j, u, v, forward;
+
+					if (type == 0)
+					{
+						if (ml_out(state, level, g) != c)
+							continue;
+
+						j = jg;
+						u = c;
+						v = ml_in(state, level, state->seq[(jg + 1) % m]);
+						forward = (x == s);
+					}
+					else
+					{
+						if (ml_in(state, level, g) != c)
+							continue;
+
+						j = (jg - 1 + m) % m;
+						u = ml_out(state, level, state->seq[j]);
+						v = c;
+						forward = (x == e);
+					}
+
+					if (j == (i - 1 + m) % m || j == (i + len - 1) % m)
+						continue;
+
+					int first = forward ? s : e;
+					int end = forward ? e : s;
+					double add = edge_cost(tsp_in, u, first) + edge_cost(tsp_in, end, v) - edge_cost(tsp_in, u, v);
+
+					if (add >= remove_gain - EPS)
+						continue;
+
+					//the segment is moved past the shorter side between it and (u, v), by three reversals
+					int gap_after = (j - (i + len - 1) + m) % m;
+					int gap_before = m - len - gap_after;
+
+					if (gap_after <= gap_before)
+					{
+						ml_reverse(state, m, i, len + gap_after);
+						ml_reverse(state, m, i, gap_after);
+						if (forward)
+							ml_reverse(state, m, i + gap_after, len);
+					}
+					else
+					{
+						int start = (j + 1) % m;
+						ml_reverse(state, m, start, gap_before + len);
+						ml_reverse(state, m, start + len, gap_before);
+						if (forward)
+							ml_reverse(state, m, start, len);
+					}
+
+					ml_push(state, m, prev);
+					ml_push(state, m, last);
+					ml_push(state, m, next);
+					ml_push(state, m, state->fragment_of[u]);
+					ml_push(state, m, state->fragment_of[v]);
+					return 1;
+				}
+			}
+		}
+	}
+
+	return 0;
+}
+
+void ml_reverse(multilevel_state* state, int m, int start, int length)
+{
+	int h;
+	for (h = 0; h < length / 2; h++)
+	{
+		int a = (start + h) % m;
+		int b = (start + length - 1 - h) % m;
+		int tmp = state->seq[a];
+		state->seq[a] = state->seq[b];
+		state->seq[b] = tmp;
+	}
+
+	for (h = 0; h < length; h++)
+	{
+		int f = state->seq[(start + h) % m];
+		state->pos[f] = (start + h) % m;
+		state->rev[f] ^= 1;
+	}
+}
+
+int ml_in(multilevel_state* state, ml_level* level, int fragment)
+{
+	return state->rev[fragment] ? level->tail[fragment] : level->head[fragment];
+}
+
+int ml_out(multilevel_state* state, ml_level* level, int fragment)
+{
+	return state->rev[fragment] ? level->head[fragment] : level->tail[fragment];
+}
+
+double ml_tour_cost(multilevel_state* state, ml_level* level)
+{
+	int m = level->num_fragments;
+	double cost = 0.0;
+
+	int i;
+	for (i = 0; i < m; i++)
+	{
+		int f = state->seq[i];
+		cost += level->length[f] + edge_cost(state->tsp_in, ml_out(state, level, f), ml_in(state, level, state->seq[(i + 1) % m]));
+	}
+
+	return cost;
+}
+
+void ml_push(multilevel_state* state, int m, int fragment)
+{
+	if (state->in_queue[fragment])
+		return;
+
+	state->queue[(state->queue_head + state->queue_size) % m] = fragment;
+	state->queue_size++;
+	state->in_queue[fragment] = 1;
+}
+
+void ml_free_level(ml_level* level)
+{
+	free(level->head);
+	free(level->tail);
+	free(level->length);
+	free(level->child[0]);
+	free(level->child[1]);
+	free(level->reversed[0]);
+	free(level->reversed[1]);
+}
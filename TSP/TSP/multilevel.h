@@ -0,0 +1,180 @@
+/**
+	@file multilevel.h
+	@author Cristina Fabris
+	@author Raffaele Di Nardo Di Maio
+	@brief Header of the multilevel solver for large instances (coarsening by matching of fragments, refinement of each level).
+*/
+
+#ifndef MULTILEVEL
+#define MULTILEVEL
+
+#include "heuristic.h"
+#include "gls.h"
+#include "popmusic.h"
+
+#define MULTILEVEL_COARSEST 1000 //The coarsening stops when the level has at most this number of fragments
+#define MULTILEVEL_MIN_REDUCTION 0.9 //The coarsening stops when a level keeps more than this fraction of the fragments
+#define MULTILEVEL_CANDIDATES 8 //Nearest endpoints of the other fragments of each endpoint of a level
+#define MULTILEVEL_COARSEST_TIME 0.3 //Fraction of the deadline given to the guided local search of the coarsest level
+#define MULTILEVEL_MAX_OR_OPT 3 //Max number of fragments moved by an Or-opt move of the refinement
+#define MULTILEVEL_TIME_CHECK 256 //Fragments refined between two checks of the deadline
+
+typedef struct
+{
+	int num_fragments; //number of fragments (paths of nodes with fixed edges) of the level
+	int* head; //first endpoint (node) of each fragment
+	int* tail; //last endpoint of each fragment (head == tail for the fragments with one node)
+	double* length; //cost of the fixed edges of each fragment
+	int* child[2]; //fragments of the finer level joined by the fragment (child[1] = -1 if the fragment is not matched)
+	int* reversed[2]; //1 if the child is visited from its tail to its head in the fragment
+} ml_level;
+
+typedef struct
+{
+	tsp_instance* tsp_in; //pointer to tsp instance
+	ml_level* levels; //levels from the nodes (level 0) to the coarsest one
+	int num_levels; //number of levels
+	int* fragment_of; //fragment of the current level of each endpoint
+	int* cand; //candidates of endpoint i in positions [i*MULTILEVEL_CANDIDATES, ...), endpoints of the other fragments sorted by cost
+	double* cand_cost; //cost of the edge between endpoint i and each of its candidates
+	int* num_cand; //number of candidates of each endpoint
+	int* seq; //tour of the fragments of the current level
+	int* pos; //position of each fragment in seq
+	int* rev; //1 if the fragment is visited from its tail to its head in the tour
+	int* queue; //circular queue of the fragments to refine
+	int* in_queue; //1 if the fragment is in the queue
+	int queue_head; //position of the first fragment of the queue
+	int queue_size; //number of fragments in the queue
+} multilevel_state;
+
+/**
+	@brief Solve large instances with the multilevel scheme: the fragments of each level are matched in pairs joined by their
+	cheapest edge (fixed in the coarser levels), the coarsest level is solved by the guided local search on the midpoints of its
+	fragments, and each level is expanded in the finer one and refined by 2-opt and Or-opt moves limited to the candidates of the level.
+	The time left after the refinement of the nodes is used by the POPMUSIC decomposition.
+	@param tsp_in reference to tsp instance structure
+*/
+void multilevel_solver(tsp_instance* tsp_in);
+
+/**
+	@brief Build the next coarser level, matching each fragment with the fragment of the nearest candidate of its endpoints.
+	@param state reference to the state of the solver, with the candidates of the current level
+	@param level reference to the current level
+	@param coarse on return, the coarser level
+	@param rng generator of the order of the matching
+*/
+void ml_coarsen(multilevel_state* state, ml_level* level, ml_level* coarse, rng_state* rng);
+
+/**
+	@brief Set the fragment of the endpoints and compute their candidates with a uniform grid over the endpoints (about two endpoints
+	for each cell), visiting the rings of cells around each endpoint until no nearer endpoint can be found: O(k) for each endpoint
+	with uniform points, instead of O(n) of the candidate lists of the other solvers.
+	@param state reference to the state of the solver
+	@param level reference to the level
+*/
+void ml_candidates(multilevel_state* state, ml_level* level);
+
+/**
+	@brief Solve the coarsest level: guided local search on the instance made of the midpoints of the endpoints of the fragments
+	(Hilbert curve of the midpoints if the level has more than MULTILEVEL_COARSEST fragments), and orientation of the fragments
+	in the tour found.
+	@param state reference to the state of the solver
+	@param level reference to the coarsest level
+	@param deadline time limit of the guided local search (seconds)
+	@param rng generator of the starting tour
+*/
+void ml_solve_coarsest(multilevel_state* state, ml_level* level, double deadline, rng_state* rng);
+
+/**
+	@brief Choose the orientation of the fragments in the order of seq that minimizes the cost of the edges between them
+	(dynamic programming on the two orientations of each fragment, with both orientations of the first one).
+	@param state reference to the state of the solver, with the order of the fragments in seq
+	@param level reference to the level
+*/
+void ml_orient(multilevel_state* state, ml_level* level);
+
+/**
+	@brief Replace the tour of the fragments of a level with the tour of their children in the finer level.
+	@param state reference to the state of the solver, with the tour of the coarse level
+	@param coarse reference to the coarse level
+*/
+void ml_expand(multilevel_state* state, ml_level* coarse);
+
+/**
+	@brief Refine the tour of the fragments of a level with 2-opt and Or-opt moves that change only the edges between fragments,
+	evaluated with the candidates of the level and driven by a queue of the fragments next to the last changes.
+	@param state reference to the state of the solver, with the tour and the candidates of the level
+	@param level reference to the level
+	@param timer deadline of the solver
+*/
+void ml_refine(multilevel_state* state, ml_level* level, deadline_timer* timer);
+
+/**
+	@brief Try the 2-opt moves that replace an edge of the tour next to an endpoint of a fragment with an edge to one of its candidates.
+	@param state reference to the state of the solver
+	@param level reference to the level
+	@param fragment fragment
+	@return 1 if a move is done, 0 otherwise
+*/
+int ml_two_opt(multilevel_state* state, ml_level* level, int fragment);
+
+/**
+	@brief Try the Or-opt moves of the segments of 1...MULTILEVEL_MAX_OR_OPT fragments that start at a fragment, next to a candidate
+	of the endpoints of the segment, in both orientations.
+	@param state reference to the state of the solver
+	@param level reference to the level
+	@param fragment first fragment of the segments
+	@return 1 if a move is done, 0 otherwise
+*/
+int ml_or_opt(multilevel_state* state, ml_level* level, int fragment);
+
+/**
+	@brief Reverse consecutive positions of the tour of the fragments, changing also their orientation.
+	@param state reference to the state of the solver
+	@param m number of fragments of the tour
+	@param start first position (mod m)
+	@param length number of positions
+*/
+void ml_reverse(multilevel_state* state, int m, int start, int length);
+
+/**
+	@brief Endpoint from which a fragment is entered in the tour.
+	@param state reference to the state of the solver
+	@param level reference to the level
+	@param fragment fragment
+	@return endpoint (node)
+*/
+int ml_in(multilevel_state* state, ml_level* level, int fragment);
+
+/**
+	@brief Endpoint from which a fragment is left in the tour.
+	@param state reference to the state of the solver
+	@param level reference to the level
+	@param fragment fragment
+	@return endpoint (node)
+*/
+int ml_out(multilevel_state* state, ml_level* level, int fragment);
+
+/**
+	@brief Cost of the tour of the nodes given by the tour of the fragments of a level.
+	@param state reference to the state of the solver
+	@param level reference to the level
+	@return cost of the tour
+*/
+double ml_tour_cost(multilevel_state* state, ml_level* level);
+
+/**
+	@brief Add a fragment to the queue of the fragments to refine, if it is not already in it.
+	@param state reference to the state of the solver
+	@param m number of fragments of the level (size of the queue)
+	@param fragment fragment
+*/
+void ml_push(multilevel_state* state, int m, int fragment);
+
+/**
+	@brief Deallocation of a level.
+	@param level reference to the level
+*/
+void ml_free_level(ml_level* level);
+
+#endif
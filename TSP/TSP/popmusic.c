@@ -0,0 +1,429 @@
+/**
+	@file popmusic.c
+	@author Cristina Fabris
+	@author Raffaele Di Nardo Di Maio
+	@brief POPMUSIC decomposition (parallel optimization of disjoint subpaths of the tour) for the large instances.
+*/
+
+#include "popmusic.h"
+
+void popmusic_solver(tsp_instance* tsp_in)
+{
+	deadline_timer timer;
+	timer_start(&timer, tsp_in->deadline);
+
+	printf("%sPOPMUSIC solver%s\n", RED, WHITE);
+	printf("%s[Construction]%s Hilbert curve\n", BLUE, WHITE);
+	printf("%s[Decomposition]%s Subpaths of %d...%d nodes\n", BLUE, WHITE, POPMUSIC_SUBPATH, POPMUSIC_MAX_SUBPATH);
+	printf("%s%s%s", RED, LINE, WHITE);
+
+	printf("\n");
+
+	int* visited_nodes = (int*)calloc((size_t)tsp_in->num_nodes, sizeof(int));
+	hilbert_tour(tsp_in, visited_nodes);
+	double best_cost = tour_cost(tsp_in, visited_nodes);
+
+	if (tsp_in->verbose > 50)
+		printf("%sHilbert curve :%s %.2lf\n", BLUE, WHITE, best_cost);
+
+	thread_pool pool;
+	pool_init(&pool, tsp_in->num_threads);
+	progress_start(tsp_in, "popmusic", "Subpath");
+
+	int num_rounds = 0;
+	int num_sweeps = popmusic_rounds(tsp_in, visited_nodes, &best_cost, &timer, &pool, &num_rounds);
+
+	progress_stop();
+	pool_destroy(&pool);
+
+	if (tsp_in->verbose > 50)
+		printf("%sRounds :%s %d  %sSweeps :%s %d\n", BLUE, WHITE, num_rounds, BLUE, WHITE, num_sweeps);
+
+	//the cost is computed again instead of summing the gains of all the subpaths
+	tsp_in->bestCostD = tour_cost(tsp_in, visited_nodes);
+	tsp_in->bestCostI = (int)tsp_in->bestCostD;
+
+	//the edge variables (sol) of the other solvers are not built, since they need O(n^2) memory
+	int* succ = (int*)calloc((size_t)tsp_in->num_nodes, sizeof(int));
+	succ_construction(visited_nodes, succ, tsp_in->num_nodes);
+
+	tsp_in->execution_time = timer_elapsed(&timer);
+	tsp_in->cpu_execution_time = timer_cpu(&timer);
+	print_cost(tsp_in);
+	printf("%sExecution time:%s %.3lf seconds (CPU %.3lf seconds)\n", GREEN, WHITE, tsp_in->execution_time, tsp_in->cpu_execution_time);
+	printf("%s%s%s", RED, LINE, WHITE);
+
+	if (tsp_in->plot)
+	{
+		int* comp = (int*)calloc((size_t)tsp_in->num_nodes, sizeof(int));
+		int n_comps = 1;
+
+		int i;
+		for (i = 0; i < tsp_in->num_nodes; i++)
+			comp[i] = 1;
+
+		plot(tsp_in, succ, comp, &n_comps);
+		free(comp);
+	}
+
+	free(succ);
+	free(visited_nodes);
+}
+
+int popmusic_rounds(tsp_instance* tsp_in, int* visited_nodes, double* best_cost, deadline_timer* timer, thread_pool* pool, int* num_rounds)
+{
+	//larger subpaths find the improvements that need more nodes, once the smaller ones are converged; the subpaths of the
+	//next round have other endpoints, so the rounds go on while they improve the tour
+	int num_sweeps = 0;
+	double round_cost;
+	*num_rounds = 0;
+
+	progress_source source;
+	progress_source_init(&source);
+
+	do
+	{
+		round_cost = *best_cost;
+		(*num_rounds)++;
+
+		int subpath;
+		for (subpath = POPMUSIC_SUBPATH; subpath <= POPMUSIC_MAX_SUBPATH && time_left(timer) > 0.0; subpath *= 2)
+			num_sweeps += popmusic(tsp_in, visited_nodes, best_cost, subpath, popmusic_local_search, timer, pool, &source);
+
+		#ifdef WINDOW_REFINEMENT
+			num_sweeps += popmusic(tsp_in, visited_nodes, best_cost, WINDOW_SIZE + 2, popmusic_exact, timer, pool, &source);
+		#endif
+	} while (*best_cost < round_cost - EPS && time_left(timer) > 0.0);
+
+	return num_sweeps;
+}
+
+int popmusic(tsp_instance* tsp_in, int* visited_nodes, double* best_cost, int subpath, subpath_optimizer optimize,
+	deadline_timer* timer, thread_pool* pool, progress_source* source)
+{
+	int n = tsp_in->num_nodes;
+
+	//a subpath of num_nodes + 1 nodes is the whole tour, with the same node as endpoints
+	if (subpath > n + 1)
+		subpath = n + 1;
+
+	if (optimize == popmusic_exact && subpath > WINDOW_SIZE + 2)
+		subpath = WINDOW_SIZE + 2;
+
+	if (subpath < 5)
+		return 0;
+
+	//the last endpoint of a subpath is the first one of the next subpath, so the interiors of a sweep are disjoint
+	int num_subpaths = n / (subpath - 1);
+	int num_workers = (pool != NULL) ? pool->num_workers : 1;
+
+	if (num_workers > num_subpaths)
+		num_workers = num_subpaths;
+
+	popmusic_worker_args* args = (popmusic_worker_args*)calloc((size_t)num_workers, sizeof(popmusic_worker_args));
+	int k = subpath - 2;
+
+	int i;
+	for (i = 0; i < num_workers; i++)
+	{
+		args[i].tsp_in = tsp_in;
+		args[i].visited_nodes = visited_nodes;
+		args[i].timer = timer;
+		args[i].optimize = optimize;
+		args[i].subpath = subpath;
+		args[i].num_subpaths = num_subpaths;
+		args[i].id = i;
+		args[i].num_workers = num_workers;
+
+		if (optimize == popmusic_exact)
+		{
+			args[i].window.tsp_in = tsp_in;
+			args[i].window.visited_nodes = visited_nodes;
+			args[i].window.table.num_nodes = k;
+			args[i].window.table.costs = (double*)malloc((size_t)(1 << k) * k * sizeof(double));
+			args[i].window.table.dist = (double*)calloc((size_t)(k * k), sizeof(double));
+			args[i].window.start = (double*)calloc((size_t)k, sizeof(double));
+			args[i].window.nodes = (int*)calloc((size_t)k, sizeof(int));
+			args[i].window.order = (int*)calloc((size_t)(k + 1), sizeof(int));
+		}
+		else
+		{
+			args[i].nodes = (int*)calloc((size_t)subpath, sizeof(int));
+			args[i].path = (int*)calloc((size_t)subpath, sizeof(int));
+			args[i].dist = (double*)calloc((size_t)subpath * subpath, sizeof(double));
+		}
+	}
+
+	//each sweep shifts the subpaths by half a subpath, so the endpoints of a sweep are inside the subpaths of the next one
+	int offset = 0;
+	int no_improvement = 0;
+	int num_sweeps = 0;
+
+	while (no_improvement < 2 && time_left(timer) > 0.0)
+	{
+		for (i = 0; i < num_workers; i++)
+		{
+			args[i].offset = offset;
+			args[i].gain = 0.0;
+
+			if (pool != NULL)
+				pool_submit(pool, popmusic_worker, (void*)&args[i]);
+			else
+				popmusic_worker((void*)&args[i]);
+		}
+
+		if (pool != NULL)
+			pool_wait(pool);
+
+		double gain = 0.0;
+		for (i = 0; i < num_workers; i++)
+			gain += args[i].gain;
+
+		(*best_cost) -= gain;
+		no_improvement = (gain > EPS) ? 0 : no_improvement + 1;
+		offset = (offset + (subpath - 1) / 2) % n;
+		num_sweeps++;
+
+		if (source != NULL)
+			progress_post(source, num_sweeps, *best_cost, (double)subpath, time_left(timer));
+	}
+
+	for (i = 0; i < num_workers; i++)
+	{
+		if (optimize == popmusic_exact)
+		{
+			free(args[i].window.table.costs);
+			free(args[i].window.table.dist);
+			free(args[i].window.start);
+			free(args[i].window.nodes);
+			free(args[i].window.order);
+		}
+		else
+		{
+			free(args[i].nodes);
+			free(args[i].path);
+			free(args[i].dist);
+		}
+	}
+
+	free(args);
+
+	return num_sweeps;
+}
+
+void popmusic_worker(void* param)
+{
+	popmusic_worker_args* args = (popmusic_worker_args*)param;
+
+	int s;
+	for (s = args->id; s < args->num_subpaths && time_left(args->timer) > 0.0; s += args->num_workers)
+		args->gain += args->optimize(args, args->offset + s * (args->subpath - 1));
+}
+
+double popmusic_local_search(popmusic_worker_args* args, int first)
+{
+	tsp_instance* tsp_in = args->tsp_in;
+	int n = tsp_in->num_nodes;
+	int r = args->subpath;
+	int* nodes = args->nodes;
+	int* path = args->path;
+	double* d = args->dist;
+
+	int i, j;
+	for (i = 0; i < r; i++)
+	{
+		nodes[i] = args->visited_nodes[(first + i) % n];
+		path[i] = i;
+	}
+
+	for (i = 0; i < r; i++)
+	{
+		d[i * r + i] = 0.0;
+
+		for (j = i + 1; j < r; j++)
+		{
+			d[i * r + j] = edge_cost(tsp_in, nodes[i], nodes[j]);
+			d[j * r + i] = d[i * r + j];
+		}
+	}
+
+	double current_cost = 0.0;
+	for (i = 0; i < r - 1; i++)
+		current_cost += d[i * r + i + 1];
+
+	int improved = 1;
+	while (improved)
+	{
+		improved = 0;
+
+		//2-opt: reversal of path[i...j], the endpoints path[0] and path[r-1] never move
+		for (i = 1; i < r - 2; i++)
+		{
+			for (j = i + 1; j < r - 1; j++)
+			{
+				int a = path[i - 1], b = path[i], c = path[j], e = path[j + 1];
+				double delta = d[a * r + c] + d[b * r + e] - d[a * r + b] - d[c * r + e];
+
+				if (delta < -EPS)
+				{
+					int h = i, t = j;
+					for (; h < t; h++, t--)
+					{
+						int tmp = path[h];
+						path[h] = path[t];
+						path[t] = tmp;
+					}
+
+					improved = 1;
+				}
+			}
+		}
+
+		//Or-opt: the segment path[i...i+len-1] is moved between path[j] and path[j+1], in any orientation
+		int len;
+		for (len = 1; len <= POPMUSIC_MAX_OR_OPT; len++)
+		{
+			for (i = 1; i + len < r; i++)
+			{
+				int p = path[i - 1], s = path[i], t = path[i + len - 1], q = path[i + len];
+				double remove_gain = d[p * r + s] + d[t * r + q] - d[p * r + q];
+
+				if (remove_gain <= EPS)
+					continue;
+
+				for (j = 0; j < r - 1; j++)
+				{
+					if (j >= i - 1 && j <= i + len - 1)
+						continue;
+
+					int u = path[j], v = path[j + 1];
+					double forward = d[u * r + s] + d[t * r + v] - d[u * r + v];
+					double backward = d[u * r + t] + d[s * r + v] - d[u * r + v];
+					int reversed = backward < forward;
+
+					if ((reversed ? backward : forward) >= remove_gain - EPS)
+						continue;
+
+					int segment[POPMUSIC_MAX_OR_OPT];
+					int h;
+					for (h = 0; h < len; h++)
+						segment[h] = path[i + h];
+
+					//the nodes between the segment and its new position are shifted by len
+					int start;
+					if (j < i)
+					{
+						for (h = i - 1; h > j; h--)
+							path[h + len] = path[h];
+
+						start = j + 1;
+					}
+					else
+					{
+						for (h = i + len; h <= j; h++)
+							path[h - len] = path[h];
+
+						start = j - len + 1;
+					}
+
+					for (h = 0; h < len; h++)
+						path[start + h] = reversed ? segment[len - 1 - h] : segment[h];
+
+					improved = 1;
+					break;
+				}
+			}
+		}
+	}
+
+	double new_cost = 0.0;
+	for (i = 0; i < r - 1; i++)
+		new_cost += d[path[i] * r + path[i + 1]];
+
+	if (new_cost > current_cost - EPS)
+		return 0.0;
+
+	for (i = 1; i < r - 1; i++)
+		args->visited_nodes[(first + i) % n] = nodes[path[i]];
+
+	return current_cost - new_cost;
+}
+
+double popmusic_exact(popmusic_worker_args* args, int first)
+{
+	return dp_window(&(args->window), first);
+}
+
+void hilbert_tour(tsp_instance* tsp_in, int* visited_nodes)
+{
+	int n = tsp_in->num_nodes;
+
+	double min_x = DBL_MAX, max_x = -DBL_MAX, min_y = DBL_MAX, max_y = -DBL_MAX;
+	int i;
+	for (i = 0; i < n; i++)
+	{
+		if (tsp_in->x_coords[i] < min_x) min_x = tsp_in->x_coords[i];
+		if (tsp_in->x_coords[i] > max_x) max_x = tsp_in->x_coords[i];
+		if (tsp_in->y_coords[i] < min_y) min_y = tsp_in->y_coords[i];
+		if (tsp_in->y_coords[i] > max_y) max_y = tsp_in->y_coords[i];
+	}
+
+	//the same scale on both axes, so the curve follows the distances
+	double side = (max_x - min_x > max_y - min_y) ? max_x - min_x : max_y - min_y;
+	double scale = (side > 0.0) ? (double)((1 << HILBERT_ORDER) - 1) / side : 0.0;
+
+	hilbert_point* points = (hilbert_point*)calloc((size_t)n, sizeof(hilbert_point));
+	for (i = 0; i < n; i++)
+	{
+		points[i].key = hilbert_key((uint32_t)((tsp_in->x_coords[i] - min_x) * scale), (uint32_t)((tsp_in->y_coords[i] - min_y) * scale));
+		points[i].node = i;
+	}
+
+	qsort(points, (size_t)n, sizeof(hilbert_point), hilbert_compare);
+
+	for (i = 0; i < n; i++)
+		visited_nodes[i] = points[i].node;
+
+	free(points);
+}
+
+uint64_t hilbert_key(uint32_t x, uint32_t y)
+{
+	uint64_t key = 0;
+	uint32_t side = (uint32_t)1 << HILBERT_ORDER;
+
+	//from the largest quadrants, rotating the coordinates as the curve in each quadrant
+	uint32_t s;
+	for (s = side / 2; s > 0; s /= 2)
+	{
+		uint32_t rx = (x & s) > 0;
+		uint32_t ry = (y & s) > 0;
+		key += (uint64_t)s * s * ((3 * rx) ^ ry);
+
+		if (ry == 0)
+		{
+			if (rx == 1)
+			{
+				x = s - 1 - (x & (s - 1));
+				y = s - 1 - (y & (s - 1));
+			}
+
+			uint32_t tmp = x;
+			x = y;
+			y = tmp;
+		}
+	}
+
+	return key;
+}
+
+int hilbert_compare(const void* a, const void* b)
+{
+	uint64_t key_a = ((const hilbert_point*)a)->key;
+	uint64_t key_b = ((const hilbert_point*)b)->key;
+
+	if (key_a != key_b)
+		return (key_a < key_b) ? -1 : 1;
+
+	return ((const hilbert_point*)a)->node - ((const hilbert_point*)b)->node;
+}
@@ -0,0 +1,137 @@
+/**
+	@file popmusic.h
+	@author Cristina Fabris
+	@author Raffaele Di Nardo Di Maio
+	@brief Header of the POPMUSIC decomposition (parallel optimization of disjoint subpaths of the tour) for the large instances.
+*/
+
+#ifndef POPMUSIC
+#define POPMUSIC
+
+#include <stdint.h>
+#include "heuristic.h"
+#include "dp_solver.h"
+
+#define POPMUSIC_SUBPATH 50 //Nodes of the subpaths of the first decomposition (the two endpoints of a subpath are fixed)
+#define POPMUSIC_MAX_SUBPATH 400 //The subpaths double after each decomposition that converges, up to this size
+#define POPMUSIC_MAX_OR_OPT 3 //Max length of the segment moved by an Or-opt move of the local search of a subpath
+#define HILBERT_ORDER 16 //Bits of each coordinate of the grid of the Hilbert curve of the starting tour
+
+typedef struct popmusic_worker_args popmusic_worker_args;
+
+/**
+	@brief Optimize the subpath of the tour that starts at a position, keeping its two endpoints.
+	@param args parameters of the worker, with its buffers
+	@param first position of the first endpoint of the subpath
+	@return decrease of the cost of the tour (0 if the subpath is not improved)
+*/
+typedef double (*subpath_optimizer)(popmusic_worker_args* args, int first);
+
+struct popmusic_worker_args
+{
+	tsp_instance* tsp_in; //pointer to tsp instance
+	int* visited_nodes; //tour (shared by the workers, the subpaths of a sweep have disjoint interiors)
+	deadline_timer* timer; //deadline of the decomposition
+	subpath_optimizer optimize; //optimizer of the subpaths
+	int subpath; //nodes of each subpath, endpoints included
+	int offset; //position of the first endpoint of the first subpath of the sweep
+	int num_subpaths; //number of subpaths of the sweep
+	int id; //index of the worker, that optimizes the subpaths id, id + num_workers, ...
+	int num_workers; //number of workers
+	int* nodes; //nodes of the current subpath, in the order of the tour
+	int* path; //order of the subpath during the local search (indices in nodes)
+	double* dist; //cost of the edge between nodes[i] and nodes[j] in position i * subpath + j
+	window_worker_args window; //table of the exact optimizer (subpaths of at most WINDOW_SIZE + 2 nodes)
+	double gain; //decrease of the cost of the tour given by the subpaths of the worker in the sweep
+};
+
+typedef struct
+{
+	uint64_t key; //position of the node along the Hilbert curve
+	int node; //node
+} hilbert_point;
+
+/**
+	@brief Solve large instances: starting tour along a Hilbert curve (O(n log n)), POPMUSIC decompositions with local search
+	on subpaths of increasing size and then with exact windows, until the deadline. The O(n^2) arrays of the other solvers
+	(edge variables, candidate lists of all the nodes) are never allocated.
+	@param tsp_in reference to tsp instance structure
+*/
+void popmusic_solver(tsp_instance* tsp_in);
+
+/**
+	@brief Refine a tour with rounds of POPMUSIC decompositions: local search on subpaths of POPMUSIC_SUBPATH...POPMUSIC_MAX_SUBPATH
+	nodes (doubling), then exact windows if WINDOW_REFINEMENT is defined, while a round improves the tour and before the deadline.
+	@param tsp_in reference to tsp instance structure
+	@param visited_nodes sequence of the visited nodes, replaced by the refined one
+	@param best_cost cost of the tour, replaced by the cost of the refined one
+	@param timer deadline of the refinement
+	@param pool thread pool of the workers (NULL to optimize the subpaths in the calling thread)
+	@param num_rounds on return, number of rounds
+	@return number of sweeps
+*/
+int popmusic_rounds(tsp_instance* tsp_in, int* visited_nodes, double* best_cost, deadline_timer* timer, thread_pool* pool, int* num_rounds);
+
+/**
+	@brief Refine a tour by optimizing subpaths of consecutive nodes with fixed endpoints, in parallel on the pool: the subpaths
+	of a sweep have disjoint interiors, and each sweep shifts them by half a subpath, until two sweeps give no improvement or the deadline.
+	Each sweep is O(n) optimizations of constant size, so the refinement scales linearly with the nodes.
+	@param tsp_in reference to tsp instance structure
+	@param visited_nodes sequence of the visited nodes, replaced by the refined one
+	@param best_cost cost of the tour, replaced by the cost of the refined one
+	@param subpath nodes of each subpath, endpoints included (at most num_nodes + 1)
+	@param optimize optimizer of the subpaths (popmusic_local_search, or popmusic_exact with at most WINDOW_SIZE + 2 nodes)
+	@param timer deadline of the refinement
+	@param pool thread pool of the workers (NULL to optimize the subpaths in the calling thread)
+	@param source progress source of the sweeps (NULL if the cost of the tour is not reported)
+	@return number of sweeps
+*/
+int popmusic(tsp_instance* tsp_in, int* visited_nodes, double* best_cost, int subpath, subpath_optimizer optimize,
+	deadline_timer* timer, thread_pool* pool, progress_source* source);
+
+/**
+	@brief Optimize the subpaths of a sweep assigned to a worker (job of the thread pool).
+	@param param parameters of the worker (popmusic_worker_args)
+*/
+void popmusic_worker(void* param);
+
+/**
+	@brief Optimizer of the subpaths: 2-opt and Or-opt moves inside the subpath, with first improvement, until a local optimum.
+	@param args parameters of the worker, with its buffers
+	@param first position of the first endpoint of the subpath
+	@return decrease of the cost of the tour
+*/
+double popmusic_local_search(popmusic_worker_args* args, int first);
+
+/**
+	@brief Optimizer of the subpaths: exact Held-Karp dynamic programming on the nodes between the endpoints (dp_window).
+	@param args parameters of the worker, with its table
+	@param first position of the first endpoint of the subpath
+	@return decrease of the cost of the tour
+*/
+double popmusic_exact(popmusic_worker_args* args, int first);
+
+/**
+	@brief Build the tour that visits the nodes in the order of a Hilbert curve over their bounding box.
+	@param tsp_in reference to tsp instance structure
+	@param visited_nodes on return, sequence of the visited nodes
+*/
+void hilbert_tour(tsp_instance* tsp_in, int* visited_nodes);
+
+/**
+	@brief Position of a cell along the Hilbert curve of a grid of 2^HILBERT_ORDER x 2^HILBERT_ORDER cells.
+	@param x column of the cell
+	@param y row of the cell
+	@return position along the curve
+*/
+uint64_t hilbert_key(uint32_t x, uint32_t y);
+
+/**
+	@brief Comparison of two points of the Hilbert curve by position (qsort).
+	@param a first hilbert_point
+	@param b second hilbert_point
+	@return negative, zero or positive if a is before, at the same position or after b
+*/
+int hilbert_compare(const void* a, const void* b);
+
+#endif
@@ -0,0 +1,299 @@
+/**
+	@file population.c
+	@author Cristina Fabris
+	@author Raffaele Di Nardo Di Maio
+	@brief Population of the genetic algorithm, stored in a contiguous arena.
+*/
+
+#include "population.h"
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+static void* arena_alloc(size_t size)
+{
+	void* arena = NULL;
+
+	#ifdef _WIN32
+	arena = _aligned_malloc(size, ARENA_ALIGNMENT);
+	#else
+	if (posix_memalign(&arena, ARENA_ALIGNMENT, size))
+		arena = NULL;
+	#endif
+
+	if (arena == NULL)
+	{
+		printf("Allocation of the population failed (%zu bytes)\n", size);
+		exit(-1);
+	}
+
+	memset(arena, 0, size);
+	return arena;
+}
+
+static void arena_free(void* arena)
+{
+	#ifdef _WIN32
+	_aligned_free(arena);
+	#else
+	free(arena);
+	#endif
+}
+
+static void encode(population* pop, unsigned char* member, int* visited_nodes)
+{
+	int i;
+
+	if (pop->compact)
+	{
+		uint16_t* tour = (uint16_t*)member;
+		for (i = 0; i < pop->num_nodes; i++)
+			tour[i] = (uint16_t)visited_nodes[i];
+	}
+	else
+		memcpy(member, visited_nodes, (size_t)pop->num_nodes * sizeof(int));
+}
+
+static void selection_update(population* pop, int index, double delta)
+{
+	int i;
+	for (i = index + 1; i <= pop->num_members; i += i & (-i))
+		pop->selection_tree[i] += delta;
+}
+
+void population_init(population* pop, int num_members, int num_nodes, int num_slots)
+{
+	pop->num_members = num_members;
+	pop->num_nodes = num_nodes;
+	pop->compact = (num_nodes <= COMPACT_MAX_NODES);
+
+	size_t bytes = (size_t)num_nodes * (pop->compact ? sizeof(uint16_t) : sizeof(int));
+	pop->stride = ((bytes + ARENA_ALIGNMENT - 1) / ARENA_ALIGNMENT) * ARENA_ALIGNMENT;
+
+	pop->genes = (unsigned char*)arena_alloc(pop->stride * num_members);
+	pop->fitnesses = (double*)calloc((size_t)num_members, sizeof(double));
+	pop->selection_tree = (double*)calloc((size_t)num_members + 1, sizeof(double));
+	pop->order = (int*)calloc((size_t)num_members, sizeof(int));
+
+	int i;
+	for (i = 0; i < num_members; i++)
+		pop->order[i] = i;
+
+	pop->num_slots = num_slots;
+	pop->next_genes = (unsigned char*)arena_alloc(pop->stride * num_slots);
+	pop->next_fitnesses = (double*)calloc((size_t)num_slots, sizeof(double));
+	pop->next_index = (int*)calloc((size_t)num_slots, sizeof(int));
+}
+
+void population_free(population* pop)
+{
+	arena_free(pop->genes);
+	arena_free(pop->next_genes);
+	free(pop->fitnesses);
+	free(pop->selection_tree);
+	free(pop->order);
+	free(pop->next_fitnesses);
+	free(pop->next_index);
+}
+
+void population_load(population* pop, int index, int* visited_nodes)
+{
+	unsigned char* member = pop->genes + pop->stride * index;
+	int i;
+
+	if (pop->compact)
+	{
+		uint16_t* tour = (uint16_t*)member;
+		for (i = 0; i < pop->num_nodes; i++)
+			visited_nodes[i] = tour[i];
+	}
+	else
+		memcpy(visited_nodes, member, (size_t)pop->num_nodes * sizeof(int));
+}
+
+void population_store(population* pop, int index, int* visited_nodes, double fitness)
+{
+	encode(pop, pop->genes + pop->stride * index, visited_nodes);
+	pop->fitnesses[index] = fitness;
+}
+
+void population_build_selection(population* pop)
+{
+	int i;
+	for (i = 1; i <= pop->num_members; i++)
+		pop->selection_tree[i] = 1.0 / pop->fitnesses[i - 1];
+
+	//each node adds its partial sum to its parent, in O(N)
+	for (i = 1; i <= pop->num_members; i++)
+	{
+		int parent = i + (i & (-i));
+		if (parent <= pop->num_members)
+			pop->selection_tree[parent] += pop->selection_tree[i];
+	}
+}
+
+int population_select(population* pop, rng_state* rng)
+{
+	int step = 1;
+	while (step * 2 <= pop->num_members)
+		step *= 2;
+
+	double total = 0.0;
+	int i;
+	for (i = pop->num_members; i > 0; i -= i & (-i))
+		total += pop->selection_tree[i];
+
+	//descent of the tree to the first member whose prefix sum is greater than the random choice
+	double choice = rng_double(rng) * total;
+	int pos = 0;
+	for (; step > 0; step /= 2)
+	{
+		if (pos + step <= pop->num_members && pop->selection_tree[pos + step] <= choice)
+		{
+			pos += step;
+			choice -= pop->selection_tree[pos];
+		}
+	}
+
+	return (pos < pop->num_members) ? pos : pop->num_members - 1;
+}
+
+void population_worst(population* pop, int* worst_members)
+{
+	int* order = pop->order;
+	double* fitnesses = pop->fitnesses;
+	int kth = pop->num_slots - 1;
+	int left = 0;
+	int right = pop->num_members - 1;
+
+	//after the partition, order[0...kth] are the members with maximum cost
+	while (right > left)
+	{
+		double pivot = fitnesses[order[left + (right - left) / 2]];
+		int i = left;
+		int j = right;
+
+		while (i <= j)
+		{
+			while (fitnesses[order[i]] > pivot)
+				i++;
+
+			while (fitnesses[order[j]] < pivot)
+				j--;
+
+			if (i <= j)
+			{
+				int tmp = order[i];
+				order[i] = order[j];
+				order[j] = tmp;
+				i++;
+				j--;
+			}
+		}
+
+		//order[left...j] >= pivot, order[i...right] <= pivot, order[j+1...i-1] == pivot
+		if (kth <= j)
+			right = j;
+		else if (kth >= i)
+			left = i;
+		else
+			break;
+	}
+
+	memcpy(worst_members, order, (size_t)pop->num_slots * sizeof(int));
+}
+
+void population_permutation(population* pop, int* members, rng_state* rng)
+{
+	int i;
+	for (i = 0; i < pop->num_members; i++)
+		members[i] = i;
+
+	//Fisher-Yates shuffle
+	for (i = pop->num_members - 1; i > 0; i--)
+	{
+		int j = rng_int(rng, i + 1);
+		int tmp = members[i];
+		members[i] = members[j];
+		members[j] = tmp;
+	}
+}
+
+void population_replace(population* pop, int index, int* visited_nodes, double fitness)
+{
+	selection_update(pop, index, (1.0 / fitness) - (1.0 / pop->fitnesses[index]));
+	population_store(pop, index, visited_nodes, fitness);
+}
+
+void population_stage(population* pop, int slot, int index, int* visited_nodes, double fitness)
+{
+	pop->next_index[slot] = index;
+	pop->next_fitnesses[slot] = fitness;
+
+	if (index != -1)
+		encode(pop, pop->next_genes + pop->stride * slot, visited_nodes);
+}
+
+void population_commit(population* pop, int num_offspring)
+{
+	int slot;
+	for (slot = 0; slot < num_offspring; slot++)
+	{
+		int index = pop->next_index[slot];
+
+		if (index == -1)
+			continue;
+
+		memcpy(pop->genes + pop->stride * index, pop->next_genes + pop->stride * slot, pop->stride);
+		selection_update(pop, index, (1.0 / pop->next_fitnesses[slot]) - (1.0 / pop->fitnesses[index]));
+		pop->fitnesses[index] = pop->next_fitnesses[slot];
+	}
+}
+
+void migration_queue_init(migration_queue* queue, int num_nodes)
+{
+	queue->num_nodes = num_nodes;
+	queue->tours = (int*)calloc((size_t)MIGRATION_QUEUE_SIZE * num_nodes, sizeof(int));
+	queue->fitnesses = (double*)calloc((size_t)MIGRATION_QUEUE_SIZE, sizeof(double));
+	queue->head = 0;
+	queue->tail = 0;
+}
+
+void migration_queue_free(migration_queue* queue)
+{
+	free(queue->tours);
+	free(queue->fitnesses);
+}
+
+int migration_queue_push(migration_queue* queue, int* visited_nodes, double fitness)
+{
+	int tail = queue->tail;
+
+	if (tail - ATOMIC_LOAD(&(queue->head)) == MIGRATION_QUEUE_SIZE)
+		return 0;
+
+	int slot = tail % MIGRATION_QUEUE_SIZE;
+	memcpy(queue->tours + (size_t)slot * queue->num_nodes, visited_nodes, (size_t)queue->num_nodes * sizeof(int));
+	queue->fitnesses[slot] = fitness;
+
+	//the migrant is visible to the consumer only after it is completely written
+	ATOMIC_STORE(&(queue->tail), tail + 1);
+	return 1;
+}
+
+int migration_queue_pop(migration_queue* queue, int* visited_nodes, double* fitness)
+{
+	int head = queue->head;
+
+	if (head == ATOMIC_LOAD(&(queue->tail)))
+		return 0;
+
+	int slot = head % MIGRATION_QUEUE_SIZE;
+	memcpy(visited_nodes, queue->tours + (size_t)slot * queue->num_nodes, (size_t)queue->num_nodes * sizeof(int));
+	*fitness = queue->fitnesses[slot];
+
+	//the slot can be reused by the producer only after it is completely read
+	ATOMIC_STORE(&(queue->head), head + 1);
+	return 1;
+}
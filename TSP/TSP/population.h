@@ -0,0 +1,170 @@
+/**
+	@file population.h
+	@author Cristina Fabris
+	@author Raffaele Di Nardo Di Maio
+	@brief Header of the population of the genetic algorithm, stored in a contiguous arena.
+*/
+
+#ifndef POPULATION
+#define POPULATION
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "atomics.h"
+#include "rng.h"
+
+#define ARENA_ALIGNMENT 64 //Alignment (bytes) of the arena and of each member inside it
+#define COMPACT_MAX_NODES 65536 //Below this number of nodes, node ids are stored as uint16_t
+#define MIGRATION_QUEUE_SIZE 8 //Maximum number of migrants waiting in the queue of an island
+
+typedef struct
+{
+	int num_members; //size of the population
+	int num_nodes; //number of nodes of each tour
+	int compact; //1 if node ids are stored as uint16_t, 0 if stored as int
+	size_t stride; //bytes reserved to each member in the arenas (multiple of ARENA_ALIGNMENT)
+	unsigned char* genes; //tours of the current generation (num_members x stride bytes)
+	double* fitnesses; //cost of each member of the current generation
+	double* selection_tree; //Fenwick tree of 1/fitness of the members (1-based), for the roulette selection
+	int* order; //permutation of the members, partitioned with the worst members in front by population_worst
+
+	int num_slots; //number of offspring of a generation
+	unsigned char* next_genes; //tours of the offspring of the next generation (num_slots x stride bytes)
+	double* next_fitnesses; //cost of each offspring of the next generation
+	int* next_index; //member of the current generation replaced by each offspring (-1 if none)
+} population;
+
+typedef struct
+{
+	int num_nodes; //number of nodes of each tour
+	int* tours; //tours of the migrants (MIGRATION_QUEUE_SIZE x num_nodes)
+	double* fitnesses; //cost of each migrant
+	int head; //number of migrants received (written only by the consumer)
+	int tail; //number of migrants sent (written only by the producer)
+} migration_queue;
+
+/**
+	@brief Allocate the arenas of the population.
+	@param pop reference to the population
+	@param num_members size of the population
+	@param num_nodes number of nodes of each tour
+	@param num_slots maximum number of offspring of a generation
+*/
+void population_init(population* pop, int num_members, int num_nodes, int num_slots);
+
+/**
+	@brief Free the arenas of the population.
+	@param pop reference to the population
+*/
+void population_free(population* pop);
+
+/**
+	@brief Copy a member of the current generation into a sequence of visited nodes.
+	@param pop reference to the population
+	@param index index of the member
+	@param visited_nodes on return, sequence of visited nodes of the member (already allocated)
+*/
+void population_load(population* pop, int index, int* visited_nodes);
+
+/**
+	@brief Store a sequence of visited nodes as member of the current generation (construction of the population).
+	@param pop reference to the population
+	@param index index of the member
+	@param visited_nodes sequence of visited nodes
+	@param fitness cost of the sequence
+*/
+void population_store(population* pop, int index, int* visited_nodes, double fitness);
+
+/**
+	@brief Build the Fenwick tree of the roulette selection in O(N), once all the members are stored.
+	@param pop reference to the population
+*/
+void population_build_selection(population* pop);
+
+/**
+	@brief Select a member with probability proportional to 1/fitness in O(log N).
+	The selection only reads the population, so it can be done by different threads at the same time.
+	@param pop reference to the population
+	@param rng generator of the thread
+	@return index of the selected member
+*/
+int population_select(population* pop, rng_state* rng);
+
+/**
+	@brief Find the num_slots members with maximum cost (replaced by the next offspring) in O(N) on average,
+	partitioning the permutation of the members left by the previous call (quickselect).
+	@param pop reference to the population
+	@param worst_members on return, indices of the num_slots worst members (not sorted)
+*/
+void population_worst(population* pop, int* worst_members);
+
+/**
+	@brief Random permutation of the indices of the members.
+	@param pop reference to the population
+	@param members on return, permutation of the indices (already allocated, num_members)
+	@param rng generator of the thread
+*/
+void population_permutation(population* pop, int* members, rng_state* rng);
+
+/**
+	@brief Replace a member of the current generation, updating the roulette selection in O(log N).
+	@param pop reference to the population
+	@param index index of the member
+	@param visited_nodes sequence of visited nodes
+	@param fitness cost of the sequence
+*/
+void population_replace(population* pop, int index, int* visited_nodes, double fitness);
+
+/**
+	@brief Write an offspring in the next generation; the current generation is unchanged until population_commit.
+	Different threads can write different slots at the same time.
+	@param pop reference to the population
+	@param slot slot of the offspring in the next generation (0 <= slot < num_slots)
+	@param index index of the member of the current generation replaced by the offspring (-1 if the slot is empty)
+	@param visited_nodes sequence of visited nodes of the offspring
+	@param fitness cost of the offspring
+*/
+void population_stage(population* pop, int slot, int index, int* visited_nodes, double fitness);
+
+/**
+	@brief Move the offspring of the next generation into the current generation, in order of slot,
+	updating the roulette selection in O(log N) for each offspring.
+	@param pop reference to the population
+	@param num_offspring number of offspring written in the first slots of the next generation
+*/
+void population_commit(population* pop, int num_offspring);
+
+/**
+	@brief Allocate a lock-free queue of migrants, with a single producer and a single consumer.
+	@param queue reference to the queue
+	@param num_nodes number of nodes of each tour
+*/
+void migration_queue_init(migration_queue* queue, int num_nodes);
+
+/**
+	@brief Free the queue of migrants.
+	@param queue reference to the queue
+*/
+void migration_queue_free(migration_queue* queue);
+
+/**
+	@brief Send a migrant (called only by the producer); the migrant is discarded if the queue is full.
+	@param queue reference to the queue
+	@param visited_nodes sequence of visited nodes of the migrant
+	@param fitness cost of the migrant
+	@return 1 if the migrant is sent, 0 if the queue is full
+*/
+int migration_queue_push(migration_queue* queue, int* visited_nodes, double fitness);
+
+/**
+	@brief Receive a migrant (called only by the consumer).
+	@param queue reference to the queue
+	@param visited_nodes on return, sequence of visited nodes of the migrant (already allocated)
+	@param fitness on return, cost of the migrant
+	@return 1 if a migrant is received, 0 if the queue is empty
+*/
+int migration_queue_pop(migration_queue* queue, int* visited_nodes, double* fitness);
+
+#endif
@@ -0,0 +1,295 @@
+/**
+	@file progress.c
+	@author Cristina Fabris
+	@author Raffaele Di Nardo Di Maio
+	@brief Progress reports of the heuristics, printed by a single reporter thread instead of the solvers.
+*/
+
+#include "progress.h"
+
+static progress_cell ring[PROGRESS_RING_SIZE];
+static int ring_head = 0; //next position written by the solvers (atomic)
+static int ring_tail = 0; //next position read by the reporter
+static int next_source = 0; //identifier of the next source (atomic)
+static int num_dropped = 0; //samples discarded since the ring was full (atomic)
+static int reporter_running = 0; //1 while the reporter takes the samples (atomic)
+
+static pthread_t reporter_thread;
+static pthread_mutex_t reporter_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t reporter_cond = PTHREAD_COND_INITIALIZER;
+static int reporter_stop = 0; //1 if the reporter has to terminate
+
+static tsp_instance* report_tsp = NULL;
+static const char* report_solver = NULL;
+static const char* report_value = NULL;
+static int last_source = -1; //source of the last sample taken by the reporter
+static pthread_mutex_t bound_mutex = PTHREAD_MUTEX_INITIALIZER;
+static double report_bound = -DBL_MAX; //best lower bound (protected by bound_mutex)
+static double posted_cost = DBL_MAX; //best cost posted by the sources, also without reporter (protected by bound_mutex)
+
+void progress_start(tsp_instance* tsp_in, const char* solver, const char* value_name)
+{
+	pthread_mutex_lock(&bound_mutex);
+	report_bound = -DBL_MAX;
+	posted_cost = DBL_MAX;
+	pthread_mutex_unlock(&bound_mutex);
+
+	if (tsp_in->verbose <= PROGRESS_VERBOSE || ATOMIC_LOAD(&reporter_running))
+		return;
+
+	report_tsp = tsp_in;
+	report_solver = solver;
+	report_value = value_name;
+	last_source = -1;
+
+	int i;
+	for (i = 0; i < PROGRESS_RING_SIZE; i++)
+		ring[i].sequence = i;
+
+	ring_head = 0;
+	ring_tail = 0;
+	next_source = 0;
+	num_dropped = 0;
+	reporter_stop = 0;
+
+	if (tsp_in->progress == PROGRESS_CSV)
+		printf("progress,solver,elapsed,source,iterations,cost,value,remaining\n");
+
+	ATOMIC_STORE(&reporter_running, 1);
+	pthread_create(&reporter_thread, NULL, progress_reporter, NULL);
+}
+
+void progress_stop(void)
+{
+	if (!ATOMIC_LOAD(&reporter_running))
+		return;
+
+	//the solvers stop posting before the reporter prints the last samples
+	ATOMIC_STORE(&reporter_running, 0);
+
+	pthread_mutex_lock(&reporter_mutex);
+	reporter_stop = 1;
+	pthread_cond_signal(&reporter_cond);
+	pthread_mutex_unlock(&reporter_mutex);
+
+	pthread_join(reporter_thread, NULL);
+}
+
+void progress_source_init(progress_source* src)
+{
+	src->id = ATOMIC_ADD(&next_source, 1);
+	src->next_post = 0.0;
+}
+
+void progress_post(progress_source* src, long long iterations, double cost, double value, double remaining)
+{
+	double now = coarse_time();
+	if (now < src->next_post)
+		return;
+
+	src->next_post = now + PROGRESS_POST_MS * 1e-3;
+
+	//the single solvers publish their tour only at the end, so the lower bound checks the gap with the posted costs
+	pthread_mutex_lock(&bound_mutex);
+	if (cost < posted_cost)
+		posted_cost = cost;
+	pthread_mutex_unlock(&bound_mutex);
+
+	if (!ATOMIC_LOAD(&reporter_running))
+		return;
+
+	//bounded multi producer ring: a cell can be written at position pos if its sequence is pos
+	int pos = ATOMIC_LOAD(&ring_head);
+	progress_cell* cell;
+
+	while (1)
+	{
+		cell = &ring[pos & (PROGRESS_RING_SIZE - 1)];
+		int diff = ATOMIC_LOAD(&(cell->sequence)) - pos;
+
+		if (diff == 0)
+		{
+			if (ATOMIC_CAS(&ring_head, pos, pos + 1))
+				break;
+
+			pos = ATOMIC_LOAD(&ring_head);
+		}
+		else if (diff < 0)
+		{
+			//the cell still contains a sample not taken by the reporter
+			ATOMIC_ADD(&num_dropped, 1);
+			return;
+		}
+		else
+			pos = ATOMIC_LOAD(&ring_head);
+	}
+
+	cell->sample.source = src->id;
+	cell->sample.iterations = iterations;
+	cell->sample.cost = cost;
+	cell->sample.value = value;
+	cell->sample.remaining = remaining;
+
+	ATOMIC_STORE(&(cell->sequence), pos + 1);
+}
+
+void progress_bound(double bound)
+{
+	pthread_mutex_lock(&bound_mutex);
+	report_bound = bound;
+	pthread_mutex_unlock(&bound_mutex);
+}
+
+double progress_cost(void)
+{
+	pthread_mutex_lock(&bound_mutex);
+	double cost = posted_cost;
+	pthread_mutex_unlock(&bound_mutex);
+
+	return cost;
+}
+
+int progress_take(progress_sample* sample)
+{
+	progress_cell* cell = &ring[ring_tail & (PROGRESS_RING_SIZE - 1)];
+
+	if (ATOMIC_LOAD(&(cell->sequence)) != ring_tail + 1)
+		return 0;
+
+	*sample = cell->sample;
+
+	//the cell can be written again after a whole turn of the ring
+	ATOMIC_STORE(&(cell->sequence), ring_tail + PROGRESS_RING_SIZE);
+	ring_tail++;
+
+	return 1;
+}
+
+void progress_print(progress_sample* last, int* updated, double elapsed)
+{
+	int i;
+
+	if (report_tsp->progress == PROGRESS_CSV)
+	{
+		for (i = 0; i < PROGRESS_MAX_SOURCES; i++)
+		{
+			if (!updated[i])
+				continue;
+
+			printf("progress,%s,%.3lf,%d,%lld,%.6lf,%.6lf,%.3lf\n", report_solver, elapsed, last[i].source,
+				last[i].iterations, last[i].cost, last[i].value, last[i].remaining);
+			updated[i] = 0;
+		}
+	}
+	else
+	{
+		//aggregate of the sources: best cost and total iterations, time and value of the last sample
+		double best_cost = DBL_MAX;
+		long long iterations = 0;
+		int any = 0;
+
+		for (i = 0; i < PROGRESS_MAX_SOURCES; i++)
+		{
+			if (last[i].source < 0)
+				continue;
+
+			if (last[i].cost < best_cost)
+				best_cost = last[i].cost;
+
+			iterations += last[i].iterations;
+			any |= updated[i];
+			updated[i] = 0;
+		}
+
+		if (!any)
+			return;
+
+		progress_sample* recent = &last[last_source % PROGRESS_MAX_SOURCES];
+
+		printf("\r%sRemaining time :%s %.2lf  ", CYAN, WHITE, (recent->remaining > 0.0) ? recent->remaining : 0.0);
+
+		if (report_tsp->integerDist)
+			printf("%sBest cost :%s %d  ", GREEN, WHITE, (int)best_cost);
+		else
+			printf("%sBest cost :%s %.2lf  ", GREEN, WHITE, best_cost);
+
+		printf("%sIterations :%s %lld  ", BLUE, WHITE, iterations);
+
+		if (report_value != NULL)
+			printf("%s%s :%s %.2lf  ", BLUE, report_value, WHITE, recent->value);
+
+		pthread_mutex_lock(&bound_mutex);
+		double bound = report_bound;
+		pthread_mutex_unlock(&bound_mutex);
+
+		if (bound > -DBL_MAX && best_cost < DBL_MAX)
+		{
+			double gap = (best_cost > bound) ? 100.0 * (best_cost - bound) / best_cost : 0.0;
+			printf("%sLower bound :%s %.2lf  %sGap :%s %.2lf%%  ", GREEN, WHITE, bound, GREEN, WHITE, gap);
+		}
+	}
+
+	fflush(stdout);
+}
+
+void* progress_reporter(void* param)
+{
+	progress_sample last[PROGRESS_MAX_SOURCES];
+	int updated[PROGRESS_MAX_SOURCES];
+	progress_sample sample;
+	double start = wall_time();
+	int printed = 0;
+	(void)param;
+
+	int i;
+	for (i = 0; i < PROGRESS_MAX_SOURCES; i++)
+	{
+		last[i].source = -1;
+		updated[i] = 0;
+	}
+
+	pthread_mutex_lock(&reporter_mutex);
+
+	while (1)
+	{
+		int stop = reporter_stop;
+
+		//only the last sample of each source is printed
+		while (progress_take(&sample))
+		{
+			last[sample.source % PROGRESS_MAX_SOURCES] = sample;
+			updated[sample.source % PROGRESS_MAX_SOURCES] = 1;
+			last_source = sample.source;
+			printed = 1;
+		}
+
+		if (last_source >= 0)
+			progress_print(last, updated, wall_time() - start);
+
+		if (stop)
+			break;
+
+		struct timespec wake;
+		timespec_get(&wake, TIME_UTC);
+		wake.tv_nsec += PROGRESS_PERIOD_MS * 1000000L;
+		if (wake.tv_nsec >= 1000000000L)
+		{
+			wake.tv_sec++;
+			wake.tv_nsec -= 1000000000L;
+		}
+
+		if (!reporter_stop)
+			pthread_cond_timedwait(&reporter_cond, &reporter_mutex, &wake);
+	}
+
+	pthread_mutex_unlock(&reporter_mutex);
+
+	//the status line is closed before the output of the solver
+	if (printed && report_tsp->progress == PROGRESS_TEXT)
+		printf("\n");
+
+	if (report_tsp->verbose > 60 && ATOMIC_LOAD(&num_dropped) > 0)
+		printf("%sProgress samples dropped :%s %d\n", BLUE, WHITE, ATOMIC_LOAD(&num_dropped));
+
+	return NULL;
+}
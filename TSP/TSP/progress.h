@@ -0,0 +1,118 @@
+/**
+	@file progress.h
+	@author Cristina Fabris
+	@author Raffaele Di Nardo Di Maio
+	@brief Header of the progress reports of the heuristics, printed by a single reporter thread instead of the solvers.
+*/
+
+#ifndef PROGRESS
+#define PROGRESS
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <float.h>
+
+#define HAVE_STRUCT_TIMESPEC
+#include <pthread.h>
+
+#include "tsp.h"
+#include "utility.h"
+#include "timer.h"
+#include "atomics.h"
+
+#define PROGRESS_RING_SIZE 1024 //Number of samples in the ring between the solvers and the reporter (power of two)
+#define PROGRESS_MAX_SOURCES 64 //Number of sources whose last sample is kept by the reporter
+#define PROGRESS_POST_MS 10 //Minimum period (milliseconds) between two samples of the same source
+#define PROGRESS_PERIOD_MS 250 //Period (milliseconds) of the reports printed by the reporter
+#define PROGRESS_VERBOSE 30 //The reports are printed only if verbose is greater than this value
+
+//formats of the reports
+#define PROGRESS_TEXT 0 //status line rewritten in place
+#define PROGRESS_CSV 1 //one comma separated line for each updated source (machine readable)
+
+typedef struct
+{
+	int source; //identifier of the source
+	long long iterations; //iterations done by the source
+	double cost; //best cost found by the source
+	double value; //value specific of the solver (temperature, average cost...)
+	double remaining; //seconds left before the deadline of the source
+} progress_sample;
+
+typedef struct
+{
+	int sequence; //position of the ring for which the cell can be written (atomic)
+	progress_sample sample;
+} progress_cell;
+
+typedef struct
+{
+	int id; //identifier of the source
+	double next_post; //coarse time before which the samples of the source are discarded
+} progress_source;
+
+/**
+	@brief Start the reporter thread of a solver, if verbose is greater than PROGRESS_VERBOSE.
+	@param tsp_in reference to tsp instance structure
+	@param solver name of the solver (first field of the machine readable reports)
+	@param value_name name of the value of the samples (NULL if the solver does not post it)
+*/
+void progress_start(tsp_instance* tsp_in, const char* solver, const char* value_name);
+
+/**
+	@brief Stop the reporter thread, after printing the samples still in the ring.
+*/
+void progress_stop(void);
+
+/**
+	@brief Initialize a source of samples (one for each thread that posts samples).
+	@param src reference to the source
+*/
+void progress_source_init(progress_source* src);
+
+/**
+	@brief Post a sample of a source, without any I/O: the sample is written in the ring at most every PROGRESS_POST_MS,
+	and it is discarded if the reporter is not running or the ring is full. Its cost is kept also without reporter (progress_cost).
+	@param src reference to the source
+	@param iterations iterations done by the source
+	@param cost best cost found by the source
+	@param value value specific of the solver
+	@param remaining seconds left before the deadline of the source
+*/
+void progress_post(progress_source* src, long long iterations, double cost, double value, double remaining);
+
+/**
+	@brief Publish the best lower bound of the cost of the tours, printed with the gap in the reports.
+	@param bound lower bound
+*/
+void progress_bound(double bound);
+
+/**
+	@brief Best cost posted by the sources since progress_start, also if the reporter is not running.
+	@return best posted cost (DBL_MAX if none)
+*/
+double progress_cost(void);
+
+/**
+	@brief Take the oldest sample of the ring (called only by the reporter).
+	@param sample reference to the sample taken
+	@return 1 if a sample is taken, 0 if the ring is empty
+*/
+int progress_take(progress_sample* sample);
+
+/**
+	@brief Print the last samples of the sources.
+	@param last last sample of each source
+	@param updated 1 for the sources with a sample not printed yet
+	@param elapsed seconds from the start of the reporter
+*/
+void progress_print(progress_sample* last, int* updated, double elapsed);
+
+/**
+	@brief Take the samples of the ring and print them every PROGRESS_PERIOD_MS until progress_stop.
+	@param param not used
+*/
+void* progress_reporter(void* param);
+
+#endif
@@ -0,0 +1,60 @@
+/**
+	@file rng.c
+	@author Cristina Fabris
+	@author Raffaele Di Nardo Di Maio
+	@brief Pseudo random number generator (xoshiro256**), with a state for each thread.
+*/
+
+#include "rng.h"
+
+void rng_seed(rng_state* rng, uint64_t seed)
+{
+	int i;
+	for (i = 0; i < 4; i++)
+	{
+		//splitmix64, so that also similar seeds give uncorrelated states
+		uint64_t z = (seed += 0x9E3779B97F4A7C15ULL);
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+		rng->s[i] = z ^ (z >> 31);
+	}
+}
+
+void rng_stream(rng_state* rng, uint64_t seed, uint64_t stream)
+{
+	//the stream is mixed with a splitmix64 step, so that consecutive ids are not consecutive seeds
+	uint64_t z = (stream + 1) * 0x9E3779B97F4A7C15ULL;
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+
+	rng_seed(rng, seed ^ z ^ (z >> 31));
+}
+
+uint64_t rng_next(rng_state* rng)
+{
+	uint64_t* s = rng->s;
+	uint64_t x = s[1] * 5;
+	uint64_t result = ((x << 7) | (x >> 57)) * 9;
+	uint64_t t = s[1] << 17;
+
+	s[2] ^= s[0];
+	s[3] ^= s[1];
+	s[1] ^= s[2];
+	s[0] ^= s[3];
+	s[2] ^= t;
+	s[3] = (s[3] << 45) | (s[3] >> 19);
+
+	return result;
+}
+
+int rng_int(rng_state* rng, int n)
+{
+	//multiply-shift of the 32 high bits, the bias is negligible for n << 2^32
+	return (int)(((rng_next(rng) >> 32) * (uint64_t)n) >> 32);
+}
+
+double rng_double(rng_state* rng)
+{
+	//53 high bits as mantissa
+	return (double)(rng_next(rng) >> 11) * (1.0 / 9007199254740992.0);
+}
@@ -0,0 +1,53 @@
+/**
+	@file rng.h
+	@author Cristina Fabris
+	@author Raffaele Di Nardo Di Maio
+	@brief Header of the pseudo random number generator (xoshiro256**), with a state for each thread.
+*/
+
+#ifndef RNG
+#define RNG
+
+#include <stdint.h>
+
+typedef struct
+{
+	uint64_t s[4]; //state of the generator
+} rng_state;
+
+/**
+	@brief Initialize the state of a generator from a seed (expanded with splitmix64).
+	@param rng reference to the state of the generator
+	@param seed seed of the generator
+*/
+void rng_seed(rng_state* rng, uint64_t seed);
+
+/**
+	@brief Initialize the state of the generator of a stream (e.g. a thread) of a run: streams with different
+	ids of the same seed are independent, and the same (seed, stream) always gives the same sequence.
+	@param rng reference to the state of the generator
+	@param seed seed of the run
+	@param stream id of the stream
+*/
+void rng_stream(rng_state* rng, uint64_t seed, uint64_t stream);
+
+/**
+	@brief Return the next 64 bits random number of the generator.
+	@param rng reference to the state of the generator
+*/
+uint64_t rng_next(rng_state* rng);
+
+/**
+	@brief Return a random integer in [0, n) in O(1), without divisions.
+	@param rng reference to the state of the generator
+	@param n upper bound (excluded), n > 0
+*/
+int rng_int(rng_state* rng, int n);
+
+/**
+	@brief Return a random double in [0, 1).
+	@param rng reference to the state of the generator
+*/
+double rng_double(rng_state* rng);
+
+#endif
@@ -0,0 +1,215 @@
+/**
+	@file threadpool.c
+	@author Cristina Fabris
+	@author Raffaele Di Nardo Di Maio
+	@brief Persistent work-stealing thread pool.
+*/
+
+#include "threadpool.h"
+
+void pool_init(thread_pool* pool, int num_workers)
+{
+	pool->num_workers = num_workers;
+	pool->threads = (pthread_t*)calloc((size_t)num_workers, sizeof(pthread_t));
+	pool->deques = (job_deque*)calloc((size_t)num_workers, sizeof(job_deque));
+	pool->num_queued = 0;
+	pool->num_pending = 0;
+	pool->next_deque = 0;
+	pool->stop = 0;
+
+	pthread_key_create(&(pool->worker_key), NULL);
+	pthread_mutex_init(&(pool->mutex), NULL);
+	pthread_cond_init(&(pool->work), NULL);
+	pthread_cond_init(&(pool->idle), NULL);
+
+	int i;
+	for (i = 0; i < num_workers; i++)
+	{
+		pool->deques[i].jobs = (pool_job*)calloc((size_t)POOL_DEQUE_CAPACITY, sizeof(pool_job));
+		pool->deques[i].capacity = POOL_DEQUE_CAPACITY;
+		pool->deques[i].head = 0;
+		pool->deques[i].size = 0;
+		pthread_mutex_init(&(pool->deques[i].mutex), NULL);
+	}
+
+	for (i = 0; i < num_workers; i++)
+	{
+		pool_worker_args* args = (pool_worker_args*)calloc(1, sizeof(pool_worker_args));
+		args->pool = pool;
+		args->id = i;
+
+		pthread_create(&(pool->threads[i]), NULL, pool_worker, (void*)args);
+	}
+}
+
+void pool_submit(thread_pool* pool, pool_task task, void* arg)
+{
+	pthread_mutex_lock(&(pool->mutex));
+
+	//own deque for a worker, round robin otherwise
+	int* worker = (int*)pthread_getspecific(pool->worker_key);
+	int id;
+	if (worker != NULL)
+		id = *worker;
+	else
+	{
+		id = pool->next_deque;
+		pool->next_deque = (pool->next_deque + 1) % pool->num_workers;
+	}
+
+	job_deque* deque = &(pool->deques[id]);
+	pthread_mutex_lock(&(deque->mutex));
+
+	if (deque->size == deque->capacity)
+	{
+		pool_job* jobs = (pool_job*)calloc((size_t)deque->capacity * 2, sizeof(pool_job));
+
+		int i;
+		for (i = 0; i < deque->size; i++)
+			jobs[i] = deque->jobs[(deque->head + i) % deque->capacity];
+
+		free(deque->jobs);
+		deque->jobs = jobs;
+		deque->capacity *= 2;
+		deque->head = 0;
+	}
+
+	deque->jobs[(deque->head + deque->size) % deque->capacity].task = task;
+	deque->jobs[(deque->head + deque->size) % deque->capacity].arg = arg;
+	deque->size++;
+
+	pthread_mutex_unlock(&(deque->mutex));
+
+	pool->num_queued++;
+	pool->num_pending++;
+	pthread_cond_signal(&(pool->work));
+
+	pthread_mutex_unlock(&(pool->mutex));
+}
+
+void pool_wait(thread_pool* pool)
+{
+	pthread_mutex_lock(&(pool->mutex));
+
+	while (pool->num_pending > 0)
+		pthread_cond_wait(&(pool->idle), &(pool->mutex));
+
+	pthread_mutex_unlock(&(pool->mutex));
+}
+
+void pool_destroy(thread_pool* pool)
+{
+	pthread_mutex_lock(&(pool->mutex));
+	pool->stop = 1;
+	pthread_cond_broadcast(&(pool->work));
+	pthread_mutex_unlock(&(pool->mutex));
+
+	int i;
+	for (i = 0; i < pool->num_workers; i++)
+	{
+		int rc = pthread_join(pool->threads[i], NULL);
+
+		if (rc)
+			exit(-1);
+	}
+
+	for (i = 0; i < pool->num_workers; i++)
+	{
+		free(pool->deques[i].jobs);
+		pthread_mutex_destroy(&(pool->deques[i].mutex));
+	}
+
+	pthread_key_delete(pool->worker_key);
+	pthread_mutex_destroy(&(pool->mutex));
+	pthread_cond_destroy(&(pool->work));
+	pthread_cond_destroy(&(pool->idle));
+	free(pool->threads);
+	free(pool->deques);
+}
+
+void* pool_worker(void* param)
+{
+	pool_worker_args* args = (pool_worker_args*)param;
+	thread_pool* pool = args->pool;
+	int id = args->id;
+
+	pthread_setspecific(pool->worker_key, (void*)&(args->id));
+
+	while (1)
+	{
+		pool_job job;
+
+		if (pool_take(pool, id, &job))
+		{
+			job.task(job.arg);
+
+			pthread_mutex_lock(&(pool->mutex));
+			pool->num_pending--;
+			if (pool->num_pending == 0)
+				pthread_cond_broadcast(&(pool->idle));
+			pthread_mutex_unlock(&(pool->mutex));
+
+			continue;
+		}
+
+		//num_queued is never lower than the number of jobs in the deques, so the worker sleeps only if they are empty
+		pthread_mutex_lock(&(pool->mutex));
+
+		while (pool->num_queued == 0 && !pool->stop)
+			pthread_cond_wait(&(pool->work), &(pool->mutex));
+
+		int stop = (pool->stop && pool->num_queued == 0);
+		pthread_mutex_unlock(&(pool->mutex));
+
+		if (stop)
+			break;
+	}
+
+	free(args);
+	return NULL;
+}
+
+int pool_take(thread_pool* pool, int id, pool_job* job)
+{
+	int found = 0;
+
+	//newest job of its own deque
+	job_deque* deque = &(pool->deques[id]);
+	pthread_mutex_lock(&(deque->mutex));
+
+	if (deque->size > 0)
+	{
+		deque->size--;
+		*job = deque->jobs[(deque->head + deque->size) % deque->capacity];
+		found = 1;
+	}
+
+	pthread_mutex_unlock(&(deque->mutex));
+
+	//oldest job of the deques of the other workers
+	int i;
+	for (i = 1; i < pool->num_workers && !found; i++)
+	{
+		deque = &(pool->deques[(id + i) % pool->num_workers]);
+		pthread_mutex_lock(&(deque->mutex));
+
+		if (deque->size > 0)
+		{
+			*job = deque->jobs[deque->head];
+			deque->head = (deque->head + 1) % deque->capacity;
+			deque->size--;
+			found = 1;
+		}
+
+		pthread_mutex_unlock(&(deque->mutex));
+	}
+
+	if (found)
+	{
+		pthread_mutex_lock(&(pool->mutex));
+		pool->num_queued--;
+		pthread_mutex_unlock(&(pool->mutex));
+	}
+
+	return found;
+}
@@ -0,0 +1,100 @@
+/**
+	@file threadpool.h
+	@author Cristina Fabris
+	@author Raffaele Di Nardo Di Maio
+	@brief Header of the persistent work-stealing thread pool.
+*/
+
+#ifndef THREADPOOL
+#define THREADPOOL
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define HAVE_STRUCT_TIMESPEC
+#include <pthread.h>
+
+#define POOL_DEQUE_CAPACITY 64 //Initial capacity of the deque of each worker
+
+typedef void (*pool_task)(void* arg); //function executed by a job of the pool
+
+typedef struct
+{
+	pool_task task; //function of the job
+	void* arg; //argument of the function
+} pool_job;
+
+typedef struct
+{
+	pool_job* jobs; //circular buffer of the jobs
+	int capacity; //size of the buffer
+	int head; //position of the oldest job (stolen by the other workers)
+	int size; //number of jobs in the deque
+	pthread_mutex_t mutex;
+} job_deque;
+
+typedef struct
+{
+	int num_workers; //number of threads of the pool
+	pthread_t* threads;
+	job_deque* deques; //one deque for each worker
+	pthread_key_t worker_key; //pointer to the index of the worker of the calling thread (NULL if it is not a worker)
+	pthread_mutex_t mutex; //protects num_queued, num_pending, next_deque and stop
+	pthread_cond_t work; //signalled when a job is submitted or the pool is stopped
+	pthread_cond_t idle; //signalled when all the submitted jobs are finished
+	int num_queued; //upper bound of the number of jobs in the deques
+	int num_pending; //jobs submitted and not yet finished
+	int next_deque; //deque of the next job submitted from outside the pool
+	int stop; //1 if the workers have to terminate
+} thread_pool;
+
+typedef struct
+{
+	thread_pool* pool; //pool of the worker
+	int id; //index of the worker
+} pool_worker_args;
+
+/**
+	@brief Create the threads of the pool, that wait for jobs until pool_destroy.
+	@param pool reference to the pool
+	@param num_workers number of threads
+*/
+void pool_init(thread_pool* pool, int num_workers);
+
+/**
+	@brief Submit a job. A job submitted by a worker goes in its own deque, otherwise the deques are used round robin.
+	@param pool reference to the pool
+	@param task function of the job
+	@param arg argument of the function
+*/
+void pool_submit(thread_pool* pool, pool_task task, void* arg);
+
+/**
+	@brief Wait until all the submitted jobs (also the ones submitted by other jobs) are finished.
+	@param pool reference to the pool
+*/
+void pool_wait(thread_pool* pool);
+
+/**
+	@brief Terminate the threads of the pool and free it (the pool must be idle).
+	@param pool reference to the pool
+*/
+void pool_destroy(thread_pool* pool);
+
+/**
+	@brief Main loop of a worker: it executes the jobs of its deque (newest first), otherwise it steals
+	the oldest job from the deques of the other workers, otherwise it waits for new jobs.
+	@param param information of the worker (pool_worker_args)
+*/
+void* pool_worker(void* param);
+
+/**
+	@brief Take a job for a worker, from its own deque or stolen from the others.
+	@param pool reference to the pool
+	@param id index of the worker
+	@param job on return, the job
+	@return 1 if a job is taken, 0 if all the deques are empty
+*/
+int pool_take(thread_pool* pool, int id, pool_job* job);
+
+#endif
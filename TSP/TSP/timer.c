@@ -0,0 +1,152 @@
+/**
+	@file timer.c
+	@author Cristina Fabris
+	@author Raffaele Di Nardo Di Maio
+	@brief Wall clock deadlines of the solvers (correct also with more threads, unlike clock()).
+*/
+
+#include "timer.h"
+
+static pthread_t clock_thread;
+static pthread_mutex_t clock_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t clock_cond = PTHREAD_COND_INITIALIZER;
+static double clock_base = 0.0; //wall time of the start of the service
+static int clock_ms = 0; //milliseconds from clock_base (atomic)
+static int clock_running = 0; //1 while the service updates clock_ms (atomic)
+static int clock_stop = 0; //1 if the service has to terminate
+static int deadlines_expired = 0; //1 if all the deadlines are expired (atomic)
+
+#ifdef _MSC_VER
+
+//declared here since the project is compiled without language extensions (/Za) and so without <windows.h>
+//(clock() of the Microsoft C library is the wall time of the process, not its CPU time)
+typedef struct
+{
+	unsigned long low; //100 ns intervals, low 32 bits
+	unsigned long high; //100 ns intervals, high 32 bits
+} process_filetime;
+
+void* __stdcall GetCurrentProcess(void);
+int __stdcall GetProcessTimes(void* process, process_filetime* creation_time, process_filetime* exit_time, process_filetime* kernel_time, process_filetime* user_time);
+
+#endif
+
+void clock_service_start(void)
+{
+	if (ATOMIC_LOAD(&clock_running))
+		return;
+
+	clock_base = wall_time();
+	clock_stop = 0;
+	ATOMIC_STORE(&clock_ms, 0);
+	ATOMIC_STORE(&clock_running, 1);
+
+	pthread_create(&clock_thread, NULL, clock_service, NULL);
+}
+
+void clock_service_stop(void)
+{
+	if (!ATOMIC_LOAD(&clock_running))
+		return;
+
+	pthread_mutex_lock(&clock_mutex);
+	clock_stop = 1;
+	pthread_cond_signal(&clock_cond);
+	pthread_mutex_unlock(&clock_mutex);
+
+	pthread_join(clock_thread, NULL);
+	ATOMIC_STORE(&clock_running, 0);
+}
+
+double wall_time(void)
+{
+	struct timespec now;
+
+	#ifdef _MSC_VER
+		//without <windows.h> (no language extensions) the only clock is the calendar time of the C11 library
+		timespec_get(&now, TIME_UTC);
+	#else
+		clock_gettime(CLOCK_MONOTONIC, &now);
+	#endif
+
+	return (double)now.tv_sec + (double)now.tv_nsec * 1e-9;
+}
+
+double coarse_time(void)
+{
+	if (!ATOMIC_LOAD(&clock_running))
+		return wall_time();
+
+	return clock_base + (double)ATOMIC_LOAD(&clock_ms) * 1e-3;
+}
+
+double cpu_time(void)
+{
+	#ifdef _MSC_VER
+		process_filetime creation_time, exit_time, kernel_time, user_time;
+		if (!GetProcessTimes(GetCurrentProcess(), &creation_time, &exit_time, &kernel_time, &user_time))
+			return 0.0;
+
+		return ((double)kernel_time.high + (double)user_time.high) * 429.4967296 + ((double)kernel_time.low + (double)user_time.low) * 1e-7;
+	#else
+		return (double)clock() / (double)CLOCKS_PER_SEC;
+	#endif
+}
+
+void timer_start(deadline_timer* timer, double budget)
+{
+	timer->start = coarse_time();
+	timer->cpu_start = cpu_time();
+	timer->budget = budget;
+}
+
+double time_left(deadline_timer* timer)
+{
+	if (ATOMIC_LOAD(&deadlines_expired))
+		return -1.0;
+
+	return timer->budget - (coarse_time() - timer->start);
+}
+
+void timers_expire(int expired)
+{
+	ATOMIC_STORE(&deadlines_expired, expired);
+}
+
+double timer_elapsed(deadline_timer* timer)
+{
+	return coarse_time() - timer->start;
+}
+
+double timer_cpu(deadline_timer* timer)
+{
+	return cpu_time() - timer->cpu_start;
+}
+
+void* clock_service(void* param)
+{
+	(void)param;
+
+	pthread_mutex_lock(&clock_mutex);
+
+	while (!clock_stop)
+	{
+		//pthread_cond_timedwait needs an absolute calendar time
+		struct timespec wake;
+		timespec_get(&wake, TIME_UTC);
+		wake.tv_nsec += TIMER_RESOLUTION_MS * 1000000L;
+		if (wake.tv_nsec >= 1000000000L)
+		{
+			wake.tv_sec++;
+			wake.tv_nsec -= 1000000000L;
+		}
+
+		pthread_cond_timedwait(&clock_cond, &clock_mutex, &wake);
+
+		ATOMIC_STORE(&clock_ms, (int)((wall_time() - clock_base) * 1e3));
+	}
+
+	pthread_mutex_unlock(&clock_mutex);
+
+	return NULL;
+}
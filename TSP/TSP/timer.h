@@ -0,0 +1,97 @@
+/**
+	@file timer.h
+	@author Cristina Fabris
+	@author Raffaele Di Nardo Di Maio
+	@brief Header of the wall clock deadlines of the solvers (correct also with more threads, unlike clock()).
+*/
+
+#ifndef TIMER
+#define TIMER
+
+#include <time.h>
+#include <stdlib.h>
+
+#define HAVE_STRUCT_TIMESPEC
+#include <pthread.h>
+
+#include "atomics.h"
+
+#define TIMER_RESOLUTION_MS 1 //Period (milliseconds) of the update of the clock read by time_left
+
+typedef struct
+{
+	double start; //wall time at the start (seconds)
+	double cpu_start; //CPU time of the process at the start (seconds)
+	double budget; //time available from the start (seconds)
+} deadline_timer;
+
+/**
+	@brief Start the thread that updates the clock read by the solvers every TIMER_RESOLUTION_MS.
+	Until it is started, the clock is read directly (a system call for each read).
+*/
+void clock_service_start(void);
+
+/**
+	@brief Stop the thread of the clock.
+*/
+void clock_service_stop(void);
+
+/**
+	@brief Read the monotonic wall clock with a system call.
+	@return seconds from an arbitrary instant
+*/
+double wall_time(void);
+
+/**
+	@brief Read the wall clock updated by the clock service (an atomic load, with resolution TIMER_RESOLUTION_MS).
+	@return seconds from an arbitrary instant
+*/
+double coarse_time(void);
+
+/**
+	@brief Read the CPU time of the process (sum of all its threads).
+	@return seconds of CPU time
+*/
+double cpu_time(void);
+
+/**
+	@brief Start a deadline.
+	@param timer reference to the timer
+	@param budget seconds available from now
+*/
+void timer_start(deadline_timer* timer, double budget);
+
+/**
+	@brief Wall time left before the deadline, cheap enough for the inner loops of the solvers.
+	@param timer reference to the timer
+	@return seconds left (negative if the deadline is expired, or if the deadlines are expired by timers_expire)
+*/
+double time_left(deadline_timer* timer);
+
+/**
+	@brief Expire all the deadlines at once (for example when the incumbent is proven optimal), or restore them.
+	@param expired 1 to expire the deadlines, 0 to restore them
+*/
+void timers_expire(int expired);
+
+/**
+	@brief Wall time elapsed from the start of the timer.
+	@param timer reference to the timer
+	@return seconds elapsed
+*/
+double timer_elapsed(deadline_timer* timer);
+
+/**
+	@brief CPU time used by the process from the start of the timer.
+	@param timer reference to the timer
+	@return seconds of CPU time
+*/
+double timer_cpu(deadline_timer* timer);
+
+/**
+	@brief Update the clock every TIMER_RESOLUTION_MS until clock_service_stop.
+	@param param not used
+*/
+void* clock_service(void* param);
+
+#endif
@@ -9,6 +9,9 @@
 #include "input.h"
 #include "cplex_solver.h"
 #include "heuristic.h"
+#include "dp_solver.h"
+#include "popmusic.h"
+#include "multilevel.h"
 #include <cplex.h>
 
 int main(int argc, char** argv)
@@ -16,6 +19,9 @@ int main(int argc, char** argv)
 	tsp_instance tsp_in;
 	
 	parse_cmd(argv, argc, &tsp_in);
+
+	//wall clock read by the deadlines of all the solvers
+	clock_service_start();
 	
 	while (tsp_in.alg < 0)
 	{
@@ -32,6 +38,13 @@ int main(int argc, char** argv)
 		printf("9) %s \n", ALG9);
 		printf("10) %s \n", ALG10);
 		printf("11) %s \n", ALG11);
+		printf("12) %s \n", ALG12);
+		printf("13) %s \n", ALG13);
+		printf("14) %s \n", ALG14);
+		printf("15) %s \n", ALG15);
+		printf("16) %s \n", ALG16);
+		printf("17) %s \n", ALG17);
+		printf("18) %s \n", ALG18);
 		printf(STAR_LINE);
 
 		char s[LINE_SIZE];
@@ -43,18 +56,28 @@ int main(int argc, char** argv)
 
 	manage_input(&tsp_in);
 
+	clock_service_stop();
+
 	return 0;
 }
 
 void solution(tsp_instance* tsp_in)
 {
 	//tsp_in->sol = (int*)calloc(((size_t)tsp_in->num_nodes) +1, sizeof(int));
-	if (tsp_in->alg < 8)
+	//the exact solution of the small instances takes less than starting CPLEX
+	//(not in the performance profile of a directory, that compares the chosen algorithms)
+	if (tsp_in->num_nodes <= DP_MAX_NODES && strncmp(tsp_in->dir, "NULL", 4) == 0)
+		dp_solver(tsp_in);
+	else if (tsp_in->alg < 8)
 		cplex_solver(tsp_in);
-	else if (tsp_in->alg < 11)
-		heuristic_solver(tsp_in);
 	else if (tsp_in->alg == 11)
 		genetic_solver(tsp_in);
+	else if (tsp_in->alg == 17)
+		popmusic_solver(tsp_in);
+	else if (tsp_in->alg == 18)
+		multilevel_solver(tsp_in);
+	else
+		heuristic_solver(tsp_in);
 }
 
 void set_params_and_solve(tsp_instance* tsp_in)
@@ -130,7 +153,7 @@ void set_params_and_solve(tsp_instance* tsp_in)
 
 void manage_input(tsp_instance* tsp_in)
 {
-	char* name_algs[] = { ALG1, ALG2, ALG3, ALG4, ALG5, ALG6, ALG7, ALG8, ALG9, ALG10, ALG11};
+	char* name_algs[] = { ALG1, ALG2, ALG3, ALG4, ALG5, ALG6, ALG7, ALG8, ALG9, ALG10, ALG11, ALG12, ALG13, ALG14, ALG15, ALG16, ALG17, ALG18};
 	FILE* perf_data = NULL;
 
 	if (strncmp(tsp_in->dir, "NULL", 4) != 0)
@@ -18,13 +18,30 @@
 #define DEADLINE_MAX 7200000
 
 //Number of algoritms implemented
-#define NUM_ALGS 11
+#define NUM_ALGS 18
 
 //#define NUM_COMMANDS 8
 
 //default value of verbose
 #define VERBOSE 40
 
+//default number of threads used by the parallel algorithms
+#define NUM_THREADS 12
+
+//default size of the population of the genetic algorithm
+#define POPULATION_SIZE 12000
+
+//default seed of the run (random generators of the heuristics and of CPLEX)
+#define RUN_SEED 500
+
+//default format of the progress reports of the heuristics (0 = status line, 1 = machine readable csv lines)
+#define PROGRESS_FORMAT 0
+
+//instances with at most DP_MAX_NODES nodes are solved to optimality by the dynamic programming instead of the chosen algorithm,
+//apart from the performance profile of a directory (0 to disable)
+//(the table has (n - 1) 2^(n - 1) costs, 80 MB with 20 nodes)
+#define DP_MAX_NODES 20
+
 /**
 @brief Call to python program that generates the file instances.txt with all the name of the instances in the directory specified as argument in the command line.
 */
@@ -42,6 +59,13 @@
 #define ALG9 "TabuSearch"
 #define ALG10 "Simulated Annealing"
 #define ALG11 "Genetic"
+#define ALG12 "Parallel TabuSearch"
+#define ALG13 "Parallel Tempering"
+#define ALG14 "Guided Local Search"
+#define ALG15 "Ant Colony"
+#define ALG16 "ALNS"
+#define ALG17 "POPMUSIC"
+#define ALG18 "Multilevel"
 
 //Creation or not of the performance profile
 #define PERF_PROF_ON 1
@@ -74,7 +98,11 @@ typedef struct
 	int node_lim;
 	int sol_lim;
 	double eps_gap;
-	int seed;
+	int seed; //seed of the run, each thread derives its own random generator from it
+	int num_threads;
+	int population_size;
+	int migration_interval; //generations between two migrations in the island model of the genetic algorithm (0 = single population)
+	int progress; //format of the progress reports of the heuristics (PROGRESS_TEXT or PROGRESS_CSV)
 	char dir[DIR_SIZE];
 	int* present_heu_sol; //1 se presente, 0 se assente
 	int** heu_sol; //continente per ogni thread il vettore di succ della sol euristica calcolata
@@ -84,7 +112,8 @@ typedef struct
 	double* sol;
 	int bestCostI;
 	double bestCostD;
-	double execution_time;
+	double execution_time; //wall time of the solver (seconds)
+	double cpu_execution_time; //CPU time of the solver, summed over its threads (seconds)
 
 } tsp_instance;
 
@@ -31,6 +31,20 @@ void dist(int node1, int node2, tsp_instance* tsp_in, void* dist)
 	*distD = sqrt(x_dist * x_dist + y_dist * y_dist);
 }
 
+double edge_cost(tsp_instance* tsp_in, int node1, int node2)
+{
+	if (tsp_in->integerDist)
+	{
+		int x;
+		dist(node1, node2, tsp_in, &x);
+		return (double)x;
+	}
+
+	double x;
+	dist(node1, node2, tsp_in, &x);
+	return x;
+}
+
 void print_cost(tsp_instance* tsp_in)
 {
 	printf("%s%s%s", RED, LINE, WHITE);
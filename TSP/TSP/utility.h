@@ -53,6 +53,14 @@
 */
 void dist(int, int, tsp_instance*, void*);
 
+/**
+	@brief Return the distance between two nodes as a double, coherent with the way of computing distances in tsp_in.
+	@param tsp_in reference to tsp instance structure
+	@param node1 index of first node
+	@param node2 index of second node
+*/
+double edge_cost(tsp_instance* tsp_in, int node1, int node2);
+
 /**
 	@brief Print value of the solution of TSP problem.
 	@param tsp_in reference to tsp instance structure